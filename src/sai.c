@@ -127,6 +127,9 @@ sai_object_type_query(
     sai_object_type_t object_type = SAI_OBJECT_TYPE_NULL;
     switch_nhop_index_type_t nhop_type = 0;
     switch_handle_type_t handle_type = SWITCH_HANDLE_TYPE_NONE;
+    if (sai_object_id >= SAI_NHOP_GROUP_ID_BASE) {
+        return SAI_OBJECT_TYPE_NEXT_HOP_GROUP;
+    }
     handle_type = switch_handle_get_type(sai_object_id);
     switch (handle_type) {
         case SWITCH_HANDLE_TYPE_PORT:
@@ -167,11 +170,13 @@ sai_object_type_query(
     return object_type;
 }
 
-sai_status_t sai_initialize() {
+sai_status_t sai_initialize(void) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
     sai_switch_initialize(&sai_api_service);
     sai_port_initialize(&sai_api_service);
-    sai_fdb_initialize(&sai_api_service);
+    // the FDB shadow resolves VLAN ids through the VLAN handle table
     sai_vlan_initialize(&sai_api_service);
+    status = sai_fdb_initialize(&sai_api_service);
     sai_lag_initialize(&sai_api_service);
     sai_router_interface_initialize(&sai_api_service);
     sai_next_hop_initialize(&sai_api_service);
@@ -182,7 +187,7 @@ sai_status_t sai_initialize() {
     sai_neighbor_initialize(&sai_api_service);
     sai_hostif_initialize(&sai_api_service);
     sai_acl_initialize(&sai_api_service);
-    return SAI_STATUS_SUCCESS;
+    return status;
 }
 
 const char* sai_profile_get_value(_In_ sai_switch_profile_id_t profile_id,
@@ -325,7 +330,7 @@ sai_api_initialize(
         switch_api_init(0, num_ports);
         start_switch_api_packet_driver();
         initialized = 1;
-        sai_initialize();
+        status = sai_initialize();
         bmi_set_packet_handler(port_mgr, packet_handler);
     }
 
@@ -337,6 +342,7 @@ sai_api_initialize(
 sai_status_t
 sai_api_uninitialize(void) {
     sai_status_t status =  SAI_STATUS_SUCCESS;
+    sai_fdb_event_uninitialize();
     return status;
 }
 
@@ -351,10 +357,10 @@ sai_status_t sai_log_set(
 
 #define MAX_LOG_BUFFER 1000
 
-char log_buf[MAX_LOG_BUFFER+1];
-
 void my_log(int level, sai_api_t api, char *fmt, ...)
 {
+    // per-call buffer, the RPC server may log from several threads
+    char log_buf[MAX_LOG_BUFFER+1];
     va_list args;
     // compare if level of each API here?
     if(level < api_log_level[api])
@@ -360,6 +360,9 @@ typedef struct {
 * Return Values:
 *    SAI_STATUS_SUCCESS on success
 *    Failure status code on error
+*
+* Note: a redirect to a next hop group is programmed with the ECMP group
+*       the group id uses when the entry is created.
 */
 sai_status_t sai_create_acl_entry(
         _Out_ sai_object_id_t *acl_entry_id,
@@ -441,7 +444,13 @@ sai_status_t sai_create_acl_entry(
             // ACTION handling
             case SAI_ACL_ENTRY_ATTR_ACTION_REDIRECT:
                 {
-                    switch_handle_t handle = (switch_handle_t)attr_list[i].value.aclfield.data.oid;
+                    // a next hop group id is resolved to its current ECMP group
+                    switch_handle_t handle = sai_next_hop_group_nhop_get(
+                        (switch_handle_t)attr_list[i].value.aclfield.data.oid);
+                    if(!handle) {
+                        tommy_list_foreach(&handle_list, free);
+                        return SAI_STATUS_INVALID_PARAMETER;
+                    }
                     /*
                     if(SAI_CPU_PORT(port_handle)) {
                         acl_action = SWITCH_ACL_ACTION_REDIRECT_TO_CPU;
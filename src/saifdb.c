@@ -15,16 +15,24 @@ limitations under the License.
 */
 
 #include <saifdb.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
 #include "saiinternal.h"
 #include "sailog.h"
 #include <switchapi/switch_l2.h>
 #include <switchapi/switch_vlan.h>
+#include <tommyds/tommyhashdyn.h>
+#include <tommyds/tommylist.h>
 
-static void sai_fdb_entry_parse(
+#define SAI_FDB_VLAN_COUNT              4096
+
+static sai_status_t sai_fdb_entry_parse(
         const sai_fdb_entry_t *fdb_entry,
         switch_api_mac_entry_t *mac_entry) {
-    switch_api_vlan_id_to_handle_get(fdb_entry->vlan_id, &mac_entry->vlan_handle);
+    memset(mac_entry, 0, sizeof(switch_api_mac_entry_t));
     memcpy(mac_entry->mac.mac_addr, fdb_entry->mac_address, 6);
+    return sai_vlan_id_to_handle(fdb_entry->vlan_id, &mac_entry->vlan_handle);
 }
 
 static void sai_fdb_entry_attribute_parse(
@@ -72,6 +80,509 @@ static void sai_fdb_entry_attribute_parse(
     }
 }
 
+/*
+* Shadow of the FDB entries programmed through SAI, keyed by (VLAN, MAC).
+* Every entry is also on a per-VLAN index and, if it has a port, on a
+* per-port index so that flushes and dumps only visit affected entries.
+* Both indexes are arrays kept sorted on (VLAN, MAC): a dump page starts
+* with a binary search for its cursor, and the entries of one VLAN form
+* a contiguous range of a port index.
+*/
+#define SAI_FDB_INDEX_MIN_SIZE          16
+
+typedef struct _sai_fdb_shadow_key_t {
+    sai_vlan_id_t vlan_id;
+    sai_mac_t mac_address;
+} sai_fdb_shadow_key_t;
+
+typedef struct _sai_fdb_shadow_entry_t sai_fdb_shadow_entry_t;
+
+typedef struct _sai_fdb_index_t {
+    sai_fdb_shadow_entry_t **entries;
+    uint32_t count;
+    uint32_t size;
+} sai_fdb_index_t;
+
+typedef struct _sai_fdb_port_entries_t {
+    tommy_node node;
+    switch_handle_t port_handle;
+    sai_fdb_index_t index;
+} sai_fdb_port_entries_t;
+
+struct _sai_fdb_shadow_entry_t {
+    tommy_node node;                    // sai_fdb_shadow
+    sai_fdb_shadow_key_t key;
+    switch_api_mac_entry_t mac_entry;
+    sai_fdb_port_entries_t *port_entries;
+};
+
+/*
+* The shadow is shared between API callers and the FDB event thread.
+*/
+static pthread_mutex_t sai_fdb_lock = PTHREAD_MUTEX_INITIALIZER;
+static tommy_hashdyn sai_fdb_shadow;
+static tommy_hashdyn sai_fdb_port_index;
+static sai_fdb_index_t sai_fdb_vlan_index[SAI_FDB_VLAN_COUNT];
+
+/*
+* Aging is done by switchapi, which sees data plane hits. Its aging
+* callback posts SAI_FDB_EVENT_AGED, which removes the entry from the
+* shadow. This is the aging time last programmed, in seconds; 0 means
+* aging is disabled.
+*/
+static uint32_t sai_fdb_aging_time = 0;
+
+static void sai_fdb_shadow_key_init(
+        sai_fdb_shadow_key_t *key,
+        const sai_fdb_entry_t *fdb_entry) {
+    // keys are hashed and compared as raw bytes, clear the padding
+    memset(key, 0, sizeof(sai_fdb_shadow_key_t));
+    key->vlan_id = fdb_entry->vlan_id;
+    memcpy(key->mac_address, fdb_entry->mac_address, sizeof(sai_mac_t));
+}
+
+static int sai_fdb_shadow_cmp(const void *arg, const void *obj) {
+    const sai_fdb_shadow_key_t *key = (const sai_fdb_shadow_key_t *) arg;
+    const sai_fdb_shadow_entry_t *entry = (const sai_fdb_shadow_entry_t *) obj;
+    return memcmp(key, &entry->key, sizeof(sai_fdb_shadow_key_t));
+}
+
+static sai_fdb_shadow_entry_t *sai_fdb_shadow_find(
+        const sai_fdb_shadow_key_t *key,
+        tommy_hash_t *hash) {
+    *hash = tommy_hash_u32(0, key, sizeof(sai_fdb_shadow_key_t));
+    return (sai_fdb_shadow_entry_t *) tommy_hashdyn_search(
+        &sai_fdb_shadow, sai_fdb_shadow_cmp, key, *hash);
+}
+
+static int sai_fdb_key_order(
+        const sai_fdb_shadow_key_t *key1,
+        const sai_fdb_shadow_key_t *key2) {
+    if (key1->vlan_id != key2->vlan_id) {
+        return (key1->vlan_id < key2->vlan_id) ? -1 : 1;
+    }
+    return memcmp(key1->mac_address, key2->mac_address, sizeof(sai_mac_t));
+}
+
+/*
+* Position of the first entry whose key sorts after key, or at or after
+* it if inclusive is set.
+*/
+static uint32_t sai_fdb_index_bound(
+        const sai_fdb_index_t *index,
+        const sai_fdb_shadow_key_t *key,
+        bool inclusive) {
+    uint32_t low = 0, high = index->count;
+    uint32_t middle = 0;
+    int order = 0;
+
+    while (low < high) {
+        middle = low + (high - low) / 2;
+        order = sai_fdb_key_order(&index->entries[middle]->key, key);
+        if (order < 0 || (order == 0 && !inclusive)) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/*
+* Position of the first entry of vlan_id, or the end of the index for
+* SAI_FDB_VLAN_COUNT.
+*/
+static uint32_t sai_fdb_index_vlan_bound(
+        const sai_fdb_index_t *index,
+        uint32_t vlan_id) {
+    sai_fdb_shadow_key_t key;
+
+    if (vlan_id >= SAI_FDB_VLAN_COUNT) {
+        return index->count;
+    }
+    memset(&key, 0, sizeof(sai_fdb_shadow_key_t));
+    key.vlan_id = (sai_vlan_id_t) vlan_id;
+    return sai_fdb_index_bound(index, &key, true);
+}
+
+/*
+* Make room for one more entry, so that the insert that follows cannot
+* fail.
+*/
+static sai_status_t sai_fdb_index_reserve(
+        sai_fdb_index_t *index) {
+    sai_fdb_shadow_entry_t **entries = NULL;
+    uint32_t size = 0;
+
+    if (index->count < index->size) {
+        return SAI_STATUS_SUCCESS;
+    }
+    size = index->size ? index->size * 2 : SAI_FDB_INDEX_MIN_SIZE;
+    entries = (sai_fdb_shadow_entry_t **) realloc(
+        index->entries, sizeof(sai_fdb_shadow_entry_t *) * size);
+    if (!entries) {
+        return SAI_STATUS_NO_MEMORY;
+    }
+    index->entries = entries;
+    index->size = size;
+    return SAI_STATUS_SUCCESS;
+}
+
+static void sai_fdb_index_insert(
+        sai_fdb_index_t *index,
+        sai_fdb_shadow_entry_t *entry) {
+    uint32_t position = sai_fdb_index_bound(index, &entry->key, true);
+
+    memmove(&index->entries[position + 1], &index->entries[position],
+            sizeof(sai_fdb_shadow_entry_t *) * (index->count - position));
+    index->entries[position] = entry;
+    index->count++;
+}
+
+static void sai_fdb_index_remove(
+        sai_fdb_index_t *index,
+        sai_fdb_shadow_entry_t *entry) {
+    uint32_t position = sai_fdb_index_bound(index, &entry->key, true);
+
+    memmove(&index->entries[position], &index->entries[position + 1],
+            sizeof(sai_fdb_shadow_entry_t *) * (index->count - position - 1));
+    if (--index->count == 0) {
+        free(index->entries);
+        index->entries = NULL;
+        index->size = 0;
+    }
+}
+
+static int sai_fdb_port_entries_cmp(const void *arg, const void *obj) {
+    const switch_handle_t *port_handle = (const switch_handle_t *) arg;
+    const sai_fdb_port_entries_t *port_entries = (const sai_fdb_port_entries_t *) obj;
+    return *port_handle != port_entries->port_handle;
+}
+
+static sai_fdb_port_entries_t *sai_fdb_port_entries_find(
+        switch_handle_t port_handle) {
+    return (sai_fdb_port_entries_t *) tommy_hashdyn_search(
+        &sai_fdb_port_index, sai_fdb_port_entries_cmp, &port_handle,
+        tommy_hash_u32(0, &port_handle, sizeof(switch_handle_t)));
+}
+
+/*
+* Free a port index that no entry ended up on.
+*/
+static void sai_fdb_port_entries_put(
+        sai_fdb_port_entries_t *port_entries) {
+    if (port_entries && !port_entries->index.count) {
+        tommy_hashdyn_remove_existing(&sai_fdb_port_index, &port_entries->node);
+        free(port_entries->index.entries);
+        free(port_entries);
+    }
+}
+
+/*
+* Index of the entries on port_handle, created if there is none, with
+* room for one more entry. *port_entries is NULL for an entry without a
+* port.
+*/
+static sai_status_t sai_fdb_port_entries_get(
+        switch_handle_t port_handle,
+        sai_fdb_port_entries_t **port_entries) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_fdb_port_entries_t *entries = NULL;
+
+    *port_entries = NULL;
+    if (!port_handle) {
+        return SAI_STATUS_SUCCESS;
+    }
+    entries = sai_fdb_port_entries_find(port_handle);
+    if (!entries) {
+        entries = (sai_fdb_port_entries_t *) malloc(sizeof(sai_fdb_port_entries_t));
+        if (!entries) {
+            return SAI_STATUS_NO_MEMORY;
+        }
+        memset(entries, 0, sizeof(sai_fdb_port_entries_t));
+        entries->port_handle = port_handle;
+        tommy_hashdyn_insert(&sai_fdb_port_index, &entries->node, entries,
+                             tommy_hash_u32(0, &port_handle, sizeof(switch_handle_t)));
+    }
+    status = sai_fdb_index_reserve(&entries->index);
+    if (status != SAI_STATUS_SUCCESS) {
+        sai_fdb_port_entries_put(entries);
+        return status;
+    }
+    *port_entries = entries;
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+* Make room for a new entry on its VLAN and port indexes. This is the
+* only step of linking an entry that can fail, so callers reserve before
+* programming anything and link infallibly after.
+*/
+static sai_status_t sai_fdb_shadow_reserve(
+        const sai_fdb_shadow_key_t *key,
+        switch_handle_t port_handle,
+        sai_fdb_port_entries_t **port_entries) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+
+    status = sai_fdb_index_reserve(&sai_fdb_vlan_index[key->vlan_id]);
+    if (status != SAI_STATUS_SUCCESS) {
+        return status;
+    }
+    return sai_fdb_port_entries_get(port_handle, port_entries);
+}
+
+static void sai_fdb_shadow_port_link(
+        sai_fdb_shadow_entry_t *entry,
+        sai_fdb_port_entries_t *port_entries) {
+    if (!port_entries) {
+        return;
+    }
+    sai_fdb_index_insert(&port_entries->index, entry);
+    entry->port_entries = port_entries;
+}
+
+static void sai_fdb_shadow_port_unlink(
+        sai_fdb_shadow_entry_t *entry) {
+    sai_fdb_port_entries_t *port_entries = entry->port_entries;
+
+    if (!port_entries) {
+        return;
+    }
+    sai_fdb_index_remove(&port_entries->index, entry);
+    entry->port_entries = NULL;
+    sai_fdb_port_entries_put(port_entries);
+}
+
+/*
+* Drop an entry from the shadow and all of its indexes. The hardware
+* entry is expected to be gone already.
+*/
+static void sai_fdb_shadow_release(
+        sai_fdb_shadow_entry_t *entry) {
+    sai_fdb_shadow_port_unlink(entry);
+    sai_fdb_index_remove(&sai_fdb_vlan_index[entry->key.vlan_id], entry);
+    tommy_hashdyn_remove_existing(&sai_fdb_shadow, &entry->node);
+    free(entry);
+}
+
+/*
+* Link a new entry into the shadow and its indexes. Takes ownership of
+* entry; room on the indexes comes from sai_fdb_shadow_reserve().
+*/
+static void sai_fdb_shadow_insert(
+        sai_fdb_shadow_entry_t *entry,
+        const sai_fdb_shadow_key_t *key,
+        tommy_hash_t hash,
+        const switch_api_mac_entry_t *mac_entry,
+        sai_fdb_port_entries_t *port_entries) {
+    memset(entry, 0, sizeof(sai_fdb_shadow_entry_t));
+    memcpy(&entry->key, key, sizeof(sai_fdb_shadow_key_t));
+    memcpy(&entry->mac_entry, mac_entry, sizeof(switch_api_mac_entry_t));
+    tommy_hashdyn_insert(&sai_fdb_shadow, &entry->node, entry, hash);
+    sai_fdb_index_insert(&sai_fdb_vlan_index[key->vlan_id], entry);
+    sai_fdb_shadow_port_link(entry, port_entries);
+}
+
+/*
+* Rewrite an existing entry in place with a single switchapi update,
+* moving it to its new port index if the port changed.
+*/
+static sai_status_t sai_fdb_shadow_update(
+        sai_fdb_shadow_entry_t *entry,
+        const switch_api_mac_entry_t *mac_entry) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_fdb_port_entries_t *port_entries = entry->port_entries;
+    switch_api_mac_entry_t new_mac_entry;
+
+    memcpy(&new_mac_entry, mac_entry, sizeof(switch_api_mac_entry_t));
+    if (entry->mac_entry.handle != new_mac_entry.handle) {
+        status = sai_fdb_port_entries_get(new_mac_entry.handle, &port_entries);
+        if (status != SAI_STATUS_SUCCESS) {
+            return status;
+        }
+    }
+    status = switch_api_mac_table_entry_update(device, &new_mac_entry);
+    if (status != SAI_STATUS_SUCCESS) {
+        if (port_entries != entry->port_entries) {
+            sai_fdb_port_entries_put(port_entries);
+        }
+        return status;
+    }
+    if (port_entries != entry->port_entries) {
+        sai_fdb_shadow_port_unlink(entry);
+        sai_fdb_shadow_port_link(entry, port_entries);
+    }
+    memcpy(&entry->mac_entry, &new_mac_entry, sizeof(switch_api_mac_entry_t));
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+* Program a parsed FDB entry. An entry already in the shadow is updated
+* in place.
+*/
+static sai_status_t sai_fdb_shadow_add(
+        const sai_fdb_entry_t *fdb_entry,
+        const switch_api_mac_entry_t *mac_entry) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_fdb_shadow_key_t key;
+    sai_fdb_shadow_entry_t *entry = NULL;
+    sai_fdb_port_entries_t *port_entries = NULL;
+    switch_api_mac_entry_t new_mac_entry;
+    tommy_hash_t hash;
+
+    sai_fdb_shadow_key_init(&key, fdb_entry);
+    entry = sai_fdb_shadow_find(&key, &hash);
+    if (entry) {
+        return sai_fdb_shadow_update(entry, mac_entry);
+    }
+
+    entry = (sai_fdb_shadow_entry_t *) malloc(sizeof(sai_fdb_shadow_entry_t));
+    if (!entry) {
+        return SAI_STATUS_NO_MEMORY;
+    }
+    status = sai_fdb_shadow_reserve(&key, mac_entry->handle, &port_entries);
+    if (status != SAI_STATUS_SUCCESS) {
+        free(entry);
+        return status;
+    }
+    memcpy(&new_mac_entry, mac_entry, sizeof(switch_api_mac_entry_t));
+    status = switch_api_mac_table_entry_add(device, &new_mac_entry);
+    if (status != SAI_STATUS_SUCCESS) {
+        sai_fdb_port_entries_put(port_entries);
+        free(entry);
+        return status;
+    }
+    sai_fdb_shadow_insert(entry, &key, hash, &new_mac_entry, port_entries);
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+* Remove an FDB entry. Entries not in the shadow (e.g. learned ones) are
+* still passed on to switchapi.
+*/
+static sai_status_t sai_fdb_shadow_remove(
+        const sai_fdb_entry_t *fdb_entry,
+        switch_api_mac_entry_t *mac_entry) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_fdb_shadow_key_t key;
+    sai_fdb_shadow_entry_t *entry = NULL;
+    tommy_hash_t hash;
+
+    sai_fdb_shadow_key_init(&key, fdb_entry);
+    entry = sai_fdb_shadow_find(&key, &hash);
+    if (!entry) {
+        return (sai_status_t) switch_api_mac_table_entry_delete(device, mac_entry);
+    }
+    status = switch_api_mac_table_entry_delete(device, &entry->mac_entry);
+    if (status != SAI_STATUS_SUCCESS) {
+        return status;
+    }
+    sai_fdb_shadow_release(entry);
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+* Routine Description:
+*    Reflect learn/age events coming from the data plane in the shadow.
+*    Learned entries are added as dynamic entries without programming
+*    them again; static entries are never moved or aged by events. A
+*    learned entry that cannot be indexed is left out of (or dropped
+*    from) the shadow, as if it had not been learned through SAI.
+*
+* Arguments:
+*    [in] count - number of events
+*    [in] data - array of events
+*
+* Return Values:
+*    None
+*/
+void sai_fdb_event_apply(
+        _In_ uint32_t count,
+        _In_ const sai_fdb_event_notification_data_t *data) {
+    const sai_fdb_event_notification_data_t *event = NULL;
+    sai_fdb_shadow_entry_t *entry = NULL;
+    sai_fdb_port_entries_t *port_entries = NULL;
+    sai_fdb_shadow_key_t key;
+    switch_api_mac_entry_t mac_entry;
+    switch_handle_t port_handle = 0;
+    tommy_hash_t hash;
+    uint32_t index = 0;
+
+    pthread_mutex_lock(&sai_fdb_lock);
+    for (index = 0; index < count; index++) {
+        event = &data[index];
+        sai_fdb_shadow_key_init(&key, &event->fdb_entry);
+        entry = sai_fdb_shadow_find(&key, &hash);
+        if (entry && entry->mac_entry.entry_type == SWITCH_MAC_ENTRY_STATIC) {
+            continue;
+        }
+        if (event->event_type != SAI_FDB_EVENT_LEARNED) {
+            if (entry) {
+                sai_fdb_shadow_release(entry);
+            }
+            continue;
+        }
+
+        port_handle = (switch_handle_t) event->attr[0].value.oid;
+        if (entry) {
+            if (entry->mac_entry.handle != port_handle) {
+                if (sai_fdb_port_entries_get(port_handle, &port_entries) != SAI_STATUS_SUCCESS) {
+                    sai_fdb_shadow_release(entry);
+                    continue;
+                }
+                sai_fdb_shadow_port_unlink(entry);
+                entry->mac_entry.handle = port_handle;
+                sai_fdb_shadow_port_link(entry, port_entries);
+            }
+            continue;
+        }
+        if (sai_fdb_entry_parse(&event->fdb_entry, &mac_entry) != SAI_STATUS_SUCCESS) {
+            continue;
+        }
+        mac_entry.handle = port_handle;
+        mac_entry.entry_type = SWITCH_MAC_ENTRY_DYNAMIC;
+        mac_entry.mac_action = SWITCH_MAC_ACTION_FORWARD;
+        entry = (sai_fdb_shadow_entry_t *) malloc(sizeof(sai_fdb_shadow_entry_t));
+        if (!entry) {
+            continue;
+        }
+        if (sai_fdb_shadow_reserve(&key, port_handle, &port_entries) != SAI_STATUS_SUCCESS) {
+            free(entry);
+            continue;
+        }
+        sai_fdb_shadow_insert(entry, &key, hash, &mac_entry, port_entries);
+    }
+    pthread_mutex_unlock(&sai_fdb_lock);
+}
+
+/*
+* Routine Description:
+*    Program the FDB aging time into switchapi
+*
+* Arguments:
+*    [in] aging_time - aging time in seconds, 0 disables aging
+*
+* Return Values:
+*    SAI_STATUS_SUCCESS on success
+*    Failure status code on error
+*/
+sai_status_t sai_fdb_aging_time_set(
+        _In_ uint32_t aging_time) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+
+    pthread_mutex_lock(&sai_fdb_lock);
+    status = switch_api_mac_table_aging_time_set((uint64_t) aging_time * 1000);
+    if (status == SAI_STATUS_SUCCESS) {
+        __atomic_store_n(&sai_fdb_aging_time, aging_time, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&sai_fdb_lock);
+    return status;
+}
+
+uint32_t sai_fdb_aging_time_get(void) {
+    return __atomic_load_n(&sai_fdb_aging_time, __ATOMIC_RELAXED);
+}
+
 /*
 * Routine Description:
 *    Create FDB entry
@@ -103,9 +614,14 @@ sai_status_t sai_create_fdb_entry(
         return SAI_STATUS_INVALID_PARAMETER;
     }
 
-    sai_fdb_entry_parse(fdb_entry, &mac_entry);
+    status = sai_fdb_entry_parse(fdb_entry, &mac_entry);
+    if (status != SAI_STATUS_SUCCESS) {
+        return status;
+    }
     sai_fdb_entry_attribute_parse(attr_count, attr_list, &mac_entry);
-    status = switch_api_mac_table_entry_add(device, &mac_entry);
+    pthread_mutex_lock(&sai_fdb_lock);
+    status = sai_fdb_shadow_add(fdb_entry, &mac_entry);
+    pthread_mutex_unlock(&sai_fdb_lock);
 
     SAI_LOG_EXIT(SAI_API_FDB);
 
@@ -133,8 +649,13 @@ sai_status_t sai_remove_fdb_entry(
     if (!fdb_entry) {
         return SAI_STATUS_INVALID_PARAMETER;
     }
-    sai_fdb_entry_parse(fdb_entry, &mac_entry);
-    status = switch_api_mac_table_entry_delete(device, &mac_entry);
+    status = sai_fdb_entry_parse(fdb_entry, &mac_entry);
+    if (status != SAI_STATUS_SUCCESS) {
+        return status;
+    }
+    pthread_mutex_lock(&sai_fdb_lock);
+    status = sai_fdb_shadow_remove(fdb_entry, &mac_entry);
+    pthread_mutex_unlock(&sai_fdb_lock);
 
     SAI_LOG_EXIT(SAI_API_FDB);
 
@@ -157,14 +678,46 @@ sai_status_t sai_set_fdb_entry_attribute(
         _In_ const sai_fdb_entry_t *fdb_entry,
         _In_ const sai_attribute_t *attr) {
     switch_api_mac_entry_t mac_entry;
+    sai_fdb_shadow_entry_t *entry = NULL;
+    sai_fdb_shadow_key_t key;
+    tommy_hash_t hash;
     sai_status_t status = SAI_STATUS_SUCCESS;
     
     SAI_LOG_ENTER(SAI_API_FDB);
 
-    if (!fdb_entry) {
+    if (!fdb_entry || !attr) {
         return SAI_STATUS_INVALID_PARAMETER;
     }
-    sai_fdb_entry_parse(fdb_entry, &mac_entry);
+    switch (attr->id) {
+        case SAI_FDB_ENTRY_ATTR_TYPE:
+            if (attr->value.u8 != SAI_FDB_ENTRY_DYNAMIC &&
+                attr->value.u8 != SAI_FDB_ENTRY_STATIC) {
+                return SAI_STATUS_INVALID_PARAMETER;
+            }
+            break;
+        case SAI_FDB_ENTRY_ATTR_PORT_ID:
+            break;
+        case SAI_FDB_ENTRY_ATTR_PACKET_ACTION:
+            if (attr->value.u8 != SAI_PACKET_ACTION_DROP &&
+                attr->value.u8 != SAI_PACKET_ACTION_FORWARD) {
+                return SAI_STATUS_INVALID_PARAMETER;
+            }
+            break;
+        default:
+            return SAI_STATUS_NOT_SUPPORTED;
+    }
+
+    sai_fdb_shadow_key_init(&key, fdb_entry);
+    pthread_mutex_lock(&sai_fdb_lock);
+    entry = sai_fdb_shadow_find(&key, &hash);
+    if (!entry) {
+        status = SAI_STATUS_ITEM_NOT_FOUND;
+    } else {
+        memcpy(&mac_entry, &entry->mac_entry, sizeof(switch_api_mac_entry_t));
+        sai_fdb_entry_attribute_parse(1, attr, &mac_entry);
+        status = sai_fdb_shadow_update(entry, &mac_entry);
+    }
+    pthread_mutex_unlock(&sai_fdb_lock);
 
     SAI_LOG_EXIT(SAI_API_FDB);
 
@@ -188,9 +741,216 @@ sai_status_t sai_get_fdb_entry_attribute(
         _In_ const sai_fdb_entry_t *fdb_entry,
         _In_ uint32_t attr_count,
         _Inout_ sai_attribute_t *attr_list) {
+    const sai_fdb_shadow_entry_t *entry = NULL;
+    sai_attribute_t *attribute;
+    sai_fdb_shadow_key_t key;
+    tommy_hash_t hash;
+    uint32_t index = 0;
+    sai_status_t status = SAI_STATUS_SUCCESS;
+
     SAI_LOG_ENTER(SAI_API_FDB);
+
+    if (!fdb_entry || (attr_count && !attr_list)) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    sai_fdb_shadow_key_init(&key, fdb_entry);
+    pthread_mutex_lock(&sai_fdb_lock);
+    entry = sai_fdb_shadow_find(&key, &hash);
+    if (!entry) {
+        status = SAI_STATUS_ITEM_NOT_FOUND;
+    }
+    for (index = 0; entry && index < attr_count; index++) {
+        attribute = &attr_list[index];
+        switch (attribute->id) {
+            case SAI_FDB_ENTRY_ATTR_TYPE:
+                attribute->value.u8 = (entry->mac_entry.entry_type == SWITCH_MAC_ENTRY_STATIC) ?
+                                      SAI_FDB_ENTRY_STATIC : SAI_FDB_ENTRY_DYNAMIC;
+                break;
+            case SAI_FDB_ENTRY_ATTR_PORT_ID:
+                attribute->value.oid = (sai_object_id_t) entry->mac_entry.handle;
+                break;
+            case SAI_FDB_ENTRY_ATTR_PACKET_ACTION:
+                attribute->value.u8 = (entry->mac_entry.mac_action == SWITCH_MAC_ACTION_DROP) ?
+                                      SAI_PACKET_ACTION_DROP : SAI_PACKET_ACTION_FORWARD;
+                break;
+            default:
+                status = SAI_STATUS_NOT_SUPPORTED;
+                break;
+        }
+    }
+    pthread_mutex_unlock(&sai_fdb_lock);
+
     SAI_LOG_EXIT(SAI_API_FDB);
-    return 0;
+
+    return (sai_status_t) status;
+}
+
+/*
+* Selection made by a flush or dump request. entry_type is 0 when
+* entries of every type are selected.
+*/
+typedef struct _sai_fdb_filter_t {
+    bool port_valid;
+    switch_handle_t port_handle;
+    bool vlan_valid;
+    sai_vlan_id_t vlan_id;
+    switch_mac_entry_type_t entry_type;
+} sai_fdb_filter_t;
+
+static sai_status_t sai_fdb_filter_parse(
+        uint32_t attr_count,
+        const sai_attribute_t *attr_list,
+        sai_fdb_filter_t *filter) {
+    const sai_attribute_t *attribute;
+    uint32_t index = 0;
+
+    memset(filter, 0, sizeof(sai_fdb_filter_t));
+    for (index = 0; index < attr_count; index++) {
+        attribute = &attr_list[index];
+        switch (attribute->id) {
+            case SAI_FDB_FLUSH_ATTR_PORT_ID:
+                filter->port_valid = true;
+                filter->port_handle = (switch_handle_t) attribute->value.oid;
+                break;
+            case SAI_FDB_FLUSH_ATTR_VLAN_ID:
+                if (attribute->value.u16 >= SAI_FDB_VLAN_COUNT) {
+                    return SAI_STATUS_INVALID_PARAMETER;
+                }
+                filter->vlan_valid = true;
+                filter->vlan_id = attribute->value.u16;
+                break;
+            case SAI_FDB_FLUSH_ATTR_ENTRY_TYPE:
+                switch (attribute->value.u8) {
+                    case SAI_FDB_FLUSH_ENTRY_DYNAMIC:
+                        filter->entry_type = SWITCH_MAC_ENTRY_DYNAMIC;
+                        break;
+                    case SAI_FDB_FLUSH_ENTRY_STATIC:
+                        filter->entry_type = SWITCH_MAC_ENTRY_STATIC;
+                        break;
+                    default:
+                        return SAI_STATUS_INVALID_PARAMETER;
+                }
+                break;
+            default:
+                return SAI_STATUS_NOT_SUPPORTED;
+        }
+    }
+    return SAI_STATUS_SUCCESS;
+}
+
+static bool sai_fdb_filter_match(
+        const sai_fdb_filter_t *filter,
+        const sai_fdb_shadow_entry_t *entry) {
+    if (filter->port_valid && entry->mac_entry.handle != filter->port_handle) {
+        return false;
+    }
+    if (filter->vlan_valid && entry->key.vlan_id != filter->vlan_id) {
+        return false;
+    }
+    if (filter->entry_type && entry->mac_entry.entry_type != filter->entry_type) {
+        return false;
+    }
+    return true;
+}
+
+/*
+* Flush the matching entries of positions [start, end) of an index. When
+* program is false the hardware has already been flushed and only the
+* shadow is pruned. The range is walked backwards, so releasing an entry
+* only moves entries that have been visited already.
+*/
+static sai_status_t sai_fdb_flush_range(
+        sai_fdb_index_t *index,
+        uint32_t start,
+        uint32_t end,
+        const sai_fdb_filter_t *filter,
+        bool program) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_status_t entry_status = SAI_STATUS_SUCCESS;
+    sai_fdb_shadow_entry_t *entry = NULL;
+    uint32_t position = 0;
+
+    for (position = end; position > start; position--) {
+        // releasing the last entry may free the index itself
+        entry = index->entries[position - 1];
+        if (!sai_fdb_filter_match(filter, entry)) {
+            continue;
+        }
+        if (program) {
+            entry_status = switch_api_mac_table_entry_delete(device, &entry->mac_entry);
+            if (entry_status != SAI_STATUS_SUCCESS) {
+                status = entry_status;
+                continue;
+            }
+        }
+        sai_fdb_shadow_release(entry);
+    }
+    return status;
+}
+
+/*
+* Flush the shadow entries selected by filter, walking the port index
+* (only the VLAN's range of it if a VLAN is given), the VLAN index, or
+* every VLAN index for a table-wide flush.
+*/
+static sai_status_t sai_fdb_flush_index(
+        const sai_fdb_filter_t *filter) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_status_t range_status = SAI_STATUS_SUCCESS;
+    sai_fdb_port_entries_t *port_entries = NULL;
+    sai_fdb_index_t *index = NULL;
+    bool program = filter->entry_type != 0;
+    uint32_t start = 0, end = 0;
+    uint32_t vlan_id = 0;
+
+    if (filter->port_valid) {
+        port_entries = sai_fdb_port_entries_find(filter->port_handle);
+        if (!port_entries) {
+            return SAI_STATUS_SUCCESS;
+        }
+        index = &port_entries->index;
+        end = index->count;
+        if (filter->vlan_valid) {
+            start = sai_fdb_index_vlan_bound(index, filter->vlan_id);
+            end = sai_fdb_index_vlan_bound(index, filter->vlan_id + 1);
+        }
+        return sai_fdb_flush_range(index, start, end, filter, program);
+    }
+    if (filter->vlan_valid) {
+        index = &sai_fdb_vlan_index[filter->vlan_id];
+        return sai_fdb_flush_range(index, 0, index->count, filter, program);
+    }
+    for (vlan_id = 0; vlan_id < SAI_FDB_VLAN_COUNT; vlan_id++) {
+        index = &sai_fdb_vlan_index[vlan_id];
+        if (index->count) {
+            range_status = sai_fdb_flush_range(index, 0, index->count, filter, program);
+            if (range_status != SAI_STATUS_SUCCESS) {
+                status = range_status;
+            }
+        }
+    }
+    return status;
+}
+
+/*
+* Drop the shadow entries of a VLAN that has been deleted. switchapi
+* removes the VLAN's MAC entries with it, so only the shadow is pruned.
+*/
+void sai_fdb_vlan_prune(
+        _In_ sai_vlan_id_t vlan_id) {
+    sai_fdb_filter_t filter;
+
+    if (vlan_id >= SAI_FDB_VLAN_COUNT) {
+        return;
+    }
+    memset(&filter, 0, sizeof(sai_fdb_filter_t));
+    filter.vlan_valid = true;
+    filter.vlan_id = vlan_id;
+    pthread_mutex_lock(&sai_fdb_lock);
+    sai_fdb_flush_range(&sai_fdb_vlan_index[vlan_id], 0,
+                        sai_fdb_vlan_index[vlan_id].count, &filter, false);
+    pthread_mutex_unlock(&sai_fdb_lock);
 }
 
 /*
@@ -204,6 +964,11 @@ sai_status_t sai_get_fdb_entry_attribute(
 * Return Values:
 *    SAI_STATUS_SUCCESS on success
 *    Failure status code on error
+*
+* Note: without SAI_FDB_FLUSH_ATTR_ENTRY_TYPE entries of every type are
+*   flushed through switchapi's port/VLAN flush, which also covers
+*   learned entries. With an entry type only the matching entries of the
+*   port or VLAN index are deleted.
 */
 sai_status_t sai_flush_fdb_entries(
         _In_ uint32_t attr_count,
@@ -211,63 +976,408 @@ sai_status_t sai_flush_fdb_entries(
 
     SAI_LOG_ENTER(SAI_API_FDB);
 
-    const sai_attribute_t *attribute;
-    uint32_t index = 0;
-    sai_object_id_t port_id = 0;
-    sai_vlan_id_t vlan_id = 0;
-    bool flush_all = false;
-    bool port_valid = false;
-    bool vlan_valid = false;
+    sai_fdb_filter_t filter;
     switch_handle_t vlan_handle = 0;
-    sai_fdb_flush_entry_type_t entry_type = 0;
     sai_status_t status = SAI_STATUS_SUCCESS;
 
-    for (index = 0; index < attr_count; index++) {
-        attribute = &attr_list[index];
-        switch (attribute->id) {
-            case SAI_FDB_FLUSH_ATTR_PORT_ID:
-                port_id = attribute->value.oid;
-                break;
-            case SAI_FDB_FLUSH_ATTR_VLAN_ID:
-                vlan_id = attribute->value.u16;
-                break;
-            case SAI_FDB_FLUSH_ATTR_ENTRY_TYPE:
-                entry_type = attribute->value.u8;
-                switch (entry_type) {
-//                    case SAI_FDB_FLUSH_ENTRY_ALL:
-//                        flush_all = true;
-//                        break;
-                    case SAI_FDB_FLUSH_ENTRY_DYNAMIC:
-                    case SAI_FDB_FLUSH_ENTRY_STATIC:
-                        return SAI_STATUS_NOT_SUPPORTED;
-                }
-                break;
+    if (attr_count && !attr_list) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    status = sai_fdb_filter_parse(attr_count, attr_list, &filter);
+    if (status != SAI_STATUS_SUCCESS) {
+        return status;
+    }
+    if (filter.vlan_valid) {
+        status = sai_vlan_id_to_handle(filter.vlan_id, &vlan_handle);
+        if (status != SAI_STATUS_SUCCESS) {
+            return status;
         }
     }
-    if (flush_all) {
-        status = switch_api_mac_table_entries_delete_all(device);
-    } else {
-        if (port_valid && vlan_valid) {
-            switch_api_vlan_id_to_handle_get(vlan_id, &vlan_handle);
+
+    pthread_mutex_lock(&sai_fdb_lock);
+    if (!filter.entry_type) {
+        if (filter.port_valid && filter.vlan_valid) {
             status = switch_api_mac_table_entries_delete_by_interface_vlan(
-                device, (switch_handle_t)port_id, vlan_handle);
-        } else if (port_valid) {
+                device, filter.port_handle, vlan_handle);
+        } else if (filter.port_valid) {
             status = switch_api_mac_table_entries_delete_by_interface(
-                device, (switch_handle_t)port_id);
-        } else if (vlan_valid) {
-            switch_api_vlan_id_to_handle_get(vlan_id, &vlan_handle);
+                device, filter.port_handle);
+        } else if (filter.vlan_valid) {
             status = switch_api_mac_table_entries_delete_by_vlan(device,
                                                                  vlan_handle);
         } else {
-            status = SAI_STATUS_FAILURE;
+            status = switch_api_mac_table_entries_delete_all(device);
+        }
+    }
+    if (status == SAI_STATUS_SUCCESS) {
+        status = sai_fdb_flush_index(&filter);
+    }
+    pthread_mutex_unlock(&sai_fdb_lock);
+
+    SAI_LOG_EXIT(SAI_API_FDB);
+
+    return status;
+}
+
+/*
+* One page of a dump, filled in (VLAN, MAC) order.
+*/
+typedef struct _sai_fdb_page_t {
+    const sai_fdb_filter_t *filter;
+    sai_fdb_entry_info_t *entries;
+    uint32_t capacity;
+    uint32_t count;
+    bool more;
+} sai_fdb_page_t;
+
+/*
+* Add the matching entries of positions [start, end) of an index to the
+* page. Returns false once a match is found past a full page.
+*/
+static bool sai_fdb_page_fill(
+        sai_fdb_page_t *page,
+        const sai_fdb_index_t *index,
+        uint32_t start,
+        uint32_t end) {
+    const sai_fdb_shadow_entry_t *entry = NULL;
+    sai_fdb_entry_info_t *info = NULL;
+    uint32_t position = 0;
+
+    for (position = start; position < end; position++) {
+        entry = index->entries[position];
+        if (!sai_fdb_filter_match(page->filter, entry)) {
+            continue;
+        }
+        if (page->count == page->capacity) {
+            page->more = true;
+            return false;
+        }
+        info = &page->entries[page->count++];
+        info->fdb_entry.vlan_id = entry->key.vlan_id;
+        memcpy(info->fdb_entry.mac_address, entry->key.mac_address, sizeof(sai_mac_t));
+        info->type = (entry->mac_entry.entry_type == SWITCH_MAC_ENTRY_STATIC) ?
+                     SAI_FDB_ENTRY_STATIC : SAI_FDB_ENTRY_DYNAMIC;
+        info->port_id = (sai_object_id_t) entry->mac_entry.handle;
+        info->packet_action = (entry->mac_entry.mac_action == SWITCH_MAC_ACTION_DROP) ?
+                              SAI_PACKET_ACTION_DROP : SAI_PACKET_ACTION_FORWARD;
+    }
+    return true;
+}
+
+/*
+* Fill the page from the index that covers the filter, starting right
+* after the cursor. A table-wide dump walks the VLAN indexes in order.
+*/
+static void sai_fdb_page_collect(
+        sai_fdb_page_t *page,
+        const sai_fdb_shadow_key_t *cursor) {
+    const sai_fdb_filter_t *filter = page->filter;
+    sai_fdb_port_entries_t *port_entries = NULL;
+    const sai_fdb_index_t *index = NULL;
+    uint32_t start = 0, end = 0;
+    uint32_t vlan_id = 0;
+
+    if (filter->port_valid) {
+        port_entries = sai_fdb_port_entries_find(filter->port_handle);
+        if (!port_entries) {
+            return;
         }
+        index = &port_entries->index;
+        end = index->count;
+        if (filter->vlan_valid) {
+            start = sai_fdb_index_vlan_bound(index, filter->vlan_id);
+            end = sai_fdb_index_vlan_bound(index, filter->vlan_id + 1);
+        }
+        if (cursor && sai_fdb_index_bound(index, cursor, false) > start) {
+            start = sai_fdb_index_bound(index, cursor, false);
+        }
+        sai_fdb_page_fill(page, index, start, end);
+        return;
+    }
+    if (filter->vlan_valid) {
+        index = &sai_fdb_vlan_index[filter->vlan_id];
+        start = cursor ? sai_fdb_index_bound(index, cursor, false) : 0;
+        sai_fdb_page_fill(page, index, start, index->count);
+        return;
+    }
+    for (vlan_id = cursor ? cursor->vlan_id : 0; vlan_id < SAI_FDB_VLAN_COUNT; vlan_id++) {
+        index = &sai_fdb_vlan_index[vlan_id];
+        if (!index->count) {
+            continue;
+        }
+        start = cursor ? sai_fdb_index_bound(index, cursor, false) : 0;
+        if (!sai_fdb_page_fill(page, index, start, index->count)) {
+            return;
+        }
+    }
+}
+
+/*
+* Routine Description:
+*    Read one page of the FDB table in (VLAN, MAC) order
+*
+* Arguments:
+*    [in] attr_count - number of filter attributes
+*    [in] attr_list - filter, SAI_FDB_FLUSH_ATTR_PORT_ID, _VLAN_ID and
+*                     _ENTRY_TYPE select entries as they do for a flush
+*    [in] cursor - last entry of the previous page, NULL for the first page
+*    [inout] entry_count - size of entries on input, entries returned on output
+*    [out] entries - entries of the page
+*    [out] more - true if entries past the page match
+*
+* Return Values:
+*    SAI_STATUS_SUCCESS on success
+*    Failure status code on error
+*
+* Note: the table lock is only held while one page is collected, so
+*   programming can proceed between pages. The cursor is a key, not a
+*   position; entries added or removed between pages do not invalidate
+*   it. Each page resumes with a binary search for the cursor, so a full
+*   dump visits every selected entry once.
+*/
+sai_status_t sai_get_fdb_entries(
+        _In_ uint32_t attr_count,
+        _In_ const sai_attribute_t *attr_list,
+        _In_ const sai_fdb_entry_t *cursor,
+        _Inout_ uint32_t *entry_count,
+        _Out_ sai_fdb_entry_info_t *entries,
+        _Out_ bool *more) {
+
+    SAI_LOG_ENTER(SAI_API_FDB);
+
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_fdb_filter_t filter;
+    sai_fdb_shadow_key_t cursor_key;
+    sai_fdb_page_t page;
+
+    if ((attr_count && !attr_list) || !entry_count || !*entry_count ||
+        !entries || !more) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    status = sai_fdb_filter_parse(attr_count, attr_list, &filter);
+    if (status != SAI_STATUS_SUCCESS) {
+        return status;
     }
+    if (cursor) {
+        sai_fdb_shadow_key_init(&cursor_key, cursor);
+    }
+    memset(&page, 0, sizeof(sai_fdb_page_t));
+    page.filter = &filter;
+    page.entries = entries;
+    page.capacity = *entry_count;
+
+    pthread_mutex_lock(&sai_fdb_lock);
+    sai_fdb_page_collect(&page, cursor ? &cursor_key : NULL);
+    pthread_mutex_unlock(&sai_fdb_lock);
+
+    *entry_count = page.count;
+    *more = page.more;
 
     SAI_LOG_EXIT(SAI_API_FDB);
 
     return status;
 }
 
+/*
+* Parsed form of one entry of a bulk FDB request. Entries are sorted by
+* VLAN so that each distinct VLAN handle is looked up once per batch.
+*/
+typedef struct _sai_fdb_bulk_entry_t {
+    uint32_t index;
+    sai_fdb_entry_t fdb_entry;
+    switch_api_mac_entry_t mac_entry;
+} sai_fdb_bulk_entry_t;
+
+static int sai_fdb_bulk_entry_cmp(const void *a, const void *b) {
+    const sai_fdb_bulk_entry_t *entry1 = (const sai_fdb_bulk_entry_t *) a;
+    const sai_fdb_bulk_entry_t *entry2 = (const sai_fdb_bulk_entry_t *) b;
+    if (entry1->fdb_entry.vlan_id != entry2->fdb_entry.vlan_id) {
+        return (entry1->fdb_entry.vlan_id < entry2->fdb_entry.vlan_id) ? -1 : 1;
+    }
+    // keep request order within a VLAN
+    return (entry1->index < entry2->index) ? -1 : (entry1->index > entry2->index);
+}
+
+/*
+* Commit a run of parsed entries that share a VLAN. This is the single
+* point where bulk FDB requests reach switchapi.
+*/
+static void sai_fdb_bulk_commit(
+        bool add,
+        uint32_t count,
+        sai_fdb_bulk_entry_t *entries,
+        sai_status_t *object_statuses) {
+    sai_fdb_bulk_entry_t *entry;
+    switch_handle_t vlan_handle = 0;
+    uint32_t index = 0;
+
+    if (sai_vlan_id_to_handle(entries[0].fdb_entry.vlan_id, &vlan_handle) != SAI_STATUS_SUCCESS ||
+        !vlan_handle) {
+        for (index = 0; index < count; index++) {
+            object_statuses[entries[index].index] = SAI_STATUS_INVALID_PARAMETER;
+        }
+        return;
+    }
+    for (index = 0; index < count; index++) {
+        entry = &entries[index];
+        entry->mac_entry.vlan_handle = vlan_handle;
+        if (add) {
+            object_statuses[entry->index] = sai_fdb_shadow_add(
+                &entry->fdb_entry, &entry->mac_entry);
+        } else {
+            object_statuses[entry->index] = sai_fdb_shadow_remove(
+                &entry->fdb_entry, &entry->mac_entry);
+        }
+    }
+}
+
+static sai_status_t sai_fdb_bulk_apply(
+        bool add,
+        uint32_t object_count,
+        sai_fdb_bulk_entry_t *entries,
+        sai_status_t *object_statuses) {
+    uint32_t start = 0, end = 0;
+    uint32_t index = 0;
+
+    qsort(entries, object_count, sizeof(sai_fdb_bulk_entry_t),
+          sai_fdb_bulk_entry_cmp);
+    pthread_mutex_lock(&sai_fdb_lock);
+    while (start < object_count) {
+        end = start + 1;
+        while (end < object_count &&
+               entries[end].fdb_entry.vlan_id == entries[start].fdb_entry.vlan_id) {
+            end++;
+        }
+        sai_fdb_bulk_commit(add, end - start, &entries[start], object_statuses);
+        start = end;
+    }
+    pthread_mutex_unlock(&sai_fdb_lock);
+
+    for (index = 0; index < object_count; index++) {
+        if (object_statuses[entries[index].index] != SAI_STATUS_SUCCESS) {
+            return SAI_STATUS_FAILURE;
+        }
+    }
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+* Routine Description:
+*    Create FDB entries in bulk
+*
+* Arguments:
+*    [in] object_count - number of fdb entries
+*    [in] fdb_entry - array of fdb entries
+*    [in] attr_count - number of attributes for each entry
+*    [in] attr_list - array of attribute arrays, one per entry
+*    [out] object_statuses - status of each entry
+*
+* Return Values:
+*    SAI_STATUS_SUCCESS if all entries were created
+*    SAI_STATUS_FAILURE if any entry failed, see object_statuses
+*/
+sai_status_t sai_bulk_create_fdb_entry(
+        _In_ uint32_t object_count,
+        _In_ const sai_fdb_entry_t *fdb_entry,
+        _In_ const uint32_t *attr_count,
+        _In_ const sai_attribute_t **attr_list,
+        _Out_ sai_status_t *object_statuses) {
+
+    SAI_LOG_ENTER(SAI_API_FDB);
+
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_fdb_bulk_entry_t *entries = NULL;
+    sai_fdb_bulk_entry_t *entry = NULL;
+    uint32_t valid_count = 0;
+    uint32_t index = 0;
+
+    if (!fdb_entry || !attr_count || !attr_list || !object_statuses) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    if (!object_count) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    entries = (sai_fdb_bulk_entry_t *) malloc(sizeof(sai_fdb_bulk_entry_t) * object_count);
+    if (!entries) {
+        return SAI_STATUS_NO_MEMORY;
+    }
+    for (index = 0; index < object_count; index++) {
+        if (!attr_list[index]) {
+            object_statuses[index] = SAI_STATUS_INVALID_PARAMETER;
+            continue;
+        }
+        entry = &entries[valid_count++];
+        memset(entry, 0, sizeof(sai_fdb_bulk_entry_t));
+        entry->index = index;
+        entry->fdb_entry = fdb_entry[index];
+        memcpy(entry->mac_entry.mac.mac_addr, fdb_entry[index].mac_address, 6);
+        sai_fdb_entry_attribute_parse(attr_count[index], attr_list[index],
+                                      &entry->mac_entry);
+    }
+    status = sai_fdb_bulk_apply(true, valid_count, entries, object_statuses);
+    if (valid_count != object_count) {
+        status = SAI_STATUS_FAILURE;
+    }
+    free(entries);
+
+    SAI_LOG_EXIT(SAI_API_FDB);
+
+    return (sai_status_t) status;
+}
+
+/*
+* Routine Description:
+*    Remove FDB entries in bulk
+*
+* Arguments:
+*    [in] object_count - number of fdb entries
+*    [in] fdb_entry - array of fdb entries
+*    [out] object_statuses - status of each entry
+*
+* Return Values:
+*    SAI_STATUS_SUCCESS if all entries were removed
+*    SAI_STATUS_FAILURE if any entry failed, see object_statuses
+*/
+sai_status_t sai_bulk_remove_fdb_entry(
+        _In_ uint32_t object_count,
+        _In_ const sai_fdb_entry_t *fdb_entry,
+        _Out_ sai_status_t *object_statuses) {
+
+    SAI_LOG_ENTER(SAI_API_FDB);
+
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_fdb_bulk_entry_t *entries = NULL;
+    sai_fdb_bulk_entry_t *entry = NULL;
+    uint32_t index = 0;
+
+    if (!fdb_entry || !object_statuses) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    if (!object_count) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    entries = (sai_fdb_bulk_entry_t *) malloc(sizeof(sai_fdb_bulk_entry_t) * object_count);
+    if (!entries) {
+        return SAI_STATUS_NO_MEMORY;
+    }
+    for (index = 0; index < object_count; index++) {
+        entry = &entries[index];
+        memset(entry, 0, sizeof(sai_fdb_bulk_entry_t));
+        entry->index = index;
+        entry->fdb_entry = fdb_entry[index];
+        memcpy(entry->mac_entry.mac.mac_addr, fdb_entry[index].mac_address, 6);
+    }
+    status = sai_fdb_bulk_apply(false, object_count, entries, object_statuses);
+    free(entries);
+
+    SAI_LOG_EXIT(SAI_API_FDB);
+
+    return (sai_status_t) status;
+}
+
 /*
 *  FDB methods table retrieved with sai_api_query()
 */
@@ -281,5 +1391,7 @@ sai_fdb_api_t fdb_api = {
 
 sai_status_t sai_fdb_initialize(sai_api_service_t *sai_api_service) {
     sai_api_service->fdb_api = fdb_api;
-    return SAI_STATUS_SUCCESS;
+    tommy_hashdyn_init(&sai_fdb_shadow);
+    tommy_hashdyn_init(&sai_fdb_port_index);
+    return sai_fdb_event_initialize();
 }
@@ -0,0 +1,370 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <saifdb.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "saiinternal.h"
+#include "sailog.h"
+#include <switchapi/switch_l2.h>
+#include <tommyds/tommyhashdyn.h>
+
+/*
+* FDB event pipeline.
+*
+* Learn and age notifications are posted into a bounded multi-producer
+* ring without taking a lock. A single delivery thread drains the ring
+* at a fixed interval, folds repeated events for the same (VLAN, MAC)
+* into the latest one, updates the FDB shadow and hands the result to
+* on_fdb_event in batches.
+*/
+#define SAI_FDB_EVENT_RING_SIZE         65536       // power of two
+#define SAI_FDB_EVENT_RING_MASK         (SAI_FDB_EVENT_RING_SIZE - 1)
+#define SAI_FDB_EVENT_DRAIN_MAX         16384       // events coalesced per pass
+#define SAI_FDB_EVENT_INDEX_SIZE        (SAI_FDB_EVENT_DRAIN_MAX * 2)
+#define SAI_FDB_EVENT_INDEX_MASK        (SAI_FDB_EVENT_INDEX_SIZE - 1)
+#define SAI_FDB_EVENT_INDEX_EMPTY       0xFFFFFFFF
+#define SAI_FDB_EVENT_ATTR_COUNT        2
+
+#define SAI_FDB_EVENT_DEFAULT_INTERVAL  50          // msec
+#define SAI_FDB_EVENT_DEFAULT_BATCH     1024
+
+typedef struct _sai_fdb_event_key_t {
+    switch_handle_t vlan_handle;
+    switch_mac_addr_t mac;
+} sai_fdb_event_key_t;
+
+typedef struct _sai_fdb_event_record_t {
+    sai_fdb_event_key_t key;
+    sai_fdb_event_t event_type;
+    switch_handle_t port_handle;
+} sai_fdb_event_record_t;
+
+typedef struct _sai_fdb_event_slot_t {
+    uint32_t sequence;
+    sai_fdb_event_record_t record;
+} sai_fdb_event_slot_t;
+
+typedef struct _sai_fdb_event_ring_t {
+    uint32_t head;                      // consumer only
+    uint32_t tail;                      // claimed by producers
+    uint32_t dropped;
+    sai_fdb_event_slot_t slots[SAI_FDB_EVENT_RING_SIZE];
+} sai_fdb_event_ring_t;
+
+static sai_fdb_event_ring_t sai_fdb_event_ring;
+
+static uint32_t sai_fdb_event_interval = SAI_FDB_EVENT_DEFAULT_INTERVAL;
+static uint32_t sai_fdb_event_batch_size = SAI_FDB_EVENT_DEFAULT_BATCH;
+static pthread_t sai_fdb_event_thread;
+static bool sai_fdb_event_running;
+
+/*
+* Wakes the delivery thread early to stop it. stopping is only changed
+* and read under sai_fdb_event_stop_lock, which is never held while the
+* thread delivers events.
+*/
+static pthread_mutex_t sai_fdb_event_stop_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sai_fdb_event_stop_cond;
+static bool sai_fdb_event_stopping;
+
+/*
+* Delivery thread state: the coalesced events of one drain, the
+* open-addressing index from key to pending slot, and the notification
+* arrays handed to the application.
+*/
+static sai_fdb_event_record_t sai_fdb_event_pending[SAI_FDB_EVENT_DRAIN_MAX];
+static uint32_t sai_fdb_event_index[SAI_FDB_EVENT_INDEX_SIZE];
+static sai_fdb_event_notification_data_t sai_fdb_event_data[SAI_FDB_EVENT_DRAIN_MAX];
+static sai_attribute_t sai_fdb_event_attrs[SAI_FDB_EVENT_DRAIN_MAX][SAI_FDB_EVENT_ATTR_COUNT];
+
+/*
+* Routine Description:
+*    Queue an FDB event for delivery. Safe to call from any thread; the
+*    event is dropped and counted if the ring is full.
+*
+* Arguments:
+*    [in] event_type - learned, aged or flushed
+*    [in] mac_entry - switchapi mac entry the event is about
+*
+* Return Values:
+*    None
+*/
+void sai_fdb_event_post(
+        _In_ sai_fdb_event_t event_type,
+        _In_ const switch_api_mac_entry_t *mac_entry) {
+    sai_fdb_event_ring_t *ring = &sai_fdb_event_ring;
+    sai_fdb_event_slot_t *slot = NULL;
+    uint32_t pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    uint32_t sequence = 0;
+    int32_t diff = 0;
+
+    for (;;) {
+        slot = &ring->slots[pos & SAI_FDB_EVENT_RING_MASK];
+        sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        diff = (int32_t) (sequence - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->tail, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+            return;
+        } else {
+            pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    memset(&slot->record, 0, sizeof(sai_fdb_event_record_t));
+    slot->record.key.vlan_handle = mac_entry->vlan_handle;
+    memcpy(&slot->record.key.mac, &mac_entry->mac, sizeof(switch_mac_addr_t));
+    slot->record.event_type = event_type;
+    slot->record.port_handle = mac_entry->handle;
+    __atomic_store_n(&slot->sequence, pos + 1, __ATOMIC_RELEASE);
+}
+
+static bool sai_fdb_event_ring_pop(
+        sai_fdb_event_record_t *record) {
+    sai_fdb_event_ring_t *ring = &sai_fdb_event_ring;
+    uint32_t pos = ring->head;
+    sai_fdb_event_slot_t *slot = &ring->slots[pos & SAI_FDB_EVENT_RING_MASK];
+
+    if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != pos + 1) {
+        return false;
+    }
+    memcpy(record, &slot->record, sizeof(sai_fdb_event_record_t));
+    __atomic_store_n(&slot->sequence, pos + SAI_FDB_EVENT_RING_SIZE, __ATOMIC_RELEASE);
+    ring->head = pos + 1;
+    return true;
+}
+
+/*
+* Pull up to SAI_FDB_EVENT_DRAIN_MAX distinct keys off the ring, keeping
+* only the latest event per (VLAN, MAC) in the order each key was first
+* seen. Returns the number of pending events.
+*/
+static uint32_t sai_fdb_event_coalesce(void) {
+    sai_fdb_event_record_t record;
+    uint32_t count = 0;
+    uint32_t slot = 0;
+
+    memset(sai_fdb_event_index, 0xFF, sizeof(sai_fdb_event_index));
+    while (count < SAI_FDB_EVENT_DRAIN_MAX && sai_fdb_event_ring_pop(&record)) {
+        slot = tommy_hash_u32(0, &record.key, sizeof(sai_fdb_event_key_t)) &
+               SAI_FDB_EVENT_INDEX_MASK;
+        while (sai_fdb_event_index[slot] != SAI_FDB_EVENT_INDEX_EMPTY &&
+               memcmp(&sai_fdb_event_pending[sai_fdb_event_index[slot]].key,
+                      &record.key, sizeof(sai_fdb_event_key_t))) {
+            slot = (slot + 1) & SAI_FDB_EVENT_INDEX_MASK;
+        }
+        if (sai_fdb_event_index[slot] == SAI_FDB_EVENT_INDEX_EMPTY) {
+            sai_fdb_event_index[slot] = count;
+            memcpy(&sai_fdb_event_pending[count++], &record, sizeof(sai_fdb_event_record_t));
+        } else {
+            memcpy(&sai_fdb_event_pending[sai_fdb_event_index[slot]], &record,
+                   sizeof(sai_fdb_event_record_t));
+        }
+    }
+    return count;
+}
+
+/*
+* One delivery pass. Returns the number of keys taken off the ring so the
+* caller can tell whether the ring still has a backlog.
+*/
+static uint32_t sai_fdb_event_drain(void) {
+    sai_fdb_event_notification_data_t *data = NULL;
+    sai_fdb_event_record_t *record = NULL;
+    sai_fdb_event_notification_fn on_fdb_event = NULL;
+    sai_attribute_t *attrs = NULL;
+    uint32_t pending = 0;
+    uint32_t count = 0;
+    uint32_t index = 0;
+    uint32_t batch = 0;
+    uint32_t dropped = 0;
+
+    dropped = __atomic_exchange_n(&sai_fdb_event_ring.dropped, 0, __ATOMIC_RELAXED);
+    if (dropped) {
+        SAI_LOG(SAI_LOG_WARN, SAI_API_FDB, "fdb event ring full, %u events dropped\n", dropped);
+    }
+
+    pending = sai_fdb_event_coalesce();
+    for (index = 0; index < pending; index++) {
+        record = &sai_fdb_event_pending[index];
+        data = &sai_fdb_event_data[count];
+        attrs = sai_fdb_event_attrs[count];
+        if (sai_vlan_handle_to_id(record->key.vlan_handle,
+                                  &data->fdb_entry.vlan_id) != SAI_STATUS_SUCCESS) {
+            continue;
+        }
+        memcpy(data->fdb_entry.mac_address, record->key.mac.mac_addr, sizeof(sai_mac_t));
+        data->event_type = record->event_type;
+        attrs[0].id = SAI_FDB_ENTRY_ATTR_PORT_ID;
+        attrs[0].value.oid = (sai_object_id_t) record->port_handle;
+        attrs[1].id = SAI_FDB_ENTRY_ATTR_TYPE;
+        attrs[1].value.u8 = SAI_FDB_ENTRY_DYNAMIC;
+        data->attr_count = SAI_FDB_EVENT_ATTR_COUNT;
+        data->attr = attrs;
+        count++;
+    }
+    if (!count) {
+        return pending;
+    }
+
+    sai_fdb_event_apply(count, sai_fdb_event_data);
+
+    on_fdb_event = sai_switch_notifications.on_fdb_event;
+    if (!on_fdb_event) {
+        return pending;
+    }
+    batch = __atomic_load_n(&sai_fdb_event_batch_size, __ATOMIC_RELAXED);
+    for (index = 0; index < count; index += batch) {
+        on_fdb_event((count - index < batch) ? count - index : batch,
+                     &sai_fdb_event_data[index]);
+    }
+    return pending;
+}
+
+static void *sai_fdb_event_thread_fn(void *arg) {
+    struct timespec deadline;
+    uint32_t msec = 0;
+
+    pthread_mutex_lock(&sai_fdb_event_stop_lock);
+    while (!sai_fdb_event_stopping) {
+        msec = __atomic_load_n(&sai_fdb_event_interval, __ATOMIC_RELAXED);
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += msec / 1000;
+        deadline.tv_nsec += (msec % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&sai_fdb_event_stop_cond, &sai_fdb_event_stop_lock, &deadline);
+        if (sai_fdb_event_stopping) {
+            break;
+        }
+        pthread_mutex_unlock(&sai_fdb_event_stop_lock);
+        while (sai_fdb_event_drain() == SAI_FDB_EVENT_DRAIN_MAX) {
+            // backlog, keep going without sleeping
+        }
+        pthread_mutex_lock(&sai_fdb_event_stop_lock);
+    }
+    pthread_mutex_unlock(&sai_fdb_event_stop_lock);
+    return NULL;
+}
+
+static void sai_fdb_event_learn_cb(
+        switch_api_mac_entry_t *mac_entry) {
+    sai_fdb_event_post(SAI_FDB_EVENT_LEARNED, mac_entry);
+}
+
+static void sai_fdb_event_aging_cb(
+        switch_api_mac_entry_t *mac_entry) {
+    sai_fdb_event_post(SAI_FDB_EVENT_AGED, mac_entry);
+}
+
+/*
+* Routine Description:
+*    Set FDB event delivery interval and batch size
+*
+* Arguments:
+*    [in] interval - delivery interval in msec, 0 keeps the current one
+*    [in] batch_size - max events per on_fdb_event call, 0 keeps the current one
+*
+* Return Values:
+*    SAI_STATUS_SUCCESS on success
+*    Failure status code on error
+*/
+sai_status_t sai_fdb_event_config_set(
+        _In_ uint32_t interval,
+        _In_ uint32_t batch_size) {
+    if (interval) {
+        __atomic_store_n(&sai_fdb_event_interval, interval, __ATOMIC_RELAXED);
+    }
+    if (batch_size) {
+        __atomic_store_n(&sai_fdb_event_batch_size, batch_size, __ATOMIC_RELAXED);
+    }
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+* Routine Description:
+*    Get FDB event delivery interval and batch size
+*
+* Arguments:
+*    [out] interval - delivery interval in msec
+*    [out] batch_size - max events per on_fdb_event call
+*
+* Return Values:
+*    SAI_STATUS_SUCCESS on success
+*/
+sai_status_t sai_fdb_event_config_get(
+        _Out_ uint32_t *interval,
+        _Out_ uint32_t *batch_size) {
+    *interval = __atomic_load_n(&sai_fdb_event_interval, __ATOMIC_RELAXED);
+    *batch_size = __atomic_load_n(&sai_fdb_event_batch_size, __ATOMIC_RELAXED);
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+* Start the delivery thread. Does nothing while it runs, so that both
+* sai_api_initialize and the RPC server start path may call it.
+*/
+sai_status_t sai_fdb_event_initialize(void) {
+    pthread_condattr_t cond_attr;
+    uint32_t index = 0;
+
+    if (sai_fdb_event_running) {
+        return SAI_STATUS_SUCCESS;
+    }
+    for (index = 0; index < SAI_FDB_EVENT_RING_SIZE; index++) {
+        sai_fdb_event_ring.slots[index].sequence = index;
+    }
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&sai_fdb_event_stop_cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+    sai_fdb_event_stopping = false;
+    switch_api_mac_register_learning_callback(&sai_fdb_event_learn_cb);
+    switch_api_mac_register_aging_callback(&sai_fdb_event_aging_cb);
+    if (pthread_create(&sai_fdb_event_thread, NULL, sai_fdb_event_thread_fn, NULL)) {
+        pthread_cond_destroy(&sai_fdb_event_stop_cond);
+        return SAI_STATUS_FAILURE;
+    }
+    sai_fdb_event_running = true;
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+* Stop the delivery thread and wait for it to exit, if it runs. Events
+* still in the ring are not delivered; switchapi callbacks may keep
+* posting into it.
+*/
+void sai_fdb_event_uninitialize(void) {
+    if (!sai_fdb_event_running) {
+        return;
+    }
+    pthread_mutex_lock(&sai_fdb_event_stop_lock);
+    sai_fdb_event_stopping = true;
+    pthread_cond_signal(&sai_fdb_event_stop_cond);
+    pthread_mutex_unlock(&sai_fdb_event_stop_lock);
+    pthread_join(sai_fdb_event_thread, NULL);
+    pthread_cond_destroy(&sai_fdb_event_stop_cond);
+    sai_fdb_event_running = false;
+}
@@ -18,13 +18,42 @@ limitations under the License.
 #include <saitypes.h>
 #include <assert.h>
 #include <switchapi/switch_base_types.h>
+#include <switchapi/switch_l2.h>
 
 #ifndef __SAIINTERNAL_H_
 #define __SAIINTERNAL_H_
 
+/*
+* Switch attributes in the custom range, both u32:
+*   FDB_EVENT_INTERVAL   - msec between on_fdb_event deliveries
+*   FDB_EVENT_BATCH_SIZE - max events passed to one on_fdb_event call
+*/
+#define SAI_SWITCH_ATTR_CUSTOM_FDB_EVENT_INTERVAL       (SAI_SWITCH_ATTR_CUSTOM_RANGE_BASE + 0)
+#define SAI_SWITCH_ATTR_CUSTOM_FDB_EVENT_BATCH_SIZE     (SAI_SWITCH_ATTR_CUSTOM_RANGE_BASE + 1)
+
+/*
+* Locking. The entry points of one SAI API are not reentrant, callers
+* serialize each API (the RPC server keeps one lock per sai_api_t). Where
+* an API works on another API's state, the caller holds both API locks,
+* always acquired in ascending sai_api_t order:
+*   ROUTE, NEXT_HOP_GROUP   - route calls resolve group ids, group
+*                             calls rebind the routes using a group
+*   ROUTE, ROUTER_INTERFACE, NEIGHBOR
+*                           - neighbor calls look up the VRF of a RIF and
+*                             keep drop/trap host routes in the route shadow
+*   NEXT_HOP_GROUP, ACL     - ACL redirects resolve group ids
+* State that is reached outside of any API lock (switchapi callbacks, the
+* FDB event thread) is guarded inside its module instead. Those locks are
+* taken after any API lock and only nest in the order listed:
+*   FDB shadow              - sai_fdb_lock, saifdb.c
+*   VLAN handle table       - atomic loads and stores, saivlan.c
+*   FDB event ring          - lock free, single consumer, saifdbevent.c
+*/
+
 extern switch_device_t device;
 extern sai_switch_notification_t sai_switch_notifications;
 
+sai_status_t sai_initialize(void);
 sai_status_t sai_switch_initialize(sai_api_service_t *sai_api_service);
 sai_status_t sai_port_initialize(sai_api_service_t *sai_api_service);
 sai_status_t sai_fdb_initialize(sai_api_service_t *sai_api_service);
@@ -40,7 +69,119 @@ sai_status_t sai_neighbor_initialize(sai_api_service_t *sai_api_service);
 sai_status_t sai_hostif_initialize(sai_api_service_t *sai_api_service);
 sai_status_t sai_acl_initialize(sai_api_service_t *sai_api_service);
 
-unsigned int sai_v4_prefix_length(sai_ip4_t ip4);
-unsigned int sai_v6_prefix_length(const sai_ip6_t ip6);
+sai_status_t sai_vlan_id_to_handle(
+        _In_ sai_vlan_id_t vlan_id,
+        _Out_ switch_handle_t *vlan_handle);
+sai_status_t sai_vlan_handle_to_id(
+        _In_ switch_handle_t vlan_handle,
+        _Out_ sai_vlan_id_t *vlan_id);
+
+sai_status_t sai_router_interface_vrf_get(
+        _In_ switch_handle_t rif_handle,
+        _Out_ switch_handle_t *vrf_handle);
+
+/*
+* Next hop group ids live above the 32 bit switchapi handle space, so
+* that they can be told apart from next hop handles.
+*/
+#define SAI_NHOP_GROUP_ID_BASE          ((switch_handle_t) 1 << 32)
+
+switch_handle_t sai_next_hop_group_nhop_get(
+        _In_ switch_handle_t next_hop_id);
+sai_status_t sai_next_hop_group_route_ref(
+        _In_ switch_handle_t next_hop_id);
+void sai_next_hop_group_route_unref(
+        _In_ switch_handle_t next_hop_id);
+sai_status_t sai_route_next_hop_rebind(
+        _In_ switch_handle_t next_hop_id);
+sai_status_t sai_route_neighbor_set(
+        _In_ switch_handle_t vrf_handle,
+        _In_ const switch_ip_addr_t *ip_addr,
+        _In_ switch_handle_t nhop_handle);
+
+sai_status_t sai_fdb_aging_time_set(
+        _In_ uint32_t aging_time);
+uint32_t sai_fdb_aging_time_get(void);
+void sai_fdb_vlan_prune(
+        _In_ sai_vlan_id_t vlan_id);
+
+sai_status_t sai_fdb_event_initialize(void);
+void sai_fdb_event_uninitialize(void);
+void sai_fdb_event_post(
+        _In_ sai_fdb_event_t event_type,
+        _In_ const switch_api_mac_entry_t *mac_entry);
+void sai_fdb_event_apply(
+        _In_ uint32_t count,
+        _In_ const sai_fdb_event_notification_data_t *data);
+sai_status_t sai_fdb_event_config_set(
+        _In_ uint32_t interval,
+        _In_ uint32_t batch_size);
+sai_status_t sai_fdb_event_config_get(
+        _Out_ uint32_t *interval,
+        _Out_ uint32_t *batch_size);
+
+int sai_v4_prefix_length(sai_ip4_t ip4);
+int sai_v6_prefix_length(const sai_ip6_t ip6);
+
+sai_status_t sai_bulk_create_fdb_entry(
+        _In_ uint32_t object_count,
+        _In_ const sai_fdb_entry_t *fdb_entry,
+        _In_ const uint32_t *attr_count,
+        _In_ const sai_attribute_t **attr_list,
+        _Out_ sai_status_t *object_statuses);
+sai_status_t sai_bulk_remove_fdb_entry(
+        _In_ uint32_t object_count,
+        _In_ const sai_fdb_entry_t *fdb_entry,
+        _Out_ sai_status_t *object_statuses);
+
+/*
+* One entry of an FDB dump page, see sai_get_fdb_entries().
+*/
+typedef struct _sai_fdb_entry_info_t {
+    sai_fdb_entry_t fdb_entry;
+    sai_fdb_entry_type_t type;
+    sai_object_id_t port_id;
+    sai_packet_action_t packet_action;
+} sai_fdb_entry_info_t;
+
+sai_status_t sai_get_fdb_entries(
+        _In_ uint32_t attr_count,
+        _In_ const sai_attribute_t *attr_list,
+        _In_ const sai_fdb_entry_t *cursor,
+        _Inout_ uint32_t *entry_count,
+        _Out_ sai_fdb_entry_info_t *entries,
+        _Out_ bool *more);
+
+sai_status_t sai_bulk_create_neighbor_entry(
+        _In_ uint32_t object_count,
+        _In_ const sai_neighbor_entry_t *neighbor_entry,
+        _In_ const uint32_t *attr_count,
+        _In_ const sai_attribute_t **attr_list,
+        _Out_ sai_status_t *object_statuses);
+sai_status_t sai_bulk_remove_neighbor_entry(
+        _In_ uint32_t object_count,
+        _In_ const sai_neighbor_entry_t *neighbor_entry,
+        _Out_ sai_status_t *object_statuses);
+sai_status_t sai_bulk_set_neighbor_entry_attribute(
+        _In_ uint32_t object_count,
+        _In_ const sai_neighbor_entry_t *neighbor_entry,
+        _In_ const sai_attribute_t *attr_list,
+        _Out_ sai_status_t *object_statuses);
+
+sai_status_t sai_bulk_create_route_entry(
+        _In_ uint32_t route_count,
+        _In_ const sai_unicast_route_entry_t *unicast_route_entry,
+        _In_ const uint32_t *attr_count,
+        _In_ const sai_attribute_t **attr_list,
+        _Out_ sai_status_t *object_statuses);
+sai_status_t sai_bulk_remove_route_entry(
+        _In_ uint32_t route_count,
+        _In_ const sai_unicast_route_entry_t *unicast_route_entry,
+        _Out_ sai_status_t *object_statuses);
+sai_status_t sai_bulk_set_route_entry_attribute(
+        _In_ uint32_t route_count,
+        _In_ const sai_unicast_route_entry_t *unicast_route_entry,
+        _In_ const sai_attribute_t *attr_list,
+        _Out_ sai_status_t *object_statuses);
 
 #endif  // __SAIINTERNAL_H_
@@ -15,9 +15,12 @@ limitations under the License.
 */
 
 #include <sailag.h>
+#include <stdlib.h>
+#include <string.h>
 #include "saiinternal.h"
 #include "sailog.h"
 #include <switchapi/switch_lag.h>
+#include <tommyds/tommyhashdyn.h>
 
 sai_status_t sai_create_lag_entry(
         _Out_ sai_object_id_t* lag_id,
@@ -35,6 +38,178 @@ sai_status_t sai_add_ports_to_lag(
         _In_ sai_object_id_t lag_id,
         _In_ const sai_object_list_t *port_list);
 
+/*
+* Members of each LAG created through SAI, kept sorted so that a new port
+* list can be diffed against it in one merge pass. Every switchapi member
+* add or delete rewrites the LAG selector in the data plane, so a change
+* only ever sends the ports that actually join or leave.
+*/
+typedef struct _sai_lag_t {
+    tommy_node node;
+    switch_handle_t lag_handle;
+    uint32_t member_count;
+    switch_handle_t *members;           // sorted, as programmed
+} sai_lag_t;
+
+static tommy_hashdyn sai_lags;
+
+static int sai_lag_cmp(const void *arg, const void *obj) {
+    const switch_handle_t *lag_handle = (const switch_handle_t *) arg;
+    const sai_lag_t *lag = (const sai_lag_t *) obj;
+    return *lag_handle != lag->lag_handle;
+}
+
+static sai_lag_t *sai_lag_find(
+        switch_handle_t lag_handle) {
+    return (sai_lag_t *) tommy_hashdyn_search(
+        &sai_lags, sai_lag_cmp, &lag_handle,
+        tommy_hash_u32(0, &lag_handle, sizeof(switch_handle_t)));
+}
+
+static int sai_lag_port_cmp(const void *a, const void *b) {
+    switch_handle_t handle1 = *(const switch_handle_t *) a;
+    switch_handle_t handle2 = *(const switch_handle_t *) b;
+    return (handle1 < handle2) ? -1 : (handle1 > handle2);
+}
+
+/*
+* Move a LAG to the sorted, de-duplicated port list members. Joining ports
+* are added before leaving ports are deleted, so the LAG never runs out of
+* members mid-change; if any call fails the ones already made are undone.
+* On success the LAG takes ownership of members.
+*/
+static sai_status_t sai_lag_apply(
+        sai_lag_t *lag,
+        switch_handle_t *members,
+        uint32_t member_count) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    switch_direction_t direction = SWITCH_API_DIRECTION_BOTH;
+    switch_handle_t *add_list = NULL;
+    switch_handle_t *del_list = NULL;
+    uint32_t add_count = 0, del_count = 0;
+    uint32_t old_index = 0, new_index = 0;
+    uint32_t added = 0, deleted = 0;
+
+    add_list = (switch_handle_t *) malloc(sizeof(switch_handle_t) *
+                                          (member_count + lag->member_count + 1));
+    if (!add_list) {
+        return SAI_STATUS_NO_MEMORY;
+    }
+    del_list = add_list + member_count;
+    while (old_index < lag->member_count || new_index < member_count) {
+        if (new_index == member_count ||
+            (old_index < lag->member_count &&
+             lag->members[old_index] < members[new_index])) {
+            del_list[del_count++] = lag->members[old_index++];
+        } else if (old_index == lag->member_count ||
+                   members[new_index] < lag->members[old_index]) {
+            add_list[add_count++] = members[new_index++];
+        } else {
+            old_index++;
+            new_index++;
+        }
+    }
+
+    for (added = 0; added < add_count; added++) {
+        status = switch_api_lag_member_add(device, lag->lag_handle,
+                                           direction, add_list[added]);
+        if (status != SAI_STATUS_SUCCESS) {
+            break;
+        }
+    }
+    if (status == SAI_STATUS_SUCCESS) {
+        for (deleted = 0; deleted < del_count; deleted++) {
+            status = switch_api_lag_member_delete(device, lag->lag_handle,
+                                                  direction, del_list[deleted]);
+            if (status != SAI_STATUS_SUCCESS) {
+                break;
+            }
+        }
+        if (status != SAI_STATUS_SUCCESS) {
+            while (deleted--) {
+                switch_api_lag_member_add(device, lag->lag_handle,
+                                          direction, del_list[deleted]);
+            }
+        }
+    }
+    if (status != SAI_STATUS_SUCCESS) {
+        while (added--) {
+            switch_api_lag_member_delete(device, lag->lag_handle,
+                                         direction, add_list[added]);
+        }
+        free(add_list);
+        return status;
+    }
+    free(add_list);
+    free(lag->members);
+    lag->members = members;
+    lag->member_count = member_count;
+    return SAI_STATUS_SUCCESS;
+}
+
+typedef enum _sai_lag_members_op_t {
+    SAI_LAG_MEMBERS_SET,                // ports replace the members
+    SAI_LAG_MEMBERS_ADD,                // ports join the members
+    SAI_LAG_MEMBERS_REMOVE,             // ports leave the members
+} sai_lag_members_op_t;
+
+/*
+* Apply a port list given through the SAI API to a LAG in one delta.
+*/
+static sai_status_t sai_lag_set_members(
+        sai_lag_t *lag,
+        const sai_object_list_t *port_list,
+        sai_lag_members_op_t op) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    switch_handle_t *members = NULL;
+    switch_handle_t *ports = NULL;
+    uint32_t port_count = 0, member_count = 0;
+    uint32_t index = 0;
+
+    if (!port_list || (port_list->count && !port_list->list)) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    members = (switch_handle_t *) malloc(sizeof(switch_handle_t) *
+                                         (lag->member_count + port_list->count + 1));
+    if (!members) {
+        return SAI_STATUS_NO_MEMORY;
+    }
+    ports = members + lag->member_count;
+    for (index = 0; index < port_list->count; index++) {
+        ports[index] = (switch_handle_t) port_list->list[index];
+    }
+    port_count = port_list->count;
+    if (op == SAI_LAG_MEMBERS_REMOVE) {
+        qsort(ports, port_count, sizeof(switch_handle_t), sai_lag_port_cmp);
+        for (index = 0; index < lag->member_count; index++) {
+            if (!bsearch(&lag->members[index], ports, port_count,
+                         sizeof(switch_handle_t), sai_lag_port_cmp)) {
+                members[member_count++] = lag->members[index];
+            }
+        }
+    } else {
+        if (op == SAI_LAG_MEMBERS_ADD && lag->member_count) {
+            memcpy(members, lag->members, sizeof(switch_handle_t) * lag->member_count);
+            member_count = lag->member_count;
+        }
+        memmove(&members[member_count], ports, sizeof(switch_handle_t) * port_count);
+        member_count += port_count;
+        qsort(members, member_count, sizeof(switch_handle_t), sai_lag_port_cmp);
+        port_count = member_count;
+        member_count = 0;
+        for (index = 0; index < port_count; index++) {
+            if (!member_count || members[member_count - 1] != members[index]) {
+                members[member_count++] = members[index];
+            }
+        }
+    }
+    status = sai_lag_apply(lag, members, member_count);
+    if (status != SAI_STATUS_SUCCESS) {
+        free(members);
+    }
+    return status;
+}
+
 /*
     \brief Create LAG
     \param[out] lag_id LAG id
@@ -42,6 +217,7 @@ sai_status_t sai_add_ports_to_lag(
     \param[in] attr_list array of attributes
     \return Success: SAI_STATUS_SUCCESS
             Failure: Failure status code on error
+    \note If the PORT_LIST cannot be programmed the LAG is deleted again.
 */
 sai_status_t sai_create_lag_entry(
         _Out_ sai_object_id_t* lag_id,
@@ -52,16 +228,36 @@ sai_status_t sai_create_lag_entry(
 
     sai_status_t status = SAI_STATUS_SUCCESS;
     sai_attribute_t attribute;
+    sai_lag_t *lag = NULL;
     uint32_t index = 0;
-    *lag_id = (sai_object_id_t) switch_api_lag_create(device);
-    for (index = 0; index < attr_count; index++) {
+    lag = (sai_lag_t *) malloc(sizeof(sai_lag_t));
+    if (!lag) {
+        return SAI_STATUS_NO_MEMORY;
+    }
+    memset(lag, 0, sizeof(sai_lag_t));
+    lag->lag_handle = switch_api_lag_create(device);
+    if (lag->lag_handle == SWITCH_API_INVALID_HANDLE) {
+        free(lag);
+        return SAI_STATUS_FAILURE;
+    }
+    for (index = 0; index < attr_count && status == SAI_STATUS_SUCCESS; index++) {
         attribute = attr_list[index];
         switch(attribute.id) {
             case SAI_LAG_ATTR_PORT_LIST:
-                status = sai_add_ports_to_lag(*lag_id, &attr_list[index].value.objlist);
+                status = sai_lag_set_members(lag, &attr_list[index].value.objlist,
+                                             SAI_LAG_MEMBERS_ADD);
                 break;
         }
     }
+    if (status != SAI_STATUS_SUCCESS) {
+        switch_api_lag_delete(device, lag->lag_handle);
+        free(lag->members);
+        free(lag);
+        return status;
+    }
+    tommy_hashdyn_insert(&sai_lags, &lag->node, lag,
+                         tommy_hash_u32(0, &lag->lag_handle, sizeof(switch_handle_t)));
+    *lag_id = (sai_object_id_t) lag->lag_handle;
 
     SAI_LOG_EXIT(SAI_API_LAG);
 
@@ -80,7 +276,14 @@ sai_status_t sai_remove_lag_entry(
     SAI_LOG_ENTER(SAI_API_LAG);
 
     sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_lag_t *lag = NULL;
     status = switch_api_lag_delete(device, (switch_handle_t) lag_id);
+    lag = sai_lag_find((switch_handle_t) lag_id);
+    if (status == SAI_STATUS_SUCCESS && lag) {
+        tommy_hashdyn_remove_existing(&sai_lags, &lag->node);
+        free(lag->members);
+        free(lag);
+    }
 
     SAI_LOG_EXIT(SAI_API_LAG);
 
@@ -93,6 +296,8 @@ sai_status_t sai_remove_lag_entry(
     \param[in] attr Structure containing ID and value to be set
     \return Success: SAI_STATUS_SUCCESS
             Failure: Failure status code on error
+    \note Setting PORT_LIST only adds and deletes the ports that differ,
+          ports that stay in the LAG cost no switchapi call.
 */
 sai_status_t sai_set_lag_entry_attribute(
         _In_ sai_object_id_t lag_id,
@@ -101,6 +306,23 @@ sai_status_t sai_set_lag_entry_attribute(
     SAI_LOG_ENTER(SAI_API_LAG);
 
     sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_lag_t *lag = NULL;
+
+    if (!attr) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    lag = sai_lag_find((switch_handle_t) lag_id);
+    if (!lag) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+    switch (attr->id) {
+        case SAI_LAG_ATTR_PORT_LIST:
+            status = sai_lag_set_members(lag, &attr->value.objlist, SAI_LAG_MEMBERS_SET);
+            break;
+        default:
+            status = SAI_STATUS_NOT_SUPPORTED;
+            break;
+    }
 
     SAI_LOG_EXIT(SAI_API_LAG);
 
@@ -123,6 +345,36 @@ sai_status_t sai_get_lag_entry_attribute(
     SAI_LOG_ENTER(SAI_API_LAG);
 
     sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_attribute_t *attribute;
+    sai_lag_t *lag = NULL;
+    uint32_t index = 0, member = 0;
+
+    if (attr_count && !attr_list) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    lag = sai_lag_find((switch_handle_t) lag_id);
+    if (!lag) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+    for (index = 0; index < attr_count; index++) {
+        attribute = &attr_list[index];
+        switch (attribute->id) {
+            case SAI_LAG_ATTR_PORT_LIST:
+                if (attribute->value.objlist.count < lag->member_count) {
+                    attribute->value.objlist.count = lag->member_count;
+                    status = SAI_STATUS_BUFFER_OVERFLOW;
+                    break;
+                }
+                for (member = 0; member < lag->member_count; member++) {
+                    attribute->value.objlist.list[member] = (sai_object_id_t) lag->members[member];
+                }
+                attribute->value.objlist.count = lag->member_count;
+                break;
+            default:
+                status = SAI_STATUS_NOT_SUPPORTED;
+                break;
+        }
+    }
 
     SAI_LOG_EXIT(SAI_API_LAG);
 
@@ -136,6 +388,9 @@ sai_status_t sai_get_lag_entry_attribute(
     \param[in] port_list pointer to membership structures
     \return Success: SAI_STATUS_SUCCESS
             Failure: Failure status code on error
+    \note Ports already in the LAG are skipped, nothing is added if any
+          port fails. Every new port is still one switchapi call, the
+          delta only saves the calls for ports that are already members.
 */
 sai_status_t sai_add_ports_to_lag(
         _In_ sai_object_id_t lag_id,
@@ -144,14 +399,12 @@ sai_status_t sai_add_ports_to_lag(
     SAI_LOG_ENTER(SAI_API_LAG);
 
     sai_status_t status = SAI_STATUS_SUCCESS;
-    switch_direction_t direction = SWITCH_API_DIRECTION_BOTH;
-    uint32_t index = 0;
-    for (index = 0; index < port_list->count; index++) {
-        status = switch_api_lag_member_add(device,
-                        (switch_handle_t) lag_id,
-                        direction,
-                        port_list->list[index]);
+    sai_lag_t *lag = NULL;
+    lag = sai_lag_find((switch_handle_t) lag_id);
+    if (!lag) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
     }
+    status = sai_lag_set_members(lag, port_list, SAI_LAG_MEMBERS_ADD);
 
     SAI_LOG_EXIT(SAI_API_LAG);
 
@@ -165,6 +418,9 @@ sai_status_t sai_add_ports_to_lag(
     \param[in] port_list pointer to membership structures
     \return Success: SAI_STATUS_SUCCESS
             Failure: Failure status code on error
+    \note Ports not in the LAG are skipped, nothing is removed if any
+          port fails. Every departing port is still one switchapi call,
+          the delta only saves the calls for ports that are not members.
 */
 sai_status_t sai_remove_ports_from_lag(
         _In_ sai_object_id_t lag_id,
@@ -173,14 +429,12 @@ sai_status_t sai_remove_ports_from_lag(
     SAI_LOG_ENTER(SAI_API_LAG);
 
     sai_status_t status = SAI_STATUS_SUCCESS;
-    switch_direction_t direction = SWITCH_API_DIRECTION_BOTH;
-    uint32_t index = 0;
-    for (index = 0; index < port_list->count; index++) {
-        status = switch_api_lag_member_delete(device,
-                        (switch_handle_t) lag_id,
-                        direction,
-                        port_list->list[index]);
+    sai_lag_t *lag = NULL;
+    lag = sai_lag_find((switch_handle_t) lag_id);
+    if (!lag) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
     }
+    status = sai_lag_set_members(lag, port_list, SAI_LAG_MEMBERS_REMOVE);
 
     SAI_LOG_EXIT(SAI_API_LAG);
 
@@ -201,5 +455,6 @@ sai_lag_api_t lag_api = {
 
 sai_status_t sai_lag_initialize(sai_api_service_t *sai_api_service) {
     sai_api_service->lag_api = lag_api;
+    tommy_hashdyn_init(&sai_lags);
     return SAI_STATUS_SUCCESS;
 }
@@ -15,11 +15,15 @@ limitations under the License.
 */
 
 #include <saineighbor.h>
+#include <stdlib.h>
+#include <string.h>
 #include "saiinternal.h"
 #include "sailog.h"
+#include <switchapi/switch_hostif.h>
 #include <switchapi/switch_neighbor.h>
 #include <switchapi/switch_nhop.h>
 #include <arpa/inet.h>
+#include <tommyds/tommyhashdyn.h>
 
 static void sai_neighbor_entry_parse(
         const sai_neighbor_entry_t *neighbor_entry,
@@ -38,12 +42,14 @@ static void sai_neighbor_entry_parse(
     }
 }
 
-static void sai_neighbor_entry_attribute_parse(
+static sai_status_t sai_neighbor_entry_attribute_parse(
         uint32_t attr_count,
         const sai_attribute_t *attr_list,
-        switch_api_neighbor_t *api_neighbor) {
+        switch_api_neighbor_t *api_neighbor,
+        sai_packet_action_t *action) {
     const sai_attribute_t *attribute;
     uint32_t index = 0;
+    *action = SAI_PACKET_ACTION_FORWARD;
     for (index = 0; index < attr_count; index++) {
         attribute = &attr_list[index];
         switch (attribute->id) {
@@ -51,9 +57,19 @@ static void sai_neighbor_entry_attribute_parse(
                 memcpy(&api_neighbor->mac_addr, attribute->value.mac, sizeof(switch_mac_addr_t));
                 break;
             case SAI_NEIGHBOR_ATTR_PACKET_ACTION:
+                switch (attribute->value.s32) {
+                    case SAI_PACKET_ACTION_FORWARD:
+                    case SAI_PACKET_ACTION_DROP:
+                    case SAI_PACKET_ACTION_TRAP:
+                        *action = attribute->value.s32;
+                        break;
+                    default:
+                        return SAI_STATUS_INVALID_PARAMETER;
+                }
                 break;
         }
     }
+    return SAI_STATUS_SUCCESS;
 }
 
 static void sai_neighbor_entry_nexthop_get(
@@ -68,6 +84,278 @@ static void sai_neighbor_entry_nexthop_get(
     api_neighbor->nhop_handle = switch_api_nhop_handle_get(&nhop_key);
 }
 
+/*
+* Shadow of the neighbors created through SAI, keyed by (RIF, IP). It
+* keeps the next hop and neighbor handles resolved at create time so
+* that remove needs no switchapi lookups, and lets ARP/ND refreshes of
+* an unchanged neighbor return without touching switchapi.
+*
+* A forwarding neighbor has its rewrite installed. A DROP or TRAP
+* neighbor has no rewrite; instead a host route for its address in the
+* RIF's VRF points at the CPU next hop for NULL_DROP or GLEAN, the same
+* way routes implement those actions. The host route is owned through
+* the route shadow, see sai_route_neighbor_set(). A neighbor created as DROP before
+* its MAC is known is the "pending resolution" state: the host route
+* keeps traffic for it off the glean path until it is set to FORWARD.
+*/
+typedef struct _sai_neighbor_shadow_key_t {
+    switch_handle_t rif_handle;
+    switch_ip_addr_t ip_addr;
+} sai_neighbor_shadow_key_t;
+
+typedef struct _sai_neighbor_shadow_entry_t {
+    tommy_node node;
+    sai_neighbor_shadow_key_t key;
+    switch_api_neighbor_t api_neighbor;     // with nhop_handle and current MAC
+    sai_packet_action_t action;
+    switch_handle_t neighbor_handle;        // 0 if no rewrite is installed
+    switch_handle_t vrf_handle;             // valid while host_nhop is set
+    switch_handle_t host_nhop;              // CPU next hop of the host route, 0 if none
+} sai_neighbor_shadow_entry_t;
+
+static tommy_hashdyn sai_neighbor_shadow;
+
+static void sai_neighbor_shadow_key_init(
+        sai_neighbor_shadow_key_t *key,
+        const switch_api_neighbor_t *api_neighbor) {
+    // keys are hashed and compared as raw bytes, clear the padding
+    memset(key, 0, sizeof(sai_neighbor_shadow_key_t));
+    key->rif_handle = api_neighbor->interface;
+    memcpy(&key->ip_addr, &api_neighbor->ip_addr, sizeof(switch_ip_addr_t));
+}
+
+static int sai_neighbor_shadow_cmp(const void *arg, const void *obj) {
+    const sai_neighbor_shadow_key_t *key = (const sai_neighbor_shadow_key_t *) arg;
+    const sai_neighbor_shadow_entry_t *entry = (const sai_neighbor_shadow_entry_t *) obj;
+    return memcmp(key, &entry->key, sizeof(sai_neighbor_shadow_key_t));
+}
+
+static sai_neighbor_shadow_entry_t *sai_neighbor_shadow_find(
+        const sai_neighbor_shadow_key_t *key,
+        tommy_hash_t *hash) {
+    *hash = tommy_hash_u32(0, key, sizeof(sai_neighbor_shadow_key_t));
+    return (sai_neighbor_shadow_entry_t *) tommy_hashdyn_search(
+        &sai_neighbor_shadow, sai_neighbor_shadow_cmp, key, *hash);
+}
+
+static sai_status_t sai_neighbor_rewrite_install(
+        sai_neighbor_shadow_entry_t *entry) {
+    switch_handle_t neighbor_handle = 0;
+
+    if (entry->neighbor_handle) {
+        return SAI_STATUS_SUCCESS;
+    }
+    neighbor_handle = switch_api_neighbor_entry_add(device, &entry->api_neighbor);
+    if (neighbor_handle == SWITCH_API_INVALID_HANDLE) {
+        return SAI_STATUS_FAILURE;
+    }
+    entry->neighbor_handle = neighbor_handle;
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t sai_neighbor_rewrite_uninstall(
+        sai_neighbor_shadow_entry_t *entry) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+
+    if (!entry->neighbor_handle) {
+        return SAI_STATUS_SUCCESS;
+    }
+    status = switch_api_neighbor_entry_remove(device, entry->neighbor_handle);
+    if (status == SAI_STATUS_SUCCESS) {
+        entry->neighbor_handle = 0;
+    }
+    return status;
+}
+
+/*
+* Point the neighbor's host route at the CPU next hop for action,
+* adding it or moving it in place. The route is kept in the route
+* shadow, so a route created through the route API for the same
+* prefix takes precedence and cannot be deleted from under us.
+*/
+static sai_status_t sai_neighbor_host_route_install(
+        sai_neighbor_shadow_entry_t *entry,
+        sai_packet_action_t action) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    switch_handle_t nhop_handle = 0;
+
+    nhop_handle = switch_api_cpu_nhop_get((action == SAI_PACKET_ACTION_DROP) ?
+                                          SWITCH_HOSTIF_REASON_CODE_NULL_DROP :
+                                          SWITCH_HOSTIF_REASON_CODE_GLEAN);
+    if (entry->host_nhop == nhop_handle) {
+        return SAI_STATUS_SUCCESS;
+    }
+    if (!entry->host_nhop) {
+        status = sai_router_interface_vrf_get(entry->key.rif_handle, &entry->vrf_handle);
+        if (status != SAI_STATUS_SUCCESS) {
+            return status;
+        }
+    }
+    status = sai_route_neighbor_set(entry->vrf_handle, &entry->key.ip_addr, nhop_handle);
+    if (status == SAI_STATUS_SUCCESS) {
+        entry->host_nhop = nhop_handle;
+    }
+    return status;
+}
+
+static sai_status_t sai_neighbor_host_route_uninstall(
+        sai_neighbor_shadow_entry_t *entry) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+
+    if (!entry->host_nhop) {
+        return SAI_STATUS_SUCCESS;
+    }
+    status = sai_route_neighbor_set(entry->vrf_handle, &entry->key.ip_addr, 0);
+    if (status == SAI_STATUS_SUCCESS) {
+        entry->host_nhop = 0;
+    }
+    return status;
+}
+
+/*
+* Move a neighbor to a new packet action. The new forwarding state is
+* installed before the old one is withdrawn, so a pending neighbor that
+* turns to FORWARD never falls back to glean in between.
+*/
+static sai_status_t sai_neighbor_shadow_action_set(
+        sai_neighbor_shadow_entry_t *entry,
+        sai_packet_action_t action) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+
+    if (entry->action == action) {
+        return SAI_STATUS_SUCCESS;
+    }
+    if (action == SAI_PACKET_ACTION_FORWARD) {
+        status = sai_neighbor_rewrite_install(entry);
+        if (status == SAI_STATUS_SUCCESS) {
+            status = sai_neighbor_host_route_uninstall(entry);
+        }
+    } else {
+        status = sai_neighbor_host_route_install(entry, action);
+        if (status == SAI_STATUS_SUCCESS) {
+            status = sai_neighbor_rewrite_uninstall(entry);
+        }
+    }
+    if (status != SAI_STATUS_SUCCESS) {
+        return status;
+    }
+    entry->action = action;
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+* Point a known neighbor at a new MAC. Without an installed rewrite only
+* the shadow changes. switchapi has no neighbor rewrite update, so an
+* installed rewrite is replaced under the same next hop within this
+* call; if the new one cannot be added the old one is put back. An
+* entry that cannot be restored is dropped from the shadow.
+*/
+static sai_status_t sai_neighbor_shadow_update(
+        sai_neighbor_shadow_entry_t *entry,
+        const switch_mac_addr_t *mac_addr) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    switch_api_neighbor_t api_neighbor;
+    switch_handle_t neighbor_handle = 0;
+
+    if (!memcmp(&entry->api_neighbor.mac_addr, mac_addr, sizeof(switch_mac_addr_t))) {
+        return SAI_STATUS_SUCCESS;
+    }
+    if (!entry->neighbor_handle) {
+        memcpy(&entry->api_neighbor.mac_addr, mac_addr, sizeof(switch_mac_addr_t));
+        return SAI_STATUS_SUCCESS;
+    }
+    status = switch_api_neighbor_entry_remove(device, entry->neighbor_handle);
+    if (status != SAI_STATUS_SUCCESS) {
+        return status;
+    }
+    memcpy(&api_neighbor, &entry->api_neighbor, sizeof(switch_api_neighbor_t));
+    memcpy(&api_neighbor.mac_addr, mac_addr, sizeof(switch_mac_addr_t));
+    neighbor_handle = switch_api_neighbor_entry_add(device, &api_neighbor);
+    if (neighbor_handle == SWITCH_API_INVALID_HANDLE) {
+        neighbor_handle = switch_api_neighbor_entry_add(device, &entry->api_neighbor);
+        if (neighbor_handle == SWITCH_API_INVALID_HANDLE) {
+            SAI_LOG(SAI_LOG_ERROR, SAI_API_NEIGHBOR, "failed to restore neighbor rewrite\n");
+            sai_neighbor_host_route_uninstall(entry);
+            tommy_hashdyn_remove_existing(&sai_neighbor_shadow, &entry->node);
+            free(entry);
+            return SAI_STATUS_FAILURE;
+        }
+        entry->neighbor_handle = neighbor_handle;
+        return SAI_STATUS_FAILURE;
+    }
+    memcpy(&entry->api_neighbor, &api_neighbor, sizeof(switch_api_neighbor_t));
+    entry->neighbor_handle = neighbor_handle;
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+* Program a parsed neighbor. Re-creating a known neighbor updates its
+* MAC and packet action in place, and is a no-op if neither changed.
+*/
+static sai_status_t sai_neighbor_shadow_add(
+        switch_api_neighbor_t *api_neighbor,
+        sai_packet_action_t action) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_neighbor_shadow_key_t key;
+    sai_neighbor_shadow_entry_t *entry = NULL;
+    tommy_hash_t hash;
+
+    sai_neighbor_shadow_key_init(&key, api_neighbor);
+    entry = sai_neighbor_shadow_find(&key, &hash);
+    if (entry) {
+        status = sai_neighbor_shadow_update(entry, &api_neighbor->mac_addr);
+        if (status != SAI_STATUS_SUCCESS) {
+            return status;
+        }
+        return sai_neighbor_shadow_action_set(entry, action);
+    }
+
+    entry = (sai_neighbor_shadow_entry_t *) malloc(sizeof(sai_neighbor_shadow_entry_t));
+    if (!entry) {
+        return SAI_STATUS_NO_MEMORY;
+    }
+    memset(entry, 0, sizeof(sai_neighbor_shadow_entry_t));
+    memcpy(&entry->key, &key, sizeof(sai_neighbor_shadow_key_t));
+    sai_neighbor_entry_nexthop_get(api_neighbor);
+    memcpy(&entry->api_neighbor, api_neighbor, sizeof(switch_api_neighbor_t));
+    entry->action = action;
+    if (action == SAI_PACKET_ACTION_FORWARD) {
+        status = sai_neighbor_rewrite_install(entry);
+    } else {
+        status = sai_neighbor_host_route_install(entry, action);
+    }
+    if (status != SAI_STATUS_SUCCESS) {
+        free(entry);
+        return status;
+    }
+    tommy_hashdyn_insert(&sai_neighbor_shadow, &entry->node, entry, hash);
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t sai_neighbor_shadow_remove(
+        const switch_api_neighbor_t *api_neighbor) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_neighbor_shadow_key_t key;
+    sai_neighbor_shadow_entry_t *entry = NULL;
+    tommy_hash_t hash;
+
+    sai_neighbor_shadow_key_init(&key, api_neighbor);
+    entry = sai_neighbor_shadow_find(&key, &hash);
+    if (!entry) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+    status = sai_neighbor_rewrite_uninstall(entry);
+    if (status == SAI_STATUS_SUCCESS) {
+        status = sai_neighbor_host_route_uninstall(entry);
+    }
+    if (status != SAI_STATUS_SUCCESS) {
+        return status;
+    }
+    tommy_hashdyn_remove_existing(&sai_neighbor_shadow, &entry->node);
+    free(entry);
+    return SAI_STATUS_SUCCESS;
+}
+
 /*
 * Routine Description:
 *    Create neighbor entry 
@@ -92,12 +380,14 @@ sai_status_t sai_create_neighbor_entry(
 
     sai_status_t status = SAI_STATUS_SUCCESS;
     switch_api_neighbor_t api_neighbor;
+    sai_packet_action_t action;
 
     memset(&api_neighbor, 0, sizeof(switch_api_neighbor_t));
     sai_neighbor_entry_parse(neighbor_entry, &api_neighbor);
-    sai_neighbor_entry_attribute_parse(attr_count, attr_list, &api_neighbor);
-    sai_neighbor_entry_nexthop_get(&api_neighbor);
-    switch_api_neighbor_entry_add(device, &api_neighbor);
+    status = sai_neighbor_entry_attribute_parse(attr_count, attr_list, &api_neighbor, &action);
+    if (status == SAI_STATUS_SUCCESS) {
+        status = sai_neighbor_shadow_add(&api_neighbor, action);
+    }
 
     SAI_LOG_EXIT(SAI_API_NEIGHBOR);
 
@@ -124,12 +414,9 @@ sai_status_t sai_remove_neighbor_entry(
 
     sai_status_t status = SAI_STATUS_SUCCESS;
     switch_api_neighbor_t api_neighbor;
-    switch_handle_t neighbor_handle;
     memset(&api_neighbor, 0, sizeof(switch_api_neighbor_t));
     sai_neighbor_entry_parse(neighbor_entry, &api_neighbor);
-    sai_neighbor_entry_nexthop_get(&api_neighbor);
-    neighbor_handle = switch_api_neighbor_handle_get(api_neighbor.nhop_handle);
-    status = switch_api_neighbor_entry_remove(device, neighbor_handle);
+    status = sai_neighbor_shadow_remove(&api_neighbor);
 
     SAI_LOG_EXIT(SAI_API_NEIGHBOR);
 
@@ -147,6 +434,10 @@ sai_status_t sai_remove_neighbor_entry(
 * Return Values:
 *    SAI_STATUS_SUCCESS on success
 *    Failure status code on error
+*
+* Note: a DST_MAC_ADDRESS change replaces the rewrite within this call,
+*       callers no longer need a remove/create pair. A PACKET_ACTION
+*       change installs the new state before withdrawing the old one.
 */
 sai_status_t sai_set_neighbor_entry_attribute(
         _In_ const sai_neighbor_entry_t* neighbor_entry,
@@ -155,6 +446,42 @@ sai_status_t sai_set_neighbor_entry_attribute(
     SAI_LOG_ENTER(SAI_API_NEIGHBOR);
 
     sai_status_t status = SAI_STATUS_SUCCESS;
+    switch_api_neighbor_t api_neighbor;
+    sai_neighbor_shadow_key_t key;
+    sai_neighbor_shadow_entry_t *entry = NULL;
+    tommy_hash_t hash;
+
+    if (!neighbor_entry || !attr) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    memset(&api_neighbor, 0, sizeof(switch_api_neighbor_t));
+    sai_neighbor_entry_parse(neighbor_entry, &api_neighbor);
+    sai_neighbor_shadow_key_init(&key, &api_neighbor);
+    entry = sai_neighbor_shadow_find(&key, &hash);
+    if (!entry) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    switch (attr->id) {
+        case SAI_NEIGHBOR_ATTR_DST_MAC_ADDRESS:
+            status = sai_neighbor_shadow_update(entry, (const switch_mac_addr_t *) attr->value.mac);
+            break;
+        case SAI_NEIGHBOR_ATTR_PACKET_ACTION:
+            switch (attr->value.s32) {
+                case SAI_PACKET_ACTION_FORWARD:
+                case SAI_PACKET_ACTION_DROP:
+                case SAI_PACKET_ACTION_TRAP:
+                    status = sai_neighbor_shadow_action_set(entry, attr->value.s32);
+                    break;
+                default:
+                    status = SAI_STATUS_INVALID_PARAMETER;
+                    break;
+            }
+            break;
+        default:
+            status = SAI_STATUS_NOT_SUPPORTED;
+            break;
+    }
 
     SAI_LOG_EXIT(SAI_API_NEIGHBOR);
 
@@ -173,6 +500,8 @@ sai_status_t sai_set_neighbor_entry_attribute(
 * Return Values:
 *    SAI_STATUS_SUCCESS on success
 *    Failure status code on error
+*
+* Note: answered from the neighbor shadow, switchapi is not consulted.
 */
 sai_status_t sai_get_neighbor_entry_attribute(
         _In_ const sai_neighbor_entry_t* neighbor_entry,
@@ -182,6 +511,177 @@ sai_status_t sai_get_neighbor_entry_attribute(
     SAI_LOG_ENTER(SAI_API_NEIGHBOR);
 
     sai_status_t status = SAI_STATUS_SUCCESS;
+    switch_api_neighbor_t api_neighbor;
+    sai_neighbor_shadow_key_t key;
+    sai_neighbor_shadow_entry_t *entry = NULL;
+    sai_attribute_t *attribute;
+    tommy_hash_t hash;
+    uint32_t index = 0;
+
+    if (!neighbor_entry || (attr_count && !attr_list)) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    memset(&api_neighbor, 0, sizeof(switch_api_neighbor_t));
+    sai_neighbor_entry_parse(neighbor_entry, &api_neighbor);
+    sai_neighbor_shadow_key_init(&key, &api_neighbor);
+    entry = sai_neighbor_shadow_find(&key, &hash);
+    if (!entry) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    for (index = 0; index < attr_count; index++) {
+        attribute = &attr_list[index];
+        switch (attribute->id) {
+            case SAI_NEIGHBOR_ATTR_DST_MAC_ADDRESS:
+                memcpy(attribute->value.mac, &entry->api_neighbor.mac_addr, sizeof(sai_mac_t));
+                break;
+            case SAI_NEIGHBOR_ATTR_PACKET_ACTION:
+                attribute->value.s32 = entry->action;
+                break;
+            default:
+                status = SAI_STATUS_NOT_SUPPORTED;
+                break;
+        }
+    }
+
+    SAI_LOG_EXIT(SAI_API_NEIGHBOR);
+
+    return (sai_status_t) status;
+}
+
+/*
+* Routine Description:
+*    Create neighbor entries in bulk
+*
+* Arguments:
+*    [in] object_count - number of neighbor entries
+*    [in] neighbor_entry - array of neighbor entries
+*    [in] attr_count - number of attributes for each entry
+*    [in] attr_list - array of attribute arrays, one per entry
+*    [out] object_statuses - status of each entry
+*
+* Return Values:
+*    SAI_STATUS_SUCCESS if all entries were created
+*    SAI_STATUS_FAILURE if any entry failed, see object_statuses
+*
+* Note: IP address expected in Network Byte Order.
+*/
+sai_status_t sai_bulk_create_neighbor_entry(
+        _In_ uint32_t object_count,
+        _In_ const sai_neighbor_entry_t *neighbor_entry,
+        _In_ const uint32_t *attr_count,
+        _In_ const sai_attribute_t **attr_list,
+        _Out_ sai_status_t *object_statuses) {
+
+    SAI_LOG_ENTER(SAI_API_NEIGHBOR);
+
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    switch_api_neighbor_t api_neighbor;
+    sai_packet_action_t action;
+    uint32_t index = 0;
+
+    if (!neighbor_entry || !attr_count || !attr_list || !object_statuses) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    for (index = 0; index < object_count; index++) {
+        memset(&api_neighbor, 0, sizeof(switch_api_neighbor_t));
+        sai_neighbor_entry_parse(&neighbor_entry[index], &api_neighbor);
+        object_statuses[index] = sai_neighbor_entry_attribute_parse(
+            attr_count[index], attr_list[index], &api_neighbor, &action);
+        if (object_statuses[index] == SAI_STATUS_SUCCESS) {
+            object_statuses[index] = sai_neighbor_shadow_add(&api_neighbor, action);
+        }
+        if (object_statuses[index] != SAI_STATUS_SUCCESS) {
+            status = SAI_STATUS_FAILURE;
+        }
+    }
+
+    SAI_LOG_EXIT(SAI_API_NEIGHBOR);
+
+    return (sai_status_t) status;
+}
+
+/*
+* Routine Description:
+*    Remove neighbor entries in bulk
+*
+* Arguments:
+*    [in] object_count - number of neighbor entries
+*    [in] neighbor_entry - array of neighbor entries
+*    [out] object_statuses - status of each entry
+*
+* Return Values:
+*    SAI_STATUS_SUCCESS if all entries were removed
+*    SAI_STATUS_FAILURE if any entry failed, see object_statuses
+*
+* Note: IP address expected in Network Byte Order.
+*/
+sai_status_t sai_bulk_remove_neighbor_entry(
+        _In_ uint32_t object_count,
+        _In_ const sai_neighbor_entry_t *neighbor_entry,
+        _Out_ sai_status_t *object_statuses) {
+
+    SAI_LOG_ENTER(SAI_API_NEIGHBOR);
+
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    switch_api_neighbor_t api_neighbor;
+    uint32_t index = 0;
+
+    if (!neighbor_entry || !object_statuses) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    for (index = 0; index < object_count; index++) {
+        memset(&api_neighbor, 0, sizeof(switch_api_neighbor_t));
+        sai_neighbor_entry_parse(&neighbor_entry[index], &api_neighbor);
+        object_statuses[index] = sai_neighbor_shadow_remove(&api_neighbor);
+        if (object_statuses[index] != SAI_STATUS_SUCCESS) {
+            status = SAI_STATUS_FAILURE;
+        }
+    }
+
+    SAI_LOG_EXIT(SAI_API_NEIGHBOR);
+
+    return (sai_status_t) status;
+}
+
+/*
+* Routine Description:
+*    Set neighbor attribute value in bulk
+*
+* Arguments:
+*    [in] object_count - number of neighbor entries
+*    [in] neighbor_entry - array of neighbor entries
+*    [in] attr_list - one attribute per entry
+*    [out] object_statuses - status of each entry
+*
+* Return Values:
+*    SAI_STATUS_SUCCESS if all entries were updated
+*    SAI_STATUS_FAILURE if any entry failed, see object_statuses
+*/
+sai_status_t sai_bulk_set_neighbor_entry_attribute(
+        _In_ uint32_t object_count,
+        _In_ const sai_neighbor_entry_t *neighbor_entry,
+        _In_ const sai_attribute_t *attr_list,
+        _Out_ sai_status_t *object_statuses) {
+
+    SAI_LOG_ENTER(SAI_API_NEIGHBOR);
+
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    uint32_t index = 0;
+
+    if (!neighbor_entry || !attr_list || !object_statuses) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    for (index = 0; index < object_count; index++) {
+        object_statuses[index] = sai_set_neighbor_entry_attribute(
+            &neighbor_entry[index], &attr_list[index]);
+        if (object_statuses[index] != SAI_STATUS_SUCCESS) {
+            status = SAI_STATUS_FAILURE;
+        }
+    }
 
     SAI_LOG_EXIT(SAI_API_NEIGHBOR);
 
@@ -200,5 +700,6 @@ sai_neighbor_api_t neighbor_api = {
 
 sai_status_t sai_neighbor_initialize(sai_api_service_t *sai_api_service) {
     sai_api_service->neighbor_api = neighbor_api;
+    tommy_hashdyn_init(&sai_neighbor_shadow);
     return SAI_STATUS_SUCCESS;
 }
@@ -15,9 +15,12 @@ limitations under the License.
 */
 
 #include <sainexthop.h>
+#include <stdlib.h>
+#include <string.h>
 #include "saiinternal.h"
 #include "sailog.h"
 #include <switchapi/switch_nhop.h>
+#include <tommyds/tommyhashdyn.h>
 
 sai_status_t sai_create_next_hop_group_entry(
         _Out_ sai_object_id_t* next_hop_group_id,
@@ -37,6 +40,416 @@ sai_status_t sai_remove_next_hop_from_group(
         _In_ uint32_t next_hop_count,
         _In_ const sai_object_id_t* nexthops);
 
+// most ECMP members programmed for one group
+#define SAI_NHOP_GROUP_MAX_MEMBERS     4096
+
+/*
+* Membership of a switchapi ECMP group programmed through SAI, kept sorted
+* so that a new member list can be diffed against it in one merge pass.
+*
+* switchapi owns the ECMP member table and where each member lands in it,
+* so SAI cannot pin flows to members: a member change may move flows of
+* members that stayed. Groups are hashed across their members, with no
+* resilient hashing.
+*/
+typedef struct _sai_nhop_group_t {
+    tommy_node node;                    // in sai_nhop_groups
+    tommy_hash_t hash;                  // of members
+    uint32_t ref_count;                 // next hop group ids using it
+    switch_handle_t ecmp_handle;
+    uint32_t member_count;
+    switch_handle_t *members;           // sorted
+} sai_nhop_group_t;
+
+/*
+* A next hop group id handed out through SAI. Groups with the same
+* members share one sai_nhop_group_t, and so one switchapi ECMP group,
+* which is copied when one of its ids is changed.
+*/
+typedef struct _sai_nhop_group_id_t {
+    tommy_node node;
+    switch_handle_t group_id;
+    sai_nhop_group_t *group;
+    uint32_t route_count;               // routes pointing at the id
+} sai_nhop_group_id_t;
+
+typedef struct _sai_nhop_group_key_t {
+    uint32_t member_count;
+    const switch_handle_t *members;
+} sai_nhop_group_key_t;
+
+static tommy_hashdyn sai_nhop_groups;
+static tommy_hashdyn sai_nhop_group_ids;
+static switch_handle_t sai_nhop_group_next_id;
+
+static tommy_hash_t sai_nhop_group_key_hash(
+        const sai_nhop_group_key_t *key) {
+    tommy_hash_t hash = tommy_hash_u32(0, &key->member_count, sizeof(uint32_t));
+    return tommy_hash_u32(hash, key->members, sizeof(switch_handle_t) * key->member_count);
+}
+
+static int sai_nhop_group_cmp(const void *arg, const void *obj) {
+    const sai_nhop_group_key_t *key = (const sai_nhop_group_key_t *) arg;
+    const sai_nhop_group_t *group = (const sai_nhop_group_t *) obj;
+    if (key->member_count != group->member_count) {
+        return 1;
+    }
+    if (!key->member_count) {
+        return 0;
+    }
+    return memcmp(key->members, group->members, sizeof(switch_handle_t) * key->member_count);
+}
+
+static sai_nhop_group_t *sai_nhop_group_find(
+        const sai_nhop_group_key_t *key,
+        tommy_hash_t *hash) {
+    *hash = sai_nhop_group_key_hash(key);
+    return (sai_nhop_group_t *) tommy_hashdyn_search(
+        &sai_nhop_groups, sai_nhop_group_cmp, key, *hash);
+}
+
+static int sai_nhop_group_id_cmp(const void *arg, const void *obj) {
+    const switch_handle_t *group_id = (const switch_handle_t *) arg;
+    const sai_nhop_group_id_t *id = (const sai_nhop_group_id_t *) obj;
+    return *group_id != id->group_id;
+}
+
+static sai_nhop_group_id_t *sai_nhop_group_id_find(
+        switch_handle_t group_id) {
+    return (sai_nhop_group_id_t *) tommy_hashdyn_search(
+        &sai_nhop_group_ids, sai_nhop_group_id_cmp, &group_id,
+        tommy_hash_u32(0, &group_id, sizeof(switch_handle_t)));
+}
+
+static int sai_nhop_handle_cmp(const void *a, const void *b) {
+    switch_handle_t handle1 = *(const switch_handle_t *) a;
+    switch_handle_t handle2 = *(const switch_handle_t *) b;
+    return (handle1 < handle2) ? -1 : (handle1 > handle2);
+}
+
+/*
+* Sort and de-duplicate a member list in place, returns the new count.
+*/
+static uint32_t sai_nhop_list_normalize(
+        switch_handle_t *list,
+        uint32_t count) {
+    uint32_t index = 0, unique = 0;
+
+    qsort(list, count, sizeof(switch_handle_t), sai_nhop_handle_cmp);
+    for (index = 0; index < count; index++) {
+        if (!unique || list[unique - 1] != list[index]) {
+            list[unique++] = list[index];
+        }
+    }
+    return unique;
+}
+
+/*
+* Move the ECMP members of a group from the sorted list old_list to the
+* sorted list new_list. Only the delta reaches switchapi: new members are
+* added before departed members are deleted, so traffic never sees a
+* group that lacks both the old and the new member set. If the delete
+* fails the additions are rolled back.
+*/
+static sai_status_t sai_nhop_group_program(
+        sai_nhop_group_t *group,
+        const switch_handle_t *old_list,
+        uint32_t old_count,
+        const switch_handle_t *new_list,
+        uint32_t new_count) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    switch_handle_t *add_list = NULL;
+    switch_handle_t *del_list = NULL;
+    uint32_t add_count = 0, del_count = 0;
+    uint32_t old_index = 0, new_index = 0;
+
+    add_list = (switch_handle_t *) malloc(sizeof(switch_handle_t) *
+                                          (new_count + old_count + 1));
+    if (!add_list) {
+        return SAI_STATUS_NO_MEMORY;
+    }
+    del_list = add_list + new_count;
+    while (old_index < old_count || new_index < new_count) {
+        if (new_index == new_count ||
+            (old_index < old_count &&
+             old_list[old_index] < new_list[new_index])) {
+            del_list[del_count++] = old_list[old_index++];
+        } else if (old_index == old_count ||
+                   new_list[new_index] < old_list[old_index]) {
+            add_list[add_count++] = new_list[new_index++];
+        } else {
+            old_index++;
+            new_index++;
+        }
+    }
+
+    if (add_count) {
+        status = switch_api_ecmp_member_add(device, group->ecmp_handle,
+                                            add_count, add_list);
+    }
+    if (status == SAI_STATUS_SUCCESS && del_count) {
+        status = switch_api_ecmp_member_delete(device, group->ecmp_handle,
+                                               del_count, del_list);
+        if (status != SAI_STATUS_SUCCESS && add_count) {
+            switch_api_ecmp_member_delete(device, group->ecmp_handle,
+                                          add_count, add_list);
+        }
+    }
+    free(add_list);
+    return status;
+}
+
+/*
+* Move a group to the sorted, de-duplicated member list members, only
+* the change in members is programmed. On success the group takes
+* ownership of members.
+*/
+static sai_status_t sai_nhop_group_apply(
+        sai_nhop_group_t *group,
+        switch_handle_t *members,
+        uint32_t member_count) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+
+    if (member_count > SAI_NHOP_GROUP_MAX_MEMBERS) {
+        return SAI_STATUS_INSUFFICIENT_RESOURCES;
+    }
+    status = sai_nhop_group_program(group, group->members, group->member_count,
+                                    members, member_count);
+    if (status != SAI_STATUS_SUCCESS) {
+        return status;
+    }
+    free(group->members);
+    group->members = members;
+    group->member_count = member_count;
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+* Return a group programmed with members, with one more reference,
+* sharing an existing group with the same members when there is one.
+* Always consumes members.
+*/
+static sai_status_t sai_nhop_group_get(
+        switch_handle_t *members,
+        uint32_t member_count,
+        sai_nhop_group_t **group_out) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_nhop_group_key_t key = { member_count, members };
+    sai_nhop_group_t *group = NULL;
+    tommy_hash_t hash;
+
+    group = sai_nhop_group_find(&key, &hash);
+    if (group) {
+        free(members);
+        group->ref_count++;
+        *group_out = group;
+        return SAI_STATUS_SUCCESS;
+    }
+    group = (sai_nhop_group_t *) malloc(sizeof(sai_nhop_group_t));
+    if (!group) {
+        free(members);
+        return SAI_STATUS_NO_MEMORY;
+    }
+    memset(group, 0, sizeof(sai_nhop_group_t));
+    group->ecmp_handle = switch_api_ecmp_create(device);
+    if (group->ecmp_handle == SWITCH_API_INVALID_HANDLE) {
+        status = SAI_STATUS_INSUFFICIENT_RESOURCES;
+    } else {
+        status = sai_nhop_group_apply(group, members, member_count);
+        if (status != SAI_STATUS_SUCCESS) {
+            switch_api_ecmp_delete(device, group->ecmp_handle);
+        }
+    }
+    if (status != SAI_STATUS_SUCCESS) {
+        free(group);
+        free(members);
+        return status;
+    }
+    group->ref_count = 1;
+    group->hash = hash;
+    tommy_hashdyn_insert(&sai_nhop_groups, &group->node, group, hash);
+    *group_out = group;
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+* Drop a reference to a group, deleting its ECMP group with the last one.
+*/
+static sai_status_t sai_nhop_group_release(
+        sai_nhop_group_t *group) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+
+    if (group->ref_count > 1) {
+        group->ref_count--;
+        return SAI_STATUS_SUCCESS;
+    }
+    status = switch_api_ecmp_delete(device, group->ecmp_handle);
+    if (status != SAI_STATUS_SUCCESS) {
+        return status;
+    }
+    tommy_hashdyn_remove_existing(&sai_nhop_groups, &group->node);
+    free(group->members);
+    free(group);
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+* Point a next hop group id at group, which already counts the reference,
+* and move the routes using the id over before the previous group is
+* released. If a route cannot be moved the id is left where it was.
+*/
+static sai_status_t sai_nhop_group_id_move(
+        sai_nhop_group_id_t *id,
+        sai_nhop_group_t *group) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_nhop_group_t *previous = id->group;
+
+    id->group = group;
+    status = sai_route_next_hop_rebind(id->group_id);
+    if (status != SAI_STATUS_SUCCESS) {
+        id->group = previous;
+        sai_route_next_hop_rebind(id->group_id);
+        sai_nhop_group_release(group);
+        return status;
+    }
+    sai_nhop_group_release(previous);
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+* Move a next hop group id to new members. A group only this id uses is
+* changed in place. Otherwise the id joins the group that already has the
+* new members, or gets a copy of its own, and its routes follow. Always
+* consumes members.
+*/
+static sai_status_t sai_nhop_group_id_update(
+        sai_nhop_group_id_t *id,
+        switch_handle_t *members,
+        uint32_t member_count) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_nhop_group_key_t key = { member_count, members };
+    sai_nhop_group_t *group = id->group;
+    sai_nhop_group_t *target = NULL;
+    tommy_hash_t hash;
+
+    target = sai_nhop_group_find(&key, &hash);
+    if (target == group) {
+        status = SAI_STATUS_SUCCESS;
+    } else if (!target && group->ref_count == 1) {
+        tommy_hashdyn_remove_existing(&sai_nhop_groups, &group->node);
+        status = sai_nhop_group_apply(group, members, member_count);
+        if (status == SAI_STATUS_SUCCESS) {
+            group->hash = hash;
+        }
+        tommy_hashdyn_insert(&sai_nhop_groups, &group->node, group, group->hash);
+    } else {
+        status = sai_nhop_group_get(members, member_count, &target);
+        if (status != SAI_STATUS_SUCCESS) {
+            return status;
+        }
+        return sai_nhop_group_id_move(id, target);
+    }
+    if (status != SAI_STATUS_SUCCESS || group->members != members) {
+        free(members);
+    }
+    return status;
+}
+
+/*
+* Turn an unsorted member list given through the SAI API into the sorted,
+* de-duplicated members of a group.
+*/
+static sai_status_t sai_nhop_group_list_build(
+        uint32_t next_hop_count,
+        const sai_object_id_t *nexthops,
+        switch_handle_t **members_out,
+        uint32_t *member_count) {
+    switch_handle_t *members = NULL;
+    uint32_t index = 0;
+
+    if (next_hop_count && !nexthops) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    members = (switch_handle_t *) malloc(sizeof(switch_handle_t) * (next_hop_count + 1));
+    if (!members) {
+        return SAI_STATUS_NO_MEMORY;
+    }
+    for (index = 0; index < next_hop_count; index++) {
+        members[index] = (switch_handle_t) nexthops[index];
+    }
+    *members_out = members;
+    *member_count = sai_nhop_list_normalize(members, next_hop_count);
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+* Apply an unsorted member list given through the SAI API to a group id.
+*/
+static sai_status_t sai_nhop_group_set_members(
+        sai_nhop_group_id_t *id,
+        uint32_t next_hop_count,
+        const sai_object_id_t *nexthops) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    switch_handle_t *members = NULL;
+    uint32_t member_count = 0;
+
+    status = sai_nhop_group_list_build(next_hop_count, nexthops,
+                                       &members, &member_count);
+    if (status != SAI_STATUS_SUCCESS) {
+        return status;
+    }
+    return sai_nhop_group_id_update(id, members, member_count);
+}
+
+/*
+* Hardware next hop behind a next hop id: the ECMP group currently used by
+* a next hop group id, 0 for an id in the group range that is not known,
+* any other id is returned unchanged.
+*/
+switch_handle_t sai_next_hop_group_nhop_get(
+        _In_ switch_handle_t next_hop_id) {
+    sai_nhop_group_id_t *id = NULL;
+
+    if (next_hop_id < SAI_NHOP_GROUP_ID_BASE) {
+        return next_hop_id;
+    }
+    id = sai_nhop_group_id_find(next_hop_id);
+    return id ? id->group->ecmp_handle : 0;
+}
+
+/*
+* Count a route pointing at next_hop_id, so that a group in use cannot be
+* removed. Fails for an unknown next hop group id; any other id is not
+* tracked.
+*/
+sai_status_t sai_next_hop_group_route_ref(
+        _In_ switch_handle_t next_hop_id) {
+    sai_nhop_group_id_t *id = NULL;
+
+    if (next_hop_id < SAI_NHOP_GROUP_ID_BASE) {
+        return SAI_STATUS_SUCCESS;
+    }
+    id = sai_nhop_group_id_find(next_hop_id);
+    if (!id) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    id->route_count++;
+    return SAI_STATUS_SUCCESS;
+}
+
+void sai_next_hop_group_route_unref(
+        _In_ switch_handle_t next_hop_id) {
+    sai_nhop_group_id_t *id = NULL;
+
+    if (next_hop_id < SAI_NHOP_GROUP_ID_BASE) {
+        return;
+    }
+    id = sai_nhop_group_id_find(next_hop_id);
+    if (id && id->route_count) {
+        id->route_count--;
+    }
+}
+
 /*
 * Routine Description:
 *    Create next hop group
@@ -58,27 +471,47 @@ sai_status_t sai_create_next_hop_group_entry(
     SAI_LOG_ENTER(SAI_API_NEXT_HOP_GROUP);
 
     sai_status_t status = SAI_STATUS_SUCCESS;
-    sai_attribute_t attribute;
-    sai_object_id_t *nhop_list;
-    uint32_t nhop_count = 0;
+    const sai_attribute_t *attribute;
+    const sai_attribute_t *next_hop_list = NULL;
+    sai_nhop_group_id_t *id = NULL;
+    switch_handle_t *members = NULL;
+    uint32_t member_count = 0;
     uint32_t index = 0;
-    *next_hop_group_id = (sai_object_id_t) switch_api_ecmp_create(device);
+
     for (index = 0; index < attr_count; index++) {
-        attribute = attr_list[index];
-        switch(attribute.id) {
+        attribute = &attr_list[index];
+        switch(attribute->id) {
             case SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_COUNT:
             case SAI_NEXT_HOP_GROUP_ATTR_TYPE:
                 break;
             case SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_LIST:
-                nhop_list = attribute.value.objlist.list;
-                nhop_count = attribute.value.objlist.count;
-                status = sai_add_next_hop_to_group(*next_hop_group_id,
-                                          nhop_count,
-                                          nhop_list);
+                next_hop_list = attribute;
                 break;
         }
     }
 
+    status = sai_nhop_group_list_build(next_hop_list ? next_hop_list->value.objlist.count : 0,
+                                       next_hop_list ? next_hop_list->value.objlist.list : NULL,
+                                       &members, &member_count);
+    if (status != SAI_STATUS_SUCCESS) {
+        return status;
+    }
+    id = (sai_nhop_group_id_t *) malloc(sizeof(sai_nhop_group_id_t));
+    if (!id) {
+        free(members);
+        return SAI_STATUS_NO_MEMORY;
+    }
+    status = sai_nhop_group_get(members, member_count, &id->group);
+    if (status != SAI_STATUS_SUCCESS) {
+        free(id);
+        return status;
+    }
+    id->route_count = 0;
+    id->group_id = sai_nhop_group_next_id++;
+    tommy_hashdyn_insert(&sai_nhop_group_ids, &id->node, id,
+                         tommy_hash_u32(0, &id->group_id, sizeof(switch_handle_t)));
+    *next_hop_group_id = (sai_object_id_t) id->group_id;
+
     SAI_LOG_EXIT(SAI_API_NEXT_HOP_GROUP);
 
     return (sai_status_t) status;
@@ -93,6 +526,7 @@ sai_status_t sai_create_next_hop_group_entry(
 *
 * Return Values:
 *    SAI_STATUS_SUCCESS on success
+*    SAI_STATUS_OBJECT_IN_USE if a route still points at the group
 *    Failure status code on error
 */
 sai_status_t sai_remove_next_hop_group_entry(
@@ -101,7 +535,20 @@ sai_status_t sai_remove_next_hop_group_entry(
     SAI_LOG_ENTER(SAI_API_NEXT_HOP_GROUP);
 
     sai_status_t status = SAI_STATUS_SUCCESS;
-    status = switch_api_ecmp_delete(device, (switch_handle_t) next_hop_group_id);
+    sai_nhop_group_id_t *id = NULL;
+
+    id = sai_nhop_group_id_find((switch_handle_t) next_hop_group_id);
+    if (!id) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+    if (id->route_count) {
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+    status = sai_nhop_group_release(id->group);
+    if (status == SAI_STATUS_SUCCESS) {
+        tommy_hashdyn_remove_existing(&sai_nhop_group_ids, &id->node);
+        free(id);
+    }
 
     SAI_LOG_EXIT(SAI_API_NEXT_HOP_GROUP);
 
@@ -119,6 +566,11 @@ sai_status_t sai_remove_next_hop_group_entry(
 * Return Values:
 *    SAI_STATUS_SUCCESS on success
 *    Failure status code on error
+*
+* Note: setting NEXT_HOP_LIST only adds and deletes the members that
+*       differ, new members first. Duplicate next hops are ignored.
+*       switchapi decides where members sit in the ECMP table, so flows
+*       of members that stay may still move.
 */
 sai_status_t sai_set_next_hop_group_entry_attribute(
         _In_ sai_object_id_t next_hop_group_id,
@@ -127,6 +579,25 @@ sai_status_t sai_set_next_hop_group_entry_attribute(
     SAI_LOG_ENTER(SAI_API_NEXT_HOP_GROUP);
 
     sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_nhop_group_id_t *id = NULL;
+
+    if (!attr) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    id = sai_nhop_group_id_find((switch_handle_t) next_hop_group_id);
+    if (!id) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+    switch (attr->id) {
+        case SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_LIST:
+            status = sai_nhop_group_set_members(id,
+                                                attr->value.objlist.count,
+                                                attr->value.objlist.list);
+            break;
+        default:
+            status = SAI_STATUS_NOT_SUPPORTED;
+            break;
+    }
 
     SAI_LOG_EXIT(SAI_API_NEXT_HOP_GROUP);
 
@@ -154,6 +625,44 @@ sai_status_t sai_get_next_hop_group_entry_attribute(
     SAI_LOG_ENTER(SAI_API_NEXT_HOP_GROUP);
 
     sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_nhop_group_id_t *id = NULL;
+    sai_nhop_group_t *group = NULL;
+    sai_attribute_t *attribute;
+    uint32_t index = 0, member = 0;
+
+    if (attr_count && !attr_list) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    id = sai_nhop_group_id_find((switch_handle_t) next_hop_group_id);
+    if (!id) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+    group = id->group;
+    for (index = 0; index < attr_count; index++) {
+        attribute = &attr_list[index];
+        switch (attribute->id) {
+            case SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_COUNT:
+                attribute->value.u32 = group->member_count;
+                break;
+            case SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_LIST:
+                if (attribute->value.objlist.count < group->member_count) {
+                    attribute->value.objlist.count = group->member_count;
+                    status = SAI_STATUS_BUFFER_OVERFLOW;
+                    break;
+                }
+                for (member = 0; member < group->member_count; member++) {
+                    attribute->value.objlist.list[member] = (sai_object_id_t) group->members[member];
+                }
+                attribute->value.objlist.count = group->member_count;
+                break;
+            case SAI_NEXT_HOP_GROUP_ATTR_TYPE:
+                attribute->value.u8 = SAI_NEXT_HOP_GROUP_ECMP;
+                break;
+            default:
+                status = SAI_STATUS_NOT_SUPPORTED;
+                break;
+        }
+    }
 
     SAI_LOG_EXIT(SAI_API_NEXT_HOP_GROUP);
 
@@ -178,10 +687,30 @@ sai_status_t sai_add_next_hop_to_group(
         _In_ uint32_t next_hop_count,
         _In_ const sai_object_id_t* nexthops) {
     sai_status_t status = SAI_STATUS_SUCCESS;
-    status = switch_api_ecmp_member_add(device,
-                                  (switch_handle_t) next_hop_group_id,
-                                  next_hop_count,
-                                  (switch_handle_t *) nexthops);
+    sai_nhop_group_id_t *id = NULL;
+    sai_nhop_group_t *group = NULL;
+    sai_object_id_t *list = NULL;
+    uint32_t index = 0;
+
+    id = sai_nhop_group_id_find((switch_handle_t) next_hop_group_id);
+    if (!id) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+    group = id->group;
+    if (next_hop_count && !nexthops) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    list = (sai_object_id_t *) malloc(sizeof(sai_object_id_t) *
+                                      (group->member_count + next_hop_count + 1));
+    if (!list) {
+        return SAI_STATUS_NO_MEMORY;
+    }
+    for (index = 0; index < group->member_count; index++) {
+        list[index] = (sai_object_id_t) group->members[index];
+    }
+    memcpy(&list[group->member_count], nexthops, sizeof(sai_object_id_t) * next_hop_count);
+    status = sai_nhop_group_set_members(id, group->member_count + next_hop_count, list);
+    free(list);
     return (sai_status_t) status;
 }
 
@@ -203,10 +732,42 @@ sai_status_t sai_remove_next_hop_from_group(
         _In_ uint32_t next_hop_count,
         _In_ const sai_object_id_t* nexthops) {
     sai_status_t status = SAI_STATUS_SUCCESS;
-    status = switch_api_ecmp_member_delete(device,
-                                  (switch_handle_t) next_hop_group_id,
-                                  next_hop_count,
-                                  (switch_handle_t *) nexthops);
+    sai_nhop_group_id_t *id = NULL;
+    sai_nhop_group_t *group = NULL;
+    sai_object_id_t *list = NULL;
+    switch_handle_t *removed = NULL;
+    uint32_t removed_count = 0;
+    uint32_t count = 0;
+    uint32_t index = 0;
+
+    id = sai_nhop_group_id_find((switch_handle_t) next_hop_group_id);
+    if (!id) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+    group = id->group;
+    if (next_hop_count && !nexthops) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    list = (sai_object_id_t *) malloc(sizeof(sai_object_id_t) * (group->member_count + 1));
+    removed = (switch_handle_t *) malloc(sizeof(switch_handle_t) * (next_hop_count + 1));
+    if (!list || !removed) {
+        free(list);
+        free(removed);
+        return SAI_STATUS_NO_MEMORY;
+    }
+    for (index = 0; index < next_hop_count; index++) {
+        removed[index] = (switch_handle_t) nexthops[index];
+    }
+    removed_count = sai_nhop_list_normalize(removed, next_hop_count);
+    for (index = 0; index < group->member_count; index++) {
+        if (!bsearch(&group->members[index], removed, removed_count,
+                     sizeof(switch_handle_t), sai_nhop_handle_cmp)) {
+            list[count++] = (sai_object_id_t) group->members[index];
+        }
+    }
+    status = sai_nhop_group_set_members(id, count, list);
+    free(list);
+    free(removed);
     return (sai_status_t) status;
 }
 
@@ -224,5 +785,8 @@ sai_next_hop_group_api_t nhop_group_api = {
 
 sai_status_t sai_next_hop_group_initialize(sai_api_service_t *sai_api_service) {
     sai_api_service->nhop_group_api = nhop_group_api;
+    tommy_hashdyn_init(&sai_nhop_groups);
+    tommy_hashdyn_init(&sai_nhop_group_ids);
+    sai_nhop_group_next_id = SAI_NHOP_GROUP_ID_BASE;
     return SAI_STATUS_SUCCESS;
 }
@@ -43,7 +43,7 @@ sai_status_t sai_set_port_attribute(
     if(attr) {
         switch(attr->id) {
             case SAI_PORT_ATTR_DEFAULT_VLAN:
-                status = switch_api_vlan_id_to_handle_get((switch_vlan_t) attr->value.u16, &vlan_handle);
+                status = sai_vlan_id_to_handle(attr->value.u16, &vlan_handle);
                 switch_port.handle = (switch_handle_t)port_id;
                 switch_port.tagging_mode = SWITCH_VLAN_PORT_UNTAGGED;
                 status = switch_api_vlan_ports_add(device, vlan_handle, 1, &switch_port);
@@ -20,57 +20,75 @@ limitations under the License.
 #include <switchapi/switch_l3.h>
 #include <switchapi/switch_hostif.h>
 #include <arpa/inet.h>
+#include <endian.h>
+#include <tommyds/tommyhashdyn.h>
 
-unsigned int sai_v4_prefix_length(sai_ip4_t ip4)  {
-    int x = 0;
-    unsigned int prefix_length = 0;
-    while (ip4) {
-        x = ip4 & 0x1;
-        if (x) prefix_length++;
-        ip4 = ip4 >> 1;
-    }
-    return prefix_length;
-}
-
-unsigned int sai_v6_prefix_length(const sai_ip6_t ip6)  {
-    int i = 0, x = 0;
-    unsigned int prefix_length = 0;
-    sai_ip6_t ip6_temp;
-    memcpy(ip6_temp, ip6, 16);
-    for (i = 0; i < 16; i++) {
-        if (ip6_temp[i] == 0xFF) {
-            prefix_length += 8;
-        } else {
-            while (ip6_temp[i]) {
-                x = ip6_temp[i] & 0x1;
-                if (x) prefix_length++;
-                ip6_temp[i] = ip6_temp[i] >> 1;
-            }
-        }
+/*
+* Prefix length of a host order v4 mask. The mask is contiguous exactly when
+* its complement plus one is a power of two (or zero for a /0).
+*
+* Returns -1 if the mask is not contiguous.
+*/
+int sai_v4_prefix_length(sai_ip4_t ip4)  {
+    uint32_t inverse = ~ip4;
+    if (inverse & (inverse + 1)) {
+        return -1;
+    }
+    return __builtin_popcount(ip4);
+}
+
+/*
+* Prefix length of a v6 mask in network byte order, computed on two 64 bit
+* halves. The low half may only be non zero if the high half is all ones.
+*
+* Returns -1 if the mask is not contiguous.
+*/
+int sai_v6_prefix_length(const sai_ip6_t ip6)  {
+    uint64_t high, low;
+    uint64_t inverse_high, inverse_low;
+    memcpy(&high, &ip6[0], sizeof(high));
+    memcpy(&low, &ip6[8], sizeof(low));
+    high = be64toh(high);
+    low = be64toh(low);
+    inverse_high = ~high;
+    inverse_low = ~low;
+    if ((inverse_high & (inverse_high + 1)) ||
+        (inverse_low & (inverse_low + 1)) ||
+        (inverse_high && low)) {
+        return -1;
     }
-    return prefix_length;
+    return __builtin_popcountll(high) + __builtin_popcountll(low);
 }
 
-static void sai_route_entry_parse(
+static sai_status_t sai_route_entry_parse(
         const sai_unicast_route_entry_t* unicast_route_entry,
         switch_handle_t *vrf_handle,
         switch_ip_addr_t *ip_addr) {
-    unsigned int prefix_length = 0;
+    int prefix_length = 0;
     const sai_ip_prefix_t *sai_ip_addr;
     memset(ip_addr, 0, sizeof(switch_ip_addr_t));
     sai_ip_addr = &unicast_route_entry->destination;
     *vrf_handle = (switch_handle_t) unicast_route_entry->vr_id;
     if (sai_ip_addr->addr_family == SAI_IP_ADDR_FAMILY_IPV4) {
         prefix_length = sai_v4_prefix_length(ntohl(sai_ip_addr->mask.ip4));
+        if (prefix_length < 0) {
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
         ip_addr->type = SWITCH_API_IP_ADDR_V4;
         ip_addr->ip.v4addr = ntohl(sai_ip_addr->addr.ip4);
         ip_addr->prefix_len = prefix_length;
     } else if (sai_ip_addr->addr_family == SAI_IP_ADDR_FAMILY_IPV6) {
         prefix_length = sai_v6_prefix_length(sai_ip_addr->mask.ip6);
+        if (prefix_length < 0) {
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
         ip_addr->type = SWITCH_API_IP_ADDR_V6;
         memcpy(ip_addr->ip.v6addr, sai_ip_addr->addr.ip6, 16);
         ip_addr->prefix_len = prefix_length;
+    } else {
+        return SAI_STATUS_INVALID_PARAMETER;
     }
+    return SAI_STATUS_SUCCESS;
 }
 
 static void sai_route_entry_attribute_parse(
@@ -96,6 +114,299 @@ static void sai_route_entry_attribute_parse(
     }
 }
 
+/*
+* DROP and TRAP take precedence over NEXT_HOP_ID: a route carrying both
+* points at the CPU next hop, and falls back to its next hop once the
+* action is set back to FORWARD.
+*/
+static switch_handle_t sai_route_entry_nhop_resolve(
+        switch_handle_t nhop_handle,
+        int action) {
+    switch(action) {
+        case SAI_PACKET_ACTION_DROP:
+            return switch_api_cpu_nhop_get(SWITCH_HOSTIF_REASON_CODE_NULL_DROP);
+        case SAI_PACKET_ACTION_TRAP:
+            // set the nhop_handle to the cpu nhop
+            return switch_api_cpu_nhop_get(SWITCH_HOSTIF_REASON_CODE_GLEAN);
+        default:
+            break;
+    }
+    return sai_next_hop_group_nhop_get(nhop_handle);
+}
+
+/*
+* Shadow copy of the routes programmed through SAI, keyed by VRF and prefix.
+* Routing daemons re-send identical routes on session resets; the shadow
+* lets those return without touching switchapi, turns a next hop change
+* into a single update and answers get_route_attribute locally.
+*
+* Host routes that the neighbor layer installs for DROP and TRAP neighbors
+* live in the same shadow, so that both owners of a prefix see each other.
+* A route created through the route API takes precedence over the host
+* route, which is programmed again once that route is removed. Entries
+* that only carry a host route are invisible to the route API.
+*/
+typedef struct _sai_route_shadow_key_t {
+    switch_handle_t vrf_handle;
+    switch_ip_addr_t ip_addr;
+} sai_route_shadow_key_t;
+
+typedef struct _sai_route_shadow_entry_t {
+    tommy_node node;
+    sai_route_shadow_key_t key;
+    bool user;                          // created through the route API
+    switch_handle_t next_hop_id;        // next hop as requested
+    int action;                         // -1 if not specified
+    int pri;                            // -1 if not specified
+    switch_handle_t host_nhop;          // next hop of a neighbor host route, 0 if none
+    switch_handle_t nhop_handle;        // next hop in hardware, 0 if none
+} sai_route_shadow_entry_t;
+
+static tommy_hashdyn sai_route_shadow;
+
+static void sai_route_shadow_key_init(
+        sai_route_shadow_key_t *key,
+        switch_handle_t vrf_handle,
+        const switch_ip_addr_t *ip_addr) {
+    // keys are hashed and compared as raw bytes, clear the padding
+    memset(key, 0, sizeof(sai_route_shadow_key_t));
+    key->vrf_handle = vrf_handle;
+    memcpy(&key->ip_addr, ip_addr, sizeof(switch_ip_addr_t));
+}
+
+static int sai_route_shadow_cmp(const void *arg, const void *obj) {
+    const sai_route_shadow_key_t *key = (const sai_route_shadow_key_t *) arg;
+    const sai_route_shadow_entry_t *entry = (const sai_route_shadow_entry_t *) obj;
+    return memcmp(key, &entry->key, sizeof(sai_route_shadow_key_t));
+}
+
+static sai_route_shadow_entry_t *sai_route_shadow_find(
+        const sai_route_shadow_key_t *key,
+        tommy_hash_t *hash) {
+    *hash = tommy_hash_u32(0, key, sizeof(sai_route_shadow_key_t));
+    return (sai_route_shadow_entry_t *) tommy_hashdyn_search(
+        &sai_route_shadow, sai_route_shadow_cmp, key, *hash);
+}
+
+static sai_route_shadow_entry_t *sai_route_shadow_insert(
+        const sai_route_shadow_key_t *key,
+        tommy_hash_t hash) {
+    sai_route_shadow_entry_t *entry = NULL;
+
+    entry = (sai_route_shadow_entry_t *) malloc(sizeof(sai_route_shadow_entry_t));
+    if (!entry) {
+        return NULL;
+    }
+    memset(entry, 0, sizeof(sai_route_shadow_entry_t));
+    memcpy(&entry->key, key, sizeof(sai_route_shadow_key_t));
+    entry->action = -1;
+    entry->pri = -1;
+    tommy_hashdyn_insert(&sai_route_shadow, &entry->node, entry, hash);
+    return entry;
+}
+
+/*
+* Drop an entry that no longer has an owner. Its route must already be
+* gone from hardware.
+*/
+static void sai_route_shadow_release(
+        sai_route_shadow_entry_t *entry) {
+    if (entry->user || entry->host_nhop) {
+        return;
+    }
+    tommy_hashdyn_remove_existing(&sai_route_shadow, &entry->node);
+    free(entry);
+}
+
+/*
+* Point the hardware route of an entry at nhop_handle, 0 meaning no route,
+* with at most one switchapi call.
+*/
+static sai_status_t sai_route_shadow_program(
+        sai_route_shadow_entry_t *entry,
+        switch_handle_t nhop_handle) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    switch_handle_t vrf_handle = entry->key.vrf_handle;
+    switch_ip_addr_t *ip_addr = &entry->key.ip_addr;
+
+    if (entry->nhop_handle == nhop_handle) {
+        return SAI_STATUS_SUCCESS;
+    }
+    if (!entry->nhop_handle) {
+        status = switch_api_l3_route_add(device, vrf_handle, ip_addr, nhop_handle);
+    } else if (!nhop_handle) {
+        status = switch_api_l3_route_delete(device, vrf_handle, ip_addr, entry->nhop_handle);
+    } else {
+        status = switch_api_l3_route_update(device, vrf_handle, ip_addr, nhop_handle);
+    }
+    if (status == SAI_STATUS_SUCCESS) {
+        entry->nhop_handle = nhop_handle;
+    }
+    return status;
+}
+
+/*
+* Move an entry to a new route API next hop / action with at most one
+* switchapi call, taking over a prefix that only had a host route. Nothing
+* is sent if the resolved next hop is unchanged. The route moves its next
+* hop group reference along with next_hop_id.
+*/
+static sai_status_t sai_route_shadow_update(
+        sai_route_shadow_entry_t *entry,
+        switch_handle_t next_hop_id,
+        int action, int pri) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    bool moved = !entry->user || next_hop_id != entry->next_hop_id;
+
+    if (moved) {
+        status = sai_next_hop_group_route_ref(next_hop_id);
+        if (status != SAI_STATUS_SUCCESS) {
+            return status;
+        }
+    }
+    status = sai_route_shadow_program(entry, sai_route_entry_nhop_resolve(next_hop_id, action));
+    if (status != SAI_STATUS_SUCCESS) {
+        if (moved) {
+            sai_next_hop_group_route_unref(next_hop_id);
+        }
+        return status;
+    }
+    if (moved && entry->user) {
+        sai_next_hop_group_route_unref(entry->next_hop_id);
+    }
+    entry->user = true;
+    entry->next_hop_id = next_hop_id;
+    entry->action = action;
+    entry->pri = pri;
+    return SAI_STATUS_SUCCESS;
+}
+
+typedef struct _sai_route_rebind_t {
+    switch_handle_t next_hop_id;
+    sai_status_t status;
+} sai_route_rebind_t;
+
+static void sai_route_shadow_rebind(void *arg, void *obj) {
+    sai_route_rebind_t *rebind = (sai_route_rebind_t *) arg;
+    sai_route_shadow_entry_t *entry = (sai_route_shadow_entry_t *) obj;
+    sai_status_t status = SAI_STATUS_SUCCESS;
+
+    if (!entry->user || entry->next_hop_id != rebind->next_hop_id) {
+        return;
+    }
+    status = sai_route_shadow_update(entry, entry->next_hop_id, entry->action, entry->pri);
+    if (status != SAI_STATUS_SUCCESS) {
+        rebind->status = status;
+    }
+}
+
+/*
+* Re-resolve every route using next_hop_id after the hardware next hop
+* behind it changed, e.g. a next hop group moved to another ECMP group.
+* A route that fails to update keeps its old next hop.
+*/
+sai_status_t sai_route_next_hop_rebind(
+        _In_ switch_handle_t next_hop_id) {
+    sai_route_rebind_t rebind = { next_hop_id, SAI_STATUS_SUCCESS };
+
+    tommy_hashdyn_foreach_arg(&sai_route_shadow, sai_route_shadow_rebind, &rebind);
+    return rebind.status;
+}
+
+/*
+* Install, move or, with nhop_handle 0, withdraw the host route the
+* neighbor layer keeps for a neighbor address. While a route API route
+* exists for the same prefix only the shadow changes.
+*/
+sai_status_t sai_route_neighbor_set(
+        _In_ switch_handle_t vrf_handle,
+        _In_ const switch_ip_addr_t *ip_addr,
+        _In_ switch_handle_t nhop_handle) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_route_shadow_key_t key;
+    sai_route_shadow_entry_t *entry = NULL;
+    tommy_hash_t hash;
+
+    sai_route_shadow_key_init(&key, vrf_handle, ip_addr);
+    entry = sai_route_shadow_find(&key, &hash);
+    if (!entry) {
+        if (!nhop_handle) {
+            return SAI_STATUS_SUCCESS;
+        }
+        entry = sai_route_shadow_insert(&key, hash);
+        if (!entry) {
+            return SAI_STATUS_NO_MEMORY;
+        }
+    }
+    if (!entry->user) {
+        status = sai_route_shadow_program(entry, nhop_handle);
+    }
+    if (status == SAI_STATUS_SUCCESS) {
+        entry->host_nhop = nhop_handle;
+    }
+    sai_route_shadow_release(entry);
+    return status;
+}
+
+/*
+* Program a parsed route. An identical route already in the shadow is a
+* no-op, a route whose next hop changed is updated in place.
+*/
+static sai_status_t sai_route_shadow_add(
+        switch_handle_t vrf_handle,
+        const switch_ip_addr_t *ip_addr,
+        switch_handle_t next_hop_id,
+        int action, int pri) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_route_shadow_key_t key;
+    sai_route_shadow_entry_t *entry = NULL;
+    tommy_hash_t hash;
+
+    sai_route_shadow_key_init(&key, vrf_handle, ip_addr);
+    entry = sai_route_shadow_find(&key, &hash);
+    if (!entry) {
+        entry = sai_route_shadow_insert(&key, hash);
+        if (!entry) {
+            return SAI_STATUS_NO_MEMORY;
+        }
+    }
+    status = sai_route_shadow_update(entry, next_hop_id, action, pri);
+    if (status != SAI_STATUS_SUCCESS) {
+        sai_route_shadow_release(entry);
+    }
+    return status;
+}
+
+/*
+* Remove a route API route. A neighbor host route for the same prefix is
+* put back in its place.
+*/
+static sai_status_t sai_route_shadow_remove(
+        switch_handle_t vrf_handle,
+        const switch_ip_addr_t *ip_addr) {
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_route_shadow_key_t key;
+    sai_route_shadow_entry_t *entry = NULL;
+    tommy_hash_t hash;
+
+    sai_route_shadow_key_init(&key, vrf_handle, ip_addr);
+    entry = sai_route_shadow_find(&key, &hash);
+    if (!entry || !entry->user) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+    status = sai_route_shadow_program(entry, entry->host_nhop);
+    if (status != SAI_STATUS_SUCCESS) {
+        return status;
+    }
+    sai_next_hop_group_route_unref(entry->next_hop_id);
+    entry->user = false;
+    entry->next_hop_id = 0;
+    entry->action = -1;
+    entry->pri = -1;
+    sai_route_shadow_release(entry);
+    return SAI_STATUS_SUCCESS;
+}
+
 /*
 * Routine Description:
 *    Create Route
@@ -124,26 +435,13 @@ sai_status_t sai_create_route_entry(
     switch_handle_t nhop_handle = 0;
     switch_handle_t vrf_handle = 0;
     int action=-1, pri=-1;
-    sai_route_entry_parse(unicast_route_entry, &vrf_handle, &ip_addr);
-    sai_route_entry_attribute_parse(attr_count, attr_list, &nhop_handle, &action, &pri);
-    if(!nhop_handle && action != -1) {
-        switch(action) {
-            case SAI_PACKET_ACTION_DROP:
-                nhop_handle = switch_api_cpu_nhop_get(SWITCH_HOSTIF_REASON_CODE_NULL_DROP);
-                break;
-            case SAI_PACKET_ACTION_FORWARD:
-                break;
-            case SAI_PACKET_ACTION_TRAP:
-                // set the nhop_handle to the cpu nhop
-                nhop_handle = switch_api_cpu_nhop_get(SWITCH_HOSTIF_REASON_CODE_GLEAN);
-                break;
-            default:
-                break;
-        }
-    }
-    if (nhop_handle) {
-        status = switch_api_l3_route_add(device, vrf_handle, &ip_addr, nhop_handle);
+    status = sai_route_entry_parse(unicast_route_entry, &vrf_handle, &ip_addr);
+    if (status != SAI_STATUS_SUCCESS) {
+        SAI_LOG(SAI_LOG_ERROR, SAI_API_ROUTE, "invalid route prefix\n");
+        return status;
     }
+    sai_route_entry_attribute_parse(attr_count, attr_list, &nhop_handle, &action, &pri);
+    status = sai_route_shadow_add(vrf_handle, &ip_addr, nhop_handle, action, pri);
 
     SAI_LOG_EXIT(SAI_API_ROUTE);
 
@@ -171,9 +469,12 @@ sai_status_t sai_remove_route_entry(
     sai_status_t status = SAI_STATUS_SUCCESS;
     switch_ip_addr_t ip_addr;
     switch_handle_t vrf_handle = 0;
-    switch_handle_t nhop_handle = 0;
-    sai_route_entry_parse(unicast_route_entry, &vrf_handle, &ip_addr);
-    status = switch_api_l3_route_delete(device, vrf_handle, &ip_addr, nhop_handle);
+    status = sai_route_entry_parse(unicast_route_entry, &vrf_handle, &ip_addr);
+    if (status != SAI_STATUS_SUCCESS) {
+        SAI_LOG(SAI_LOG_ERROR, SAI_API_ROUTE, "invalid route prefix\n");
+        return status;
+    }
+    status = sai_route_shadow_remove(vrf_handle, &ip_addr);
 
     SAI_LOG_EXIT(SAI_API_ROUTE);
 
@@ -191,6 +492,10 @@ sai_status_t sai_remove_route_entry(
 * Return Values:
 *    SAI_STATUS_SUCCESS on success
 *    Failure status code on error
+*
+* Note: next hop and packet action changes modify the route in place,
+*       there is no window where the prefix is missing from hardware.
+*       DROP and TRAP override the next hop until set back to FORWARD.
 */
 sai_status_t sai_set_route_entry_attribute(
         _In_ const sai_unicast_route_entry_t* unicast_route_entry,
@@ -199,6 +504,45 @@ sai_status_t sai_set_route_entry_attribute(
     SAI_LOG_ENTER(SAI_API_ROUTE);
 
     sai_status_t status = SAI_STATUS_SUCCESS;
+    switch_ip_addr_t ip_addr;
+    switch_handle_t vrf_handle = 0;
+    sai_route_shadow_key_t key;
+    sai_route_shadow_entry_t *entry = NULL;
+    switch_handle_t next_hop_id = 0;
+    int action = -1, pri = -1;
+    tommy_hash_t hash;
+
+    if (!attr) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    status = sai_route_entry_parse(unicast_route_entry, &vrf_handle, &ip_addr);
+    if (status != SAI_STATUS_SUCCESS) {
+        SAI_LOG(SAI_LOG_ERROR, SAI_API_ROUTE, "invalid route prefix\n");
+        return status;
+    }
+    sai_route_shadow_key_init(&key, vrf_handle, &ip_addr);
+    entry = sai_route_shadow_find(&key, &hash);
+    if (!entry || !entry->user) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    next_hop_id = entry->next_hop_id;
+    action = entry->action;
+    pri = entry->pri;
+    switch (attr->id) {
+        case SAI_ROUTE_ATTR_NEXT_HOP_ID:
+            next_hop_id = (switch_handle_t) attr->value.oid;
+            break;
+        case SAI_ROUTE_ATTR_PACKET_ACTION:
+            action = attr->value.s32;
+            break;
+        case SAI_ROUTE_ATTR_TRAP_PRIORITY:
+            pri = attr->value.u8;
+            break;
+        default:
+            return SAI_STATUS_NOT_SUPPORTED;
+    }
+    status = sai_route_shadow_update(entry, next_hop_id, action, pri);
 
     SAI_LOG_EXIT(SAI_API_ROUTE);
 
@@ -217,6 +561,8 @@ sai_status_t sai_set_route_entry_attribute(
 * Return Values:
 *    SAI_STATUS_SUCCESS on success
 *    Failure status code on error
+*
+* Note: answered from the route shadow, switchapi is not consulted.
 */
 sai_status_t sai_get_route_entry_attribute(
         _In_ const sai_unicast_route_entry_t* unicast_route_entry,
@@ -226,6 +572,192 @@ sai_status_t sai_get_route_entry_attribute(
     SAI_LOG_ENTER(SAI_API_ROUTE);
 
     sai_status_t status = SAI_STATUS_SUCCESS;
+    switch_ip_addr_t ip_addr;
+    switch_handle_t vrf_handle = 0;
+    sai_route_shadow_key_t key;
+    sai_route_shadow_entry_t *entry = NULL;
+    sai_attribute_t *attribute;
+    tommy_hash_t hash;
+    uint32_t index = 0;
+
+    status = sai_route_entry_parse(unicast_route_entry, &vrf_handle, &ip_addr);
+    if (status != SAI_STATUS_SUCCESS) {
+        SAI_LOG(SAI_LOG_ERROR, SAI_API_ROUTE, "invalid route prefix\n");
+        return status;
+    }
+    sai_route_shadow_key_init(&key, vrf_handle, &ip_addr);
+    entry = sai_route_shadow_find(&key, &hash);
+    if (!entry || !entry->user) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    for (index = 0; index < attr_count; index++) {
+        attribute = &attr_list[index];
+        switch (attribute->id) {
+            case SAI_ROUTE_ATTR_NEXT_HOP_ID:
+                attribute->value.oid = (sai_object_id_t) entry->next_hop_id;
+                break;
+            case SAI_ROUTE_ATTR_PACKET_ACTION:
+                attribute->value.s32 = (entry->action == -1) ?
+                    SAI_PACKET_ACTION_FORWARD : entry->action;
+                break;
+            case SAI_ROUTE_ATTR_TRAP_PRIORITY:
+                attribute->value.u8 = (entry->pri == -1) ? 0 : entry->pri;
+                break;
+            default:
+                status = SAI_STATUS_NOT_SUPPORTED;
+                break;
+        }
+    }
+
+    SAI_LOG_EXIT(SAI_API_ROUTE);
+
+    return (sai_status_t) status;
+}
+
+/*
+* Routine Description:
+*    Create routes in bulk
+*
+* Arguments:
+*    [in] route_count - number of routes
+*    [in] unicast_route_entry - array of route entries
+*    [in] attr_count - number of attributes for each route
+*    [in] attr_list - array of attribute arrays, one per route
+*    [out] object_statuses - status of each route
+*
+* Return Values:
+*    SAI_STATUS_SUCCESS if all routes were created
+*    SAI_STATUS_FAILURE if any route failed, see object_statuses
+*
+* Note: IP prefix/mask expected in Network Byte Order. switchapi has no
+*       batch call, each route still takes its own switchapi call.
+*/
+sai_status_t sai_bulk_create_route_entry(
+        _In_ uint32_t route_count,
+        _In_ const sai_unicast_route_entry_t *unicast_route_entry,
+        _In_ const uint32_t *attr_count,
+        _In_ const sai_attribute_t **attr_list,
+        _Out_ sai_status_t *object_statuses) {
+
+    SAI_LOG_ENTER(SAI_API_ROUTE);
+
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    switch_handle_t vrf_handle = 0;
+    switch_ip_addr_t ip_addr;
+    switch_handle_t next_hop_id = 0;
+    int action = -1, pri = -1;
+    uint32_t index = 0;
+
+    if (!unicast_route_entry || !attr_count || !attr_list || !object_statuses) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    for (index = 0; index < route_count; index++) {
+        next_hop_id = 0;
+        action = -1;
+        pri = -1;
+        object_statuses[index] = sai_route_entry_parse(&unicast_route_entry[index],
+                                                       &vrf_handle, &ip_addr);
+        if (object_statuses[index] == SAI_STATUS_SUCCESS) {
+            sai_route_entry_attribute_parse(attr_count[index], attr_list[index],
+                                            &next_hop_id, &action, &pri);
+            object_statuses[index] = sai_route_shadow_add(vrf_handle, &ip_addr,
+                                                          next_hop_id, action, pri);
+        }
+        if (object_statuses[index] != SAI_STATUS_SUCCESS) {
+            status = SAI_STATUS_FAILURE;
+        }
+    }
+
+    SAI_LOG_EXIT(SAI_API_ROUTE);
+
+    return (sai_status_t) status;
+}
+
+/*
+* Routine Description:
+*    Remove routes in bulk
+*
+* Arguments:
+*    [in] route_count - number of routes
+*    [in] unicast_route_entry - array of route entries
+*    [out] object_statuses - status of each route
+*
+* Return Values:
+*    SAI_STATUS_SUCCESS if all routes were removed
+*    SAI_STATUS_FAILURE if any route failed, see object_statuses
+*
+* Note: IP prefix/mask expected in Network Byte Order.
+*/
+sai_status_t sai_bulk_remove_route_entry(
+        _In_ uint32_t route_count,
+        _In_ const sai_unicast_route_entry_t *unicast_route_entry,
+        _Out_ sai_status_t *object_statuses) {
+
+    SAI_LOG_ENTER(SAI_API_ROUTE);
+
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    switch_handle_t vrf_handle = 0;
+    switch_ip_addr_t ip_addr;
+    uint32_t index = 0;
+
+    if (!unicast_route_entry || !object_statuses) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    for (index = 0; index < route_count; index++) {
+        object_statuses[index] = sai_route_entry_parse(&unicast_route_entry[index],
+                                                       &vrf_handle, &ip_addr);
+        if (object_statuses[index] == SAI_STATUS_SUCCESS) {
+            object_statuses[index] = sai_route_shadow_remove(vrf_handle, &ip_addr);
+        }
+        if (object_statuses[index] != SAI_STATUS_SUCCESS) {
+            status = SAI_STATUS_FAILURE;
+        }
+    }
+
+    SAI_LOG_EXIT(SAI_API_ROUTE);
+
+    return (sai_status_t) status;
+}
+
+/*
+* Routine Description:
+*    Set route attribute value in bulk
+*
+* Arguments:
+*    [in] route_count - number of routes
+*    [in] unicast_route_entry - array of route entries
+*    [in] attr_list - one attribute per route
+*    [out] object_statuses - status of each route
+*
+* Return Values:
+*    SAI_STATUS_SUCCESS if all routes were updated
+*    SAI_STATUS_FAILURE if any route failed, see object_statuses
+*/
+sai_status_t sai_bulk_set_route_entry_attribute(
+        _In_ uint32_t route_count,
+        _In_ const sai_unicast_route_entry_t *unicast_route_entry,
+        _In_ const sai_attribute_t *attr_list,
+        _Out_ sai_status_t *object_statuses) {
+
+    SAI_LOG_ENTER(SAI_API_ROUTE);
+
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    uint32_t index = 0;
+
+    if (!unicast_route_entry || !attr_list || !object_statuses) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    for (index = 0; index < route_count; index++) {
+        object_statuses[index] = sai_set_route_entry_attribute(
+            &unicast_route_entry[index], &attr_list[index]);
+        if (object_statuses[index] != SAI_STATUS_SUCCESS) {
+            status = SAI_STATUS_FAILURE;
+        }
+    }
 
     SAI_LOG_EXIT(SAI_API_ROUTE);
 
@@ -244,5 +776,6 @@ sai_route_api_t route_api = {
 
 sai_status_t sai_route_initialize(sai_api_service_t *sai_api_service) {
     sai_api_service->route_api = route_api;
+    tommy_hashdyn_init(&sai_route_shadow);
     return SAI_STATUS_SUCCESS;
 }
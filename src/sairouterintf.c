@@ -15,9 +15,48 @@ limitations under the License.
 */
 
 #include <sairouterintf.h>
+#include <stdlib.h>
 #include "saiinternal.h"
 #include "sailog.h"
 #include <switchapi/switch_interface.h>
+#include <tommyds/tommyhashdyn.h>
+
+/*
+* VRF of each router interface created through SAI, for modules that need
+* to program routes on behalf of a RIF (neighbor drop/trap host routes).
+* Readers hold the ROUTER_INTERFACE API lock, see saiinternal.h.
+*/
+typedef struct _sai_rif_vrf_entry_t {
+    tommy_node node;
+    switch_handle_t rif_handle;
+    switch_handle_t vrf_handle;
+} sai_rif_vrf_entry_t;
+
+static tommy_hashdyn sai_rif_vrf;
+
+static int sai_rif_vrf_cmp(const void *arg, const void *obj) {
+    const switch_handle_t *rif_handle = (const switch_handle_t *) arg;
+    const sai_rif_vrf_entry_t *entry = (const sai_rif_vrf_entry_t *) obj;
+    return *rif_handle != entry->rif_handle;
+}
+
+static sai_rif_vrf_entry_t *sai_rif_vrf_find(
+        switch_handle_t rif_handle) {
+    return (sai_rif_vrf_entry_t *) tommy_hashdyn_search(
+        &sai_rif_vrf, sai_rif_vrf_cmp, &rif_handle,
+        tommy_hash_u32(0, &rif_handle, sizeof(switch_handle_t)));
+}
+
+sai_status_t sai_router_interface_vrf_get(
+        _In_ switch_handle_t rif_handle,
+        _Out_ switch_handle_t *vrf_handle) {
+    sai_rif_vrf_entry_t *entry = sai_rif_vrf_find(rif_handle);
+    if (!entry) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+    *vrf_handle = entry->vrf_handle;
+    return SAI_STATUS_SUCCESS;
+}
 
 /*
 * Routine Description:
@@ -43,6 +82,7 @@ sai_status_t sai_create_router_interface(
     switch_api_interface_info_t intf_info;
     const sai_attribute_t *attribute;
     sai_router_interface_type_t sai_intf_type;
+    sai_rif_vrf_entry_t *entry = NULL;
     uint32_t index = 0;
     memset(&intf_info, 0, sizeof(switch_api_interface_info_t));
     // default initialize
@@ -81,6 +121,16 @@ sai_status_t sai_create_router_interface(
         }
     }
     *rif_id = (sai_object_id_t) switch_api_interface_create(device, &intf_info);
+    if (*rif_id == SWITCH_API_INVALID_HANDLE) {
+        return SAI_STATUS_FAILURE;
+    }
+    entry = (sai_rif_vrf_entry_t *) malloc(sizeof(sai_rif_vrf_entry_t));
+    if (entry) {
+        entry->rif_handle = (switch_handle_t) *rif_id;
+        entry->vrf_handle = intf_info.vrf_handle;
+        tommy_hashdyn_insert(&sai_rif_vrf, &entry->node, entry,
+                             tommy_hash_u32(0, &entry->rif_handle, sizeof(switch_handle_t)));
+    }
 
     SAI_LOG_EXIT(SAI_API_ROUTER_INTERFACE);
 
@@ -104,7 +154,13 @@ sai_status_t sai_remove_router_interface(
     SAI_LOG_ENTER(SAI_API_ROUTER_INTERFACE);
 
     sai_status_t status = SAI_STATUS_SUCCESS;
+    sai_rif_vrf_entry_t *entry = NULL;
     status = switch_api_interface_delete(device, (switch_handle_t)rif_id);
+    entry = sai_rif_vrf_find((switch_handle_t) rif_id);
+    if (status == SAI_STATUS_SUCCESS && entry) {
+        tommy_hashdyn_remove_existing(&sai_rif_vrf, &entry->node);
+        free(entry);
+    }
 
     SAI_LOG_EXIT(SAI_API_ROUTER_INTERFACE);
 
@@ -175,5 +231,6 @@ sai_router_interface_api_t rif_api = {
 
 sai_status_t sai_router_interface_initialize(sai_api_service_t *sai_api_service) {
     sai_api_service->rif_api = rif_api;
+    tommy_hashdyn_init(&sai_rif_vrf);
     return SAI_STATUS_SUCCESS;
 }
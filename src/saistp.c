@@ -50,7 +50,7 @@ sai_status_t sai_create_stp_entry(
             vlan_handle = (switch_handle_t *) malloc(sizeof(switch_handle_t) * vlans->vlan_count);
             for (index2 = 0; index2 < vlans->vlan_count; index2++) {
                 vlan_id = vlans->vlan_list[index2];
-                switch_api_vlan_id_to_handle_get(vlan_id, &vlan_handle[index2]);
+                sai_vlan_id_to_handle(vlan_id, &vlan_handle[index2]);
             }
             status = switch_api_stp_group_vlans_add(device, *stp_id, vlans->vlan_count, vlan_handle);
             free(vlan_handle);
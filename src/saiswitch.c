@@ -84,9 +84,24 @@ sai_status_t sai_set_switch_attribute(
         case SAI_SWITCH_ATTR_SRC_MAC_ADDRESS:
             memcpy(&api_switch_info.switch_mac, &attr->value.mac, 6);
             mac_set = 1;
+            switch_api_capability_set(device, &api_switch_info);
+            break;
+        case SAI_SWITCH_ATTR_FDB_AGING_TIME:
+            status = sai_fdb_aging_time_set(attr->value.u32);
+            break;
+        case SAI_SWITCH_ATTR_CUSTOM_FDB_EVENT_INTERVAL:
+            if (!attr->value.u32) {
+                return SAI_STATUS_INVALID_PARAMETER;
+            }
+            status = sai_fdb_event_config_set(attr->value.u32, 0);
+            break;
+        case SAI_SWITCH_ATTR_CUSTOM_FDB_EVENT_BATCH_SIZE:
+            if (!attr->value.u32) {
+                return SAI_STATUS_INVALID_PARAMETER;
+            }
+            status = sai_fdb_event_config_set(0, attr->value.u32);
             break;
     }
-    switch_api_capability_set(device, &api_switch_info);
 
     SAI_LOG_EXIT(SAI_API_SWITCH);
 
@@ -116,8 +131,10 @@ sai_status_t sai_get_switch_attribute(
     sai_object_list_t *objlist = NULL;
     switch_api_capability_t api_switch_info;
     sai_attribute_t attribute;
+    uint32_t event_interval = 0, event_batch_size = 0;
 
     switch_api_capability_get(device, &api_switch_info);
+    sai_fdb_event_config_get(&event_interval, &event_batch_size);
     for (index1 = 0; index1 < attr_count; index1++) {
         attribute = attr_list[index1];
         switch (attribute.id) {
@@ -153,6 +170,15 @@ sai_status_t sai_get_switch_attribute(
             case SAI_SWITCH_ATTR_CPU_PORT:
                 attr_list->value.oid = api_switch_info.port_list[64];
                 break;
+            case SAI_SWITCH_ATTR_FDB_AGING_TIME:
+                attr_list[index1].value.u32 = sai_fdb_aging_time_get();
+                break;
+            case SAI_SWITCH_ATTR_CUSTOM_FDB_EVENT_INTERVAL:
+                attr_list[index1].value.u32 = event_interval;
+                break;
+            case SAI_SWITCH_ATTR_CUSTOM_FDB_EVENT_BATCH_SIZE:
+                attr_list[index1].value.u32 = event_batch_size;
+                break;
         }
     }
 
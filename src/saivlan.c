@@ -19,6 +19,97 @@ limitations under the License.
 #include "sailog.h"
 #include <switchapi/switch_vlan.h>
 
+#define SAI_VLAN_ID_COUNT               4096
+#define SAI_VLAN_HANDLE_MEMO_SIZE       64
+
+/*
+* VLAN id to switchapi handle translation, indexed by VLAN id, 0 if the
+* VLAN is not known. Seeded at initialize with the VLANs switchapi
+* created on its own (e.g. the default VLAN), then only written by VLAN
+* create/remove. It is read from other APIs and from the FDB event
+* thread without the VLAN API lock, so every access is an atomic load
+* or store.
+*/
+static switch_handle_t sai_vlan_handles[SAI_VLAN_ID_COUNT];
+
+static switch_handle_t sai_vlan_handle_load(
+        sai_vlan_id_t vlan_id) {
+    return __atomic_load_n(&sai_vlan_handles[vlan_id], __ATOMIC_ACQUIRE);
+}
+
+static void sai_vlan_handle_store(
+        sai_vlan_id_t vlan_id,
+        switch_handle_t vlan_handle) {
+    __atomic_store_n(&sai_vlan_handles[vlan_id], vlan_handle, __ATOMIC_RELEASE);
+}
+
+/*
+* Routine Description:
+*    Translate a VLAN id to its switchapi handle
+*
+* Arguments:
+*    [in] vlan_id - VLAN id
+*    [out] vlan_handle - VLAN handle
+*
+* Return Values:
+*    SAI_STATUS_SUCCESS on success
+*    Failure status code on error
+*
+* Note: a VLAN missing from the table is looked up in switchapi but not
+*       added, the table is only changed by the VLAN API.
+*/
+sai_status_t sai_vlan_id_to_handle(
+        _In_ sai_vlan_id_t vlan_id,
+        _Out_ switch_handle_t *vlan_handle) {
+    if (vlan_id >= SAI_VLAN_ID_COUNT) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    *vlan_handle = sai_vlan_handle_load(vlan_id);
+    if (*vlan_handle) {
+        return SAI_STATUS_SUCCESS;
+    }
+    return (sai_status_t) switch_api_vlan_id_to_handle_get((switch_vlan_t) vlan_id,
+                                                           vlan_handle);
+}
+
+/*
+* Routine Description:
+*    Translate a switchapi VLAN handle back to its VLAN id. Used on the
+*    FDB event path; recent answers are remembered per thread and checked
+*    against the id to handle array before use.
+*
+* Arguments:
+*    [in] vlan_handle - VLAN handle
+*    [out] vlan_id - VLAN id
+*
+* Return Values:
+*    SAI_STATUS_SUCCESS on success
+*    SAI_STATUS_ITEM_NOT_FOUND if the handle is not known
+*/
+sai_status_t sai_vlan_handle_to_id(
+        _In_ switch_handle_t vlan_handle,
+        _Out_ sai_vlan_id_t *vlan_id) {
+    static __thread sai_vlan_id_t recent[SAI_VLAN_HANDLE_MEMO_SIZE];
+    uint32_t slot = (uint32_t) (vlan_handle % SAI_VLAN_HANDLE_MEMO_SIZE);
+    uint32_t index = 0;
+
+    if (!vlan_handle) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    if (sai_vlan_handle_load(recent[slot]) == vlan_handle) {
+        *vlan_id = recent[slot];
+        return SAI_STATUS_SUCCESS;
+    }
+    for (index = 0; index < SAI_VLAN_ID_COUNT; index++) {
+        if (sai_vlan_handle_load((sai_vlan_id_t) index) == vlan_handle) {
+            recent[slot] = (sai_vlan_id_t) index;
+            *vlan_id = (sai_vlan_id_t) index;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+    return SAI_STATUS_ITEM_NOT_FOUND;
+}
+
 /*
 * Routine Description:
 *    Create a VLAN
@@ -36,7 +127,17 @@ sai_status_t sai_create_vlan_entry(
     SAI_LOG_ENTER(SAI_API_VLAN);
 
     sai_status_t status = SAI_STATUS_SUCCESS;
-    switch_api_vlan_create(device, (switch_vlan_t) vlan_id);
+    switch_handle_t vlan_handle = 0;
+
+    if (vlan_id >= SAI_VLAN_ID_COUNT) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    vlan_handle = switch_api_vlan_create(device, (switch_vlan_t) vlan_id);
+    if (vlan_handle == SWITCH_API_INVALID_HANDLE) {
+        status = SAI_STATUS_FAILURE;
+    } else {
+        sai_vlan_handle_store(vlan_id, vlan_handle);
+    }
 
     SAI_LOG_EXIT(SAI_API_VLAN);
 
@@ -61,9 +162,15 @@ sai_status_t sai_remove_vlan_entry(
 
     sai_status_t status = SAI_STATUS_SUCCESS;
     switch_handle_t vlan_handle = 0;
-    status = switch_api_vlan_id_to_handle_get((switch_vlan_t) vlan_id,
-                                                  &vlan_handle);
+    status = sai_vlan_id_to_handle(vlan_id, &vlan_handle);
+    if (status != SAI_STATUS_SUCCESS) {
+        return status;
+    }
     status = switch_api_vlan_delete(device, vlan_handle);
+    if (status == SAI_STATUS_SUCCESS) {
+        sai_vlan_handle_store(vlan_id, 0);
+        sai_fdb_vlan_prune(vlan_id);
+    }
 
     SAI_LOG_EXIT(SAI_API_VLAN);
 
@@ -168,7 +275,7 @@ sai_status_t sai_add_ports_to_vlan(
     switch_handle_t vlan_handle = 0;
     switch_vlan_port_t *switch_port_list;
     uint32_t index = 0;
-    status = switch_api_vlan_id_to_handle_get((switch_vlan_t) vlan_id, &vlan_handle);
+    status = sai_vlan_id_to_handle(vlan_id, &vlan_handle);
     switch_port_list = (switch_vlan_port_t *) malloc(sizeof(switch_vlan_port_t) * port_count);
     for (index = 0; index < port_count; index++) {
         switch_port_list[index].handle = (switch_handle_t) port_list[index].port_id;
@@ -206,7 +313,7 @@ sai_status_t sai_remove_ports_from_vlan(
     switch_handle_t vlan_handle = 0;
     switch_vlan_port_t *switch_port_list;
     uint32_t index = 0;
-    status = switch_api_vlan_id_to_handle_get((switch_vlan_t) vlan_id, &vlan_handle);
+    status = sai_vlan_id_to_handle(vlan_id, &vlan_handle);
     switch_port_list = (switch_vlan_port_t *) malloc(sizeof(switch_vlan_port_t) * port_count);
     for (index = 0; index < port_count; index++) {
         switch_port_list[index].handle = (switch_handle_t) port_list[index].port_id;
@@ -264,6 +371,16 @@ sai_vlan_api_t vlan_api = {
 };
 
 sai_status_t sai_vlan_initialize(sai_api_service_t *sai_api_service) {
+    switch_handle_t vlan_handle = 0;
+    uint32_t index = 0;
+
     sai_api_service->vlan_api = vlan_api;
+    for (index = 0; index < SAI_VLAN_ID_COUNT; index++) {
+        vlan_handle = 0;
+        if (switch_api_vlan_id_to_handle_get((switch_vlan_t) index,
+                                             &vlan_handle) == SWITCH_STATUS_SUCCESS) {
+            sai_vlan_handle_store((sai_vlan_id_t) index, vlan_handle);
+        }
+    }
     return SAI_STATUS_SUCCESS;
 }
@@ -158,11 +158,29 @@ struct sai_thrift_attribute_list_t {
     2: i32 attr_count; // redundant
 }
 
+struct sai_thrift_fdb_entry_info_t {
+    1: sai_thrift_fdb_entry_t fdb_entry;
+    2: byte entry_type;
+    3: sai_thrift_object_id_t port_id;
+    4: byte packet_action;
+}
+
+struct sai_thrift_fdb_page_t {
+    1: sai_thrift_status_t status;
+    2: list<sai_thrift_fdb_entry_info_t> entries;
+    3: bool more;
+}
+
 service switch_sai_rpc {
     //fdb API
     sai_thrift_status_t sai_thrift_create_fdb_entry(1: sai_thrift_fdb_entry_t thrift_fdb_entry, 2: list<sai_thrift_attribute_t> thrift_attr_list);
     sai_thrift_status_t sai_thrift_delete_fdb_entry(1: sai_thrift_fdb_entry_t thrift_fdb_entry);
     sai_thrift_status_t sai_thrift_flush_fdb_entries(1: list <sai_thrift_attribute_t> thrift_attr_list);
+    list<sai_thrift_status_t> sai_thrift_create_fdb_entries(1: list<sai_thrift_fdb_entry_t> thrift_fdb_entries, 2: list<list<sai_thrift_attribute_t>> thrift_attr_lists);
+    list<sai_thrift_status_t> sai_thrift_delete_fdb_entries(1: list<sai_thrift_fdb_entry_t> thrift_fdb_entries);
+    sai_thrift_status_t sai_thrift_set_fdb_entry_attribute(1: sai_thrift_fdb_entry_t thrift_fdb_entry, 2: sai_thrift_attribute_t thrift_attr);
+    sai_thrift_attribute_list_t sai_thrift_get_fdb_entry_attribute(1: sai_thrift_fdb_entry_t thrift_fdb_entry);
+    sai_thrift_fdb_page_t sai_thrift_get_fdb_entries(1: list<sai_thrift_attribute_t> thrift_filter_list, 2: sai_thrift_fdb_entry_t thrift_cursor, 3: i32 max_count);
 
     //vlan API
     sai_thrift_status_t sai_thrift_create_vlan(1: sai_thrift_vlan_id_t vlan_id);
@@ -177,6 +195,9 @@ service switch_sai_rpc {
     //route API
     sai_thrift_status_t sai_thrift_create_route(1: sai_thrift_unicast_route_entry_t thrift_unicast_route_entry, 2: list<sai_thrift_attribute_t> thrift_attr_list);
     sai_thrift_status_t sai_thrift_remove_route(1: sai_thrift_unicast_route_entry_t thrift_unicast_route_entry);
+    sai_thrift_status_t sai_thrift_set_route_attribute(1: sai_thrift_unicast_route_entry_t thrift_unicast_route_entry, 2: sai_thrift_attribute_t thrift_attr);
+    list<sai_thrift_status_t> sai_thrift_create_routes(1: list<sai_thrift_unicast_route_entry_t> thrift_unicast_route_entries, 2: list<list<sai_thrift_attribute_t>> thrift_attr_lists);
+    list<sai_thrift_status_t> sai_thrift_remove_routes(1: list<sai_thrift_unicast_route_entry_t> thrift_unicast_route_entries);
 
     //router interface API
     sai_thrift_object_id_t sai_thrift_create_router_interface(1: list<sai_thrift_attribute_t> thrift_attr_list);
@@ -189,12 +210,14 @@ service switch_sai_rpc {
     //next hop group API
     sai_thrift_object_id_t sai_thrift_create_next_hop_group(1: list<sai_thrift_attribute_t> thrift_attr_list);
     sai_thrift_status_t sai_thrift_remove_next_hop_group(1: sai_thrift_object_id_t next_hop_group_id);
+    sai_thrift_status_t sai_thrift_set_next_hop_group_attribute(1: sai_thrift_object_id_t next_hop_group_id, 2: sai_thrift_attribute_t thrift_attr);
     sai_thrift_status_t sai_thrift_add_next_hop_to_group(1: sai_thrift_object_id_t next_hop_group_id, 2: list<sai_thrift_object_id_t> thrift_nexthops);
     sai_thrift_status_t sai_thrift_remove_next_hop_from_group(1: sai_thrift_object_id_t next_hop_group_id, 2: list<sai_thrift_object_id_t> thrift_nexthops);
 
     //lag API
     sai_thrift_object_id_t sai_thrift_create_lag(1: list<sai_thrift_attribute_t> thrift_attr_list);
     sai_thrift_status_t sai_thrift_remove_lag(1: sai_thrift_object_id_t lag_id);
+    sai_thrift_status_t sai_thrift_set_lag_attribute(1: sai_thrift_object_id_t lag_id, 2: sai_thrift_attribute_t thrift_attr);
     sai_thrift_status_t sai_thrift_add_ports_to_lag(1: sai_thrift_object_id_t lag_id, 2: list<sai_thrift_object_id_t> thrift_port_list);
     sai_thrift_status_t sai_thrift_remove_ports_from_lag(1: sai_thrift_object_id_t lag_id, 2: list<sai_thrift_object_id_t> thrift_port_list);
 
@@ -207,6 +230,10 @@ service switch_sai_rpc {
     //neighbor API
     sai_thrift_status_t sai_thrift_create_neighbor_entry(1: sai_thrift_neighbor_entry_t thrift_neighbor_entry, 2: list<sai_thrift_attribute_t> thrift_attr_list);
     sai_thrift_status_t sai_thrift_remove_neighbor_entry(1: sai_thrift_neighbor_entry_t thrift_neighbor_entry);
+    sai_thrift_status_t sai_thrift_set_neighbor_attribute(1: sai_thrift_neighbor_entry_t thrift_neighbor_entry, 2: sai_thrift_attribute_t thrift_attr);
+    list<sai_thrift_status_t> sai_thrift_create_neighbor_entries(1: list<sai_thrift_neighbor_entry_t> thrift_neighbor_entries, 2: list<list<sai_thrift_attribute_t>> thrift_attr_lists);
+    list<sai_thrift_status_t> sai_thrift_remove_neighbor_entries(1: list<sai_thrift_neighbor_entry_t> thrift_neighbor_entries);
+    list<sai_thrift_status_t> sai_thrift_set_neighbor_entries_attribute(1: list<sai_thrift_neighbor_entry_t> thrift_neighbor_entries, 2: list<sai_thrift_attribute_t> thrift_attr_list);
 
     //switch API
     sai_thrift_attribute_list_t sai_thrift_get_switch_attribute();
@@ -0,0 +1,279 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string.h>
+#include <arpa/inet.h>
+#include "switch_sai_addr.h"
+
+#define SWITCH_SAI_MASK_CACHE_SIZE      64
+
+typedef struct switch_sai_mask_cache_entry_ {
+    bool valid;
+    uint8_t family;
+    uint8_t len;
+    char str[SWITCH_SAI_IPV6_STR_MAX];
+    uint8_t mask[16];
+} switch_sai_mask_cache_entry_t;
+
+/* per thread so that RPC worker threads never contend on it */
+static __thread switch_sai_mask_cache_entry_t switch_sai_mask_cache[SWITCH_SAI_MASK_CACHE_SIZE];
+
+/*
+ * Returns the value of a hex digit, or a negative value for anything else.
+ * Lower casing via "| 0x20" folds 'A'-'F' onto 'a'-'f' without a branch.
+ */
+static inline int
+switch_sai_addr_hex_digit(unsigned char c)
+{
+    unsigned int d = (unsigned int) c - '0';
+    unsigned int x = (unsigned int) (c | 0x20) - 'a';
+    if (d < 10) {
+        return d;
+    }
+    if (x < 6) {
+        return x + 10;
+    }
+    return -1;
+}
+
+sai_status_t
+switch_sai_addr_parse_mac(const char *str, size_t len, uint8_t *mac)
+{
+    uint8_t tmp[6];
+    int bad = 0;
+    int hi, lo;
+    int i;
+
+    if (len == SWITCH_SAI_MAC_STR_LEN) {
+        char sep = str[2];
+        if (sep != ':' && sep != '-') {
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+        for (i = 0; i < 6; i++) {
+            hi = switch_sai_addr_hex_digit(str[i * 3]);
+            lo = switch_sai_addr_hex_digit(str[i * 3 + 1]);
+            bad |= (hi | lo) < 0;
+            if (i < 5) {
+                bad |= str[i * 3 + 2] != sep;
+            }
+            tmp[i] = (uint8_t) (((unsigned int) hi << 4) | (unsigned int) lo);
+        }
+    } else if (len == 12) {
+        for (i = 0; i < 6; i++) {
+            hi = switch_sai_addr_hex_digit(str[i * 2]);
+            lo = switch_sai_addr_hex_digit(str[i * 2 + 1]);
+            bad |= (hi | lo) < 0;
+            tmp[i] = (uint8_t) (((unsigned int) hi << 4) | (unsigned int) lo);
+        }
+    } else {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (bad) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    memcpy(mac, tmp, 6);
+    return SAI_STATUS_SUCCESS;
+}
+
+void
+switch_sai_addr_format_mac(const uint8_t *mac, char *str)
+{
+    static const char hex[] = "0123456789abcdef";
+    int i;
+
+    for (i = 0; i < 6; i++) {
+        str[i * 3] = hex[mac[i] >> 4];
+        str[i * 3 + 1] = hex[mac[i] & 0xf];
+        str[i * 3 + 2] = ':';
+    }
+    str[SWITCH_SAI_MAC_STR_LEN] = '\0';
+}
+
+sai_status_t
+switch_sai_addr_parse_ipv4(const char *str, size_t len, uint32_t *ip4)
+{
+    uint32_t addr = 0;
+    uint32_t octet = 0;
+    unsigned int digits = 0;
+    unsigned int dots = 0;
+    size_t i;
+
+    if (len < 7 || len > SWITCH_SAI_IPV4_STR_MAX) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    for (i = 0; i < len; i++) {
+        unsigned int d = (unsigned char) str[i] - '0';
+        if (d < 10) {
+            octet = octet * 10 + d;
+            if (++digits > 3 || octet > 255) {
+                return SAI_STATUS_INVALID_PARAMETER;
+            }
+            continue;
+        }
+        if (str[i] != '.' || !digits || ++dots > 3) {
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+        addr = (addr << 8) | octet;
+        octet = 0;
+        digits = 0;
+    }
+    if (dots != 3 || !digits) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    *ip4 = htonl((addr << 8) | octet);
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t
+switch_sai_addr_parse_ipv6(const char *str, size_t len, uint8_t *ip6)
+{
+    uint8_t tmp[16];
+    uint32_t group;
+    uint32_t ip4;
+    size_t out = 0;
+    size_t i = 0;
+    size_t start;
+    int gap = -1;
+    int d;
+
+    if (len < 2 || len > SWITCH_SAI_IPV6_STR_MAX) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    if (str[0] == ':') {
+        if (str[1] != ':') {
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+        i = 1;
+    }
+
+    while (i < len) {
+        if (str[i] == ':') {
+            // "::" - only one zero run is allowed
+            if (gap >= 0) {
+                return SAI_STATUS_INVALID_PARAMETER;
+            }
+            gap = out;
+            i++;
+            continue;
+        }
+
+        start = i;
+        group = 0;
+        while (i < len && i - start <= 4 &&
+               (d = switch_sai_addr_hex_digit(str[i])) >= 0) {
+            group = (group << 4) | d;
+            i++;
+        }
+
+        if (i < len && str[i] == '.') {
+            // trailing dotted quad, e.g. ::ffff:10.0.0.1
+            if (out > 12 ||
+                switch_sai_addr_parse_ipv4(str + start, len - start, &ip4) != SAI_STATUS_SUCCESS) {
+                return SAI_STATUS_INVALID_PARAMETER;
+            }
+            memcpy(&tmp[out], &ip4, 4);
+            out += 4;
+            break;
+        }
+
+        if (i == start || i - start > 4 || out > 14) {
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+        tmp[out++] = (uint8_t) (group >> 8);
+        tmp[out++] = (uint8_t) group;
+
+        if (i == len) {
+            break;
+        }
+        if (str[i] != ':' || ++i == len) {
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    if (gap >= 0) {
+        if (out == 16) {
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+        memmove(&tmp[16 - (out - gap)], &tmp[gap], out - gap);
+        memset(&tmp[gap], 0, 16 - out);
+    } else if (out != 16) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    memcpy(ip6, tmp, 16);
+    return SAI_STATUS_SUCCESS;
+}
+
+static inline uint32_t
+switch_sai_addr_hash(uint8_t family, const char *str, size_t len)
+{
+    uint32_t hash = 2166136261u ^ family;
+    size_t i;
+    for (i = 0; i < len; i++) {
+        hash = (hash ^ (unsigned char) str[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static sai_status_t
+switch_sai_addr_parse_mask(uint8_t family, const char *str, size_t len, uint8_t *mask, size_t mask_len)
+{
+    sai_status_t status = SAI_STATUS_SUCCESS;
+    switch_sai_mask_cache_entry_t *entry = NULL;
+    uint8_t tmp[16];
+    uint32_t ip4;
+
+    if (len > SWITCH_SAI_IPV6_STR_MAX) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+    entry = &switch_sai_mask_cache[switch_sai_addr_hash(family, str, len) % SWITCH_SAI_MASK_CACHE_SIZE];
+    if (entry->valid && entry->family == family && entry->len == len && !memcmp(entry->str, str, len)) {
+        memcpy(mask, entry->mask, mask_len);
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if (family == SAI_IP_ADDR_FAMILY_IPV4) {
+        status = switch_sai_addr_parse_ipv4(str, len, &ip4);
+        if (status == SAI_STATUS_SUCCESS) {
+            memcpy(tmp, &ip4, sizeof(ip4));
+        }
+    } else {
+        status = switch_sai_addr_parse_ipv6(str, len, tmp);
+    }
+    if (status != SAI_STATUS_SUCCESS) {
+        return status;
+    }
+
+    entry->valid = true;
+    entry->family = family;
+    entry->len = (uint8_t) len;
+    memcpy(entry->str, str, len);
+    memcpy(entry->mask, tmp, mask_len);
+    memcpy(mask, tmp, mask_len);
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t
+switch_sai_addr_parse_ipv4_mask(const char *str, size_t len, uint32_t *mask)
+{
+    return switch_sai_addr_parse_mask(SAI_IP_ADDR_FAMILY_IPV4, str, len, (uint8_t *) mask, sizeof(*mask));
+}
+
+sai_status_t
+switch_sai_addr_parse_ipv6_mask(const char *str, size_t len, uint8_t *mask)
+{
+    return switch_sai_addr_parse_mask(SAI_IP_ADDR_FAMILY_IPV6, str, len, mask, 16);
+}
@@ -0,0 +1,62 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef __SWITCH_SAI_ADDR_H_
+#define __SWITCH_SAI_ADDR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sai.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* longest textual forms accepted: "xx:xx:xx:xx:xx:xx", "a.b.c.d", full IPv6 */
+#define SWITCH_SAI_MAC_STR_LEN          17
+#define SWITCH_SAI_IPV4_STR_MAX         15
+#define SWITCH_SAI_IPV6_STR_MAX         45
+
+/*
+ * Textual address parsers used by the RPC layer. Input need not be NUL
+ * terminated. Each returns SAI_STATUS_INVALID_PARAMETER and leaves the
+ * output untouched when the string is malformed.
+ *
+ * MAC addresses are accepted as six ':' or '-' separated octets, or as
+ * twelve bare hex digits. IPv4 results are in network byte order.
+ */
+sai_status_t switch_sai_addr_parse_mac(const char *str, size_t len, uint8_t *mac);
+sai_status_t switch_sai_addr_parse_ipv4(const char *str, size_t len, uint32_t *ip4);
+sai_status_t switch_sai_addr_parse_ipv6(const char *str, size_t len, uint8_t *ip6);
+
+/*
+ * Formats mac as "xx:xx:xx:xx:xx:xx" into str, which must hold
+ * SWITCH_SAI_MAC_STR_LEN + 1 bytes.
+ */
+void switch_sai_addr_format_mac(const uint8_t *mac, char *str);
+
+/*
+ * Same as the address parsers, but results are kept in a small per-thread
+ * cache since route and ACL programming keeps sending the same few masks.
+ */
+sai_status_t switch_sai_addr_parse_ipv4_mask(const char *str, size_t len, uint32_t *mask);
+sai_status_t switch_sai_addr_parse_ipv6_mask(const char *str, size_t len, uint8_t *mask);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SWITCH_SAI_ADDR_H_
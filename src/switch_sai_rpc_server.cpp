@@ -19,10 +19,19 @@ limitations under the License.
 
 #include "switch_sai_rpc.h"
 #include <thrift/protocol/TBinaryProtocol.h>
+#include <thrift/protocol/TCompactProtocol.h>
 #include <thrift/server/TSimpleServer.h>
+#include <thrift/server/TThreadPoolServer.h>
+#include <thrift/concurrency/ThreadManager.h>
+#include <thrift/concurrency/PosixThreadFactory.h>
 #include <thrift/transport/TServerSocket.h>
 #include <thrift/transport/TBufferTransports.h>
 #include <arpa/inet.h>
+#include <pthread.h>
+#include <new>
+
+#include "switch_sai_rpc_server.h"
+#include "switch_sai_addr.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -40,61 +49,305 @@ extern "C" {
 #include <saiswitch.h>
 #include <saistatus.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "saiinternal.h"
+#ifdef __cplusplus
+}
+#endif
+
 #include "arpa/inet.h"
 
 using namespace ::apache::thrift;
 using namespace ::apache::thrift::protocol;
 using namespace ::apache::thrift::transport;
 using namespace ::apache::thrift::server;
+using namespace ::apache::thrift::concurrency;
 
 using boost::shared_ptr;
 
 using namespace  ::switch_sai;
 
-class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
+/*
+ * With a thread pool server, handlers run concurrently. Calls into the same
+ * SAI API are serialized so that two clients never interleave inside one
+ * switchapi module, while e.g. ACL and route programming proceed in parallel.
+ * A handler whose API reaches into another API's state takes both locks
+ * through one guard, which acquires them in ascending sai_api_t order; the
+ * hierarchy itself is described in saiinternal.h.
+ */
+static pthread_mutex_t sai_thrift_api_lock[SAI_API_SCHEDULER_GROUP + 1];
+
+#define SAI_THRIFT_API_GUARD_MAX        3
+
+class sai_thrift_api_guard {
  public:
-  switch_sai_rpcHandler() {
-    // Your initialization goes here
+  explicit sai_thrift_api_guard(sai_api_t api) : count_(0) {
+      lock(api);
+  }
+  sai_thrift_api_guard(sai_api_t api1, sai_api_t api2) : count_(0) {
+      lock(api1);
+      lock(api2);
   }
+  sai_thrift_api_guard(sai_api_t api1, sai_api_t api2, sai_api_t api3) : count_(0) {
+      lock(api1);
+      lock(api2);
+      lock(api3);
+  }
+  ~sai_thrift_api_guard() {
+      while (count_) {
+          pthread_mutex_unlock(&sai_thrift_api_lock[apis_[--count_]]);
+      }
+  }
+ private:
+  void lock(sai_api_t api) {
+      // out of order acquisition can deadlock against another handler
+      assert(count_ < SAI_THRIFT_API_GUARD_MAX);
+      assert(!count_ || api > apis_[count_ - 1]);
+      pthread_mutex_lock(&sai_thrift_api_lock[api]);
+      apis_[count_++] = api;
+  }
+  sai_api_t apis_[SAI_THRIFT_API_GUARD_MAX];
+  int count_;
+};
 
-  unsigned int sai_thrift_string_to_mac(const std::string s, unsigned char *m) {
-      unsigned int i, j=0;
-      memset(m, 0, 6);
-      for(i=0;i<s.size();i++) {
-          char let = s.c_str()[i];
-          if (let >= '0' && let <= '9') {
-              m[j/2] = (m[j/2] << 4) + (let - '0'); j++;
-          } else if (let >= 'a' && let <= 'f') {
-              m[j/2] = (m[j/2] << 4) + (let - 'a'+10); j++;
-          } else if (let >= 'A' && let <= 'F') {
-              m[j/2] = (m[j/2] << 4) + (let - 'A'+10); j++;
-          }
+// largest FDB dump page served by one RPC, bigger requests are clamped
+#define SAI_THRIFT_FDB_PAGE_MAX         1024
+
+#define SAI_THRIFT_ARENA_ALIGN          16
+#define SAI_THRIFT_ARENA_INLINE_SIZE    4096
+#define SAI_THRIFT_ARENA_BLOCK_SIZE     65536
+
+/*
+ * Bump allocator for the scratch memory a handler needs while translating
+ * thrift arguments into SAI structures. Small requests are served from the
+ * inline buffer, larger ones chain heap blocks. Everything is released in
+ * one shot when the arena goes out of scope at the end of the handler.
+ */
+class sai_thrift_arena {
+ public:
+  sai_thrift_arena() : blocks_(NULL), cur_(inline_buf_), left_(sizeof(inline_buf_)) {}
+
+  ~sai_thrift_arena() {
+      while (blocks_) {
+          block_t *next = blocks_->next;
+          free(blocks_);
+          blocks_ = next;
       }
-      return (j == 12);
   }
 
-  void sai_thrift_string_to_v4_ip(const std::string s, unsigned int *m) {
-      unsigned char r=0;
-      unsigned int i;
-      *m = 0;
-      for(i=0;i<s.size();i++) {
-          char let = s.c_str()[i];
-          if (let >= '0' && let <= '9') {
-              r = (r * 10) + (let - '0');
-          } else {
-              *m = (*m << 8) | r;
-              r=0;
+  void *alloc(size_t size) {
+      size = (size + SAI_THRIFT_ARENA_ALIGN - 1) & ~((size_t) SAI_THRIFT_ARENA_ALIGN - 1);
+      if (size > left_) {
+          size_t block_size = size > SAI_THRIFT_ARENA_BLOCK_SIZE ? size : SAI_THRIFT_ARENA_BLOCK_SIZE;
+          block_t *block = (block_t *) malloc(sizeof(block_t) + block_size);
+          if (!block) {
+              throw std::bad_alloc();
           }
+          block->next = blocks_;
+          blocks_ = block;
+          cur_ = (char *) (block + 1);
+          left_ = block_size;
       }
-      *m = (*m << 8) | (r & 0xFF);
-      *m = htonl(*m);
-      return;
+      void *ptr = cur_;
+      cur_ += size;
+      left_ -= size;
+      return ptr;
+  }
+
+  template <typename T>
+  T *alloc_array(size_t count) {
+      return (T *) alloc(sizeof(T) * count);
+  }
+
+ private:
+  union block_t {
+      block_t *next;
+      char align[SAI_THRIFT_ARENA_ALIGN];
+  };
+
+  sai_thrift_arena(const sai_thrift_arena &);
+  sai_thrift_arena &operator=(const sai_thrift_arena &);
+
+  block_t *blocks_;
+  char *cur_;
+  size_t left_;
+  alignas(SAI_THRIFT_ARENA_ALIGN) char inline_buf_[SAI_THRIFT_ARENA_INLINE_SIZE];
+};
+
+/*
+ * Attribute translation is table driven: each object type lists the
+ * attribute ids the RPC layer understands together with the union member
+ * the value lives in. Ids not present in a table are passed through with
+ * only the id filled in.
+ */
+typedef enum _sai_thrift_attr_kind_t {
+    SAI_THRIFT_ATTR_KIND_NONE,
+    SAI_THRIFT_ATTR_KIND_BOOL,
+    SAI_THRIFT_ATTR_KIND_U8,
+    SAI_THRIFT_ATTR_KIND_U16,
+    SAI_THRIFT_ATTR_KIND_U32,
+    SAI_THRIFT_ATTR_KIND_S32,
+    SAI_THRIFT_ATTR_KIND_OID,
+    SAI_THRIFT_ATTR_KIND_MAC,
+    SAI_THRIFT_ATTR_KIND_IPADDR,
+    SAI_THRIFT_ATTR_KIND_OBJLIST,
+    SAI_THRIFT_ATTR_KIND_VLANLIST,
+    SAI_THRIFT_ATTR_KIND_CHARDATA,
+    SAI_THRIFT_ATTR_KIND_ACL_DATA_U8,
+    SAI_THRIFT_ATTR_KIND_ACL_DATA_U32,
+    SAI_THRIFT_ATTR_KIND_ACL_DATA_OID,
+    SAI_THRIFT_ATTR_KIND_ACL_DATA_OBJLIST,
+    SAI_THRIFT_ATTR_KIND_ACL_FIELD_U8,
+    SAI_THRIFT_ATTR_KIND_ACL_FIELD_U16,
+    SAI_THRIFT_ATTR_KIND_ACL_FIELD_MAC,
+    SAI_THRIFT_ATTR_KIND_ACL_FIELD_IP4,
+    SAI_THRIFT_ATTR_KIND_ACL_FIELD_IP6
+} sai_thrift_attr_kind_t;
+
+typedef struct _sai_thrift_attr_desc_t {
+    uint32_t id;
+    sai_thrift_attr_kind_t kind;
+} sai_thrift_attr_desc_t;
+
+#define SAI_THRIFT_ATTR_DESC_COUNT(_desc) (sizeof(_desc) / sizeof((_desc)[0]))
+
+static const sai_thrift_attr_desc_t sai_thrift_fdb_attr_desc[] = {
+    { SAI_FDB_ENTRY_ATTR_TYPE, SAI_THRIFT_ATTR_KIND_U8 },
+    { SAI_FDB_ENTRY_ATTR_PORT_ID, SAI_THRIFT_ATTR_KIND_OID },
+    { SAI_FDB_ENTRY_ATTR_PACKET_ACTION, SAI_THRIFT_ATTR_KIND_U8 },
+};
+
+static const sai_thrift_attr_desc_t sai_thrift_fdb_flush_attr_desc[] = {
+    { SAI_FDB_FLUSH_ATTR_PORT_ID, SAI_THRIFT_ATTR_KIND_OID },
+    { SAI_FDB_FLUSH_ATTR_VLAN_ID, SAI_THRIFT_ATTR_KIND_U16 },
+    { SAI_FDB_FLUSH_ATTR_ENTRY_TYPE, SAI_THRIFT_ATTR_KIND_U8 },
+};
+
+static const sai_thrift_attr_desc_t sai_thrift_vr_attr_desc[] = {
+    { SAI_VIRTUAL_ROUTER_ATTR_ADMIN_V4_STATE, SAI_THRIFT_ATTR_KIND_BOOL },
+    { SAI_VIRTUAL_ROUTER_ATTR_ADMIN_V6_STATE, SAI_THRIFT_ATTR_KIND_BOOL },
+    { SAI_VIRTUAL_ROUTER_ATTR_SRC_MAC_ADDRESS, SAI_THRIFT_ATTR_KIND_MAC },
+};
+
+static const sai_thrift_attr_desc_t sai_thrift_route_attr_desc[] = {
+    { SAI_ROUTE_ATTR_NEXT_HOP_ID, SAI_THRIFT_ATTR_KIND_OID },
+    { SAI_ROUTE_ATTR_PACKET_ACTION, SAI_THRIFT_ATTR_KIND_S32 },
+    { SAI_ROUTE_ATTR_TRAP_PRIORITY, SAI_THRIFT_ATTR_KIND_U8 },
+};
+
+static const sai_thrift_attr_desc_t sai_thrift_router_interface_attr_desc[] = {
+    { SAI_ROUTER_INTERFACE_ATTR_VIRTUAL_ROUTER_ID, SAI_THRIFT_ATTR_KIND_OID },
+    { SAI_ROUTER_INTERFACE_ATTR_PORT_ID, SAI_THRIFT_ATTR_KIND_OID },
+    { SAI_ROUTER_INTERFACE_ATTR_TYPE, SAI_THRIFT_ATTR_KIND_U8 },
+    { SAI_ROUTER_INTERFACE_ATTR_VLAN_ID, SAI_THRIFT_ATTR_KIND_U16 },
+    { SAI_ROUTER_INTERFACE_ATTR_SRC_MAC_ADDRESS, SAI_THRIFT_ATTR_KIND_MAC },
+    { SAI_ROUTER_INTERFACE_ATTR_ADMIN_V4_STATE, SAI_THRIFT_ATTR_KIND_BOOL },
+    { SAI_ROUTER_INTERFACE_ATTR_ADMIN_V6_STATE, SAI_THRIFT_ATTR_KIND_BOOL },
+};
+
+static const sai_thrift_attr_desc_t sai_thrift_next_hop_attr_desc[] = {
+    { SAI_NEXT_HOP_ATTR_TYPE, SAI_THRIFT_ATTR_KIND_U8 },
+    { SAI_NEXT_HOP_ATTR_IP, SAI_THRIFT_ATTR_KIND_IPADDR },
+    { SAI_NEXT_HOP_ATTR_ROUTER_INTERFACE_ID, SAI_THRIFT_ATTR_KIND_OID },
+};
+
+static const sai_thrift_attr_desc_t sai_thrift_next_hop_group_attr_desc[] = {
+    { SAI_NEXT_HOP_GROUP_ATTR_TYPE, SAI_THRIFT_ATTR_KIND_U8 },
+    { SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_COUNT, SAI_THRIFT_ATTR_KIND_U32 },
+    { SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_LIST, SAI_THRIFT_ATTR_KIND_OBJLIST },
+};
+
+static const sai_thrift_attr_desc_t sai_thrift_lag_attr_desc[] = {
+    { SAI_LAG_ATTR_PORT_LIST, SAI_THRIFT_ATTR_KIND_OBJLIST },
+};
+
+static const sai_thrift_attr_desc_t sai_thrift_stp_attr_desc[] = {
+    { SAI_STP_ATTR_VLAN_LIST, SAI_THRIFT_ATTR_KIND_VLANLIST },
+};
+
+static const sai_thrift_attr_desc_t sai_thrift_neighbor_attr_desc[] = {
+    { SAI_NEIGHBOR_ATTR_DST_MAC_ADDRESS, SAI_THRIFT_ATTR_KIND_MAC },
+    { SAI_NEIGHBOR_ATTR_PACKET_ACTION, SAI_THRIFT_ATTR_KIND_S32 },
+};
+
+static const sai_thrift_attr_desc_t sai_thrift_switch_attr_desc[] = {
+    { SAI_SWITCH_ATTR_SRC_MAC_ADDRESS, SAI_THRIFT_ATTR_KIND_MAC },
+    { SAI_SWITCH_ATTR_FDB_AGING_TIME, SAI_THRIFT_ATTR_KIND_U32 },
+    { SAI_SWITCH_ATTR_CUSTOM_FDB_EVENT_INTERVAL, SAI_THRIFT_ATTR_KIND_U32 },
+    { SAI_SWITCH_ATTR_CUSTOM_FDB_EVENT_BATCH_SIZE, SAI_THRIFT_ATTR_KIND_U32 },
+};
+
+static const sai_thrift_attr_desc_t sai_thrift_hostif_attr_desc[] = {
+    { SAI_HOSTIF_ATTR_TYPE, SAI_THRIFT_ATTR_KIND_U32 },
+    { SAI_HOSTIF_ATTR_RIF_OR_PORT_ID, SAI_THRIFT_ATTR_KIND_OID },
+    { SAI_HOSTIF_ATTR_NAME, SAI_THRIFT_ATTR_KIND_CHARDATA },
+};
+
+static const sai_thrift_attr_desc_t sai_thrift_hostif_trap_group_attr_desc[] = {
+    { SAI_HOSTIF_TRAP_GROUP_ATTR_QUEUE, SAI_THRIFT_ATTR_KIND_U32 },
+    { SAI_HOSTIF_TRAP_GROUP_ATTR_PRIO, SAI_THRIFT_ATTR_KIND_U32 },
+};
+
+static const sai_thrift_attr_desc_t sai_thrift_hostif_trap_attr_desc[] = {
+    { SAI_HOSTIF_TRAP_ATTR_PACKET_ACTION, SAI_THRIFT_ATTR_KIND_U32 },
+    { SAI_HOSTIF_TRAP_ATTR_TRAP_PRIORITY, SAI_THRIFT_ATTR_KIND_U32 },
+    { SAI_HOSTIF_TRAP_ATTR_TRAP_CHANNEL, SAI_THRIFT_ATTR_KIND_U32 },
+    { SAI_HOSTIF_TRAP_ATTR_TRAP_GROUP, SAI_THRIFT_ATTR_KIND_OID },
+};
+
+static const sai_thrift_attr_desc_t sai_thrift_acl_entry_attr_desc[] = {
+    { SAI_ACL_ENTRY_ATTR_TABLE_ID, SAI_THRIFT_ATTR_KIND_ACL_DATA_OID },
+    { SAI_ACL_ENTRY_ATTR_PRIORITY, SAI_THRIFT_ATTR_KIND_ACL_DATA_U32 },
+    { SAI_ACL_ENTRY_ATTR_ADMIN_STATE, SAI_THRIFT_ATTR_KIND_ACL_DATA_U8 },
+    { SAI_ACL_ENTRY_ATTR_FIELD_SRC_IPv6, SAI_THRIFT_ATTR_KIND_ACL_FIELD_IP6 },
+    { SAI_ACL_ENTRY_ATTR_FIELD_DST_IPv6, SAI_THRIFT_ATTR_KIND_ACL_FIELD_IP6 },
+    { SAI_ACL_ENTRY_ATTR_FIELD_SRC_MAC, SAI_THRIFT_ATTR_KIND_ACL_FIELD_MAC },
+    { SAI_ACL_ENTRY_ATTR_FIELD_DST_MAC, SAI_THRIFT_ATTR_KIND_ACL_FIELD_MAC },
+    { SAI_ACL_ENTRY_ATTR_FIELD_SRC_IP, SAI_THRIFT_ATTR_KIND_ACL_FIELD_IP4 },
+    { SAI_ACL_ENTRY_ATTR_FIELD_DST_IP, SAI_THRIFT_ATTR_KIND_ACL_FIELD_IP4 },
+    { SAI_ACL_ENTRY_ATTR_FIELD_IN_PORT, SAI_THRIFT_ATTR_KIND_ACL_DATA_OID },
+    { SAI_ACL_ENTRY_ATTR_FIELD_IN_PORTS, SAI_THRIFT_ATTR_KIND_ACL_DATA_OBJLIST },
+    { SAI_ACL_ENTRY_ATTR_FIELD_OUTER_VLAN_ID, SAI_THRIFT_ATTR_KIND_ACL_FIELD_U16 },
+    { SAI_ACL_ENTRY_ATTR_FIELD_INNER_VLAN_ID, SAI_THRIFT_ATTR_KIND_ACL_FIELD_U16 },
+    { SAI_ACL_ENTRY_ATTR_FIELD_L4_SRC_PORT, SAI_THRIFT_ATTR_KIND_ACL_FIELD_U16 },
+    { SAI_ACL_ENTRY_ATTR_FIELD_L4_DST_PORT, SAI_THRIFT_ATTR_KIND_ACL_FIELD_U16 },
+    { SAI_ACL_ENTRY_ATTR_FIELD_ETHER_TYPE, SAI_THRIFT_ATTR_KIND_ACL_FIELD_U16 },
+    { SAI_ACL_ENTRY_ATTR_FIELD_IP_PROTOCOL, SAI_THRIFT_ATTR_KIND_ACL_FIELD_U8 },
+    { SAI_ACL_ENTRY_ATTR_FIELD_DSCP, SAI_THRIFT_ATTR_KIND_ACL_FIELD_U8 },
+    { SAI_ACL_ENTRY_ATTR_FIELD_ECN, SAI_THRIFT_ATTR_KIND_ACL_FIELD_U8 },
+    { SAI_ACL_ENTRY_ATTR_FIELD_TTL, SAI_THRIFT_ATTR_KIND_ACL_FIELD_U8 },
+    { SAI_ACL_ENTRY_ATTR_FIELD_TOS, SAI_THRIFT_ATTR_KIND_ACL_FIELD_U8 },
+    { SAI_ACL_ENTRY_ATTR_FIELD_TCP_FLAGS, SAI_THRIFT_ATTR_KIND_ACL_FIELD_U8 },
+    { SAI_ACL_ENTRY_ATTR_FIELD_TC, SAI_THRIFT_ATTR_KIND_ACL_FIELD_U8 },
+    { SAI_ACL_ENTRY_ATTR_FIELD_IPv6_FLOW_LABEL, SAI_THRIFT_ATTR_KIND_ACL_FIELD_U16 },
+};
+
+class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
+ public:
+  switch_sai_rpcHandler() {
+    // Your initialization goes here
+  }
+
+  sai_status_t sai_thrift_string_to_mac(const std::string &s, unsigned char *m) {
+      return switch_sai_addr_parse_mac(s.data(), s.size(), m);
   }
 
-  void sai_thrift_string_to_v6_ip(const std::string s, unsigned char *v6_ip) {
-      const char *v6_str = s.c_str();
-      inet_pton(AF_INET6, v6_str, v6_ip);
-      return;
+  sai_status_t sai_thrift_string_to_v4_ip(const std::string &s, unsigned int *m) {
+      return switch_sai_addr_parse_ipv4(s.data(), s.size(), m);
+  }
+
+  sai_status_t sai_thrift_string_to_v6_ip(const std::string &s, unsigned char *v6_ip) {
+      return switch_sai_addr_parse_ipv6(s.data(), s.size(), v6_ip);
+  }
+
+  sai_status_t sai_thrift_string_to_v4_mask(const std::string &s, unsigned int *m) {
+      return switch_sai_addr_parse_ipv4_mask(s.data(), s.size(), m);
+  }
+
+  sai_status_t sai_thrift_string_to_v6_mask(const std::string &s, unsigned char *v6_mask) {
+      return switch_sai_addr_parse_ipv6_mask(s.data(), s.size(), v6_mask);
   }
 
   void sai_thrift_parse_object_id_list(const std::vector<sai_thrift_object_id_t> & thrift_object_id_list, sai_object_id_t *object_id_list) {
@@ -105,341 +358,297 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
   }
 
   void sai_thrift_parse_vlan_port_id_list(const std::vector<sai_thrift_vlan_port_t> & thrift_port_list, sai_vlan_port_t *port_list) {
-      std::vector<sai_thrift_vlan_port_t>::const_iterator it = thrift_port_list.begin();
-      sai_thrift_vlan_port_t thrift_vlan_port;
-      for(uint32_t i = 0; i < thrift_port_list.size(); i++, it++) {
-          thrift_vlan_port = (sai_thrift_vlan_port_t)*it;
+      for(uint32_t i = 0; i < thrift_port_list.size(); i++) {
+          const sai_thrift_vlan_port_t &thrift_vlan_port = thrift_port_list[i];
           port_list[i].port_id = thrift_vlan_port.port_id;
           port_list[i].tagging_mode = (sai_vlan_tagging_mode_t) thrift_vlan_port.tagging_mode;
       }
   }
 
-  void sai_thrift_parse_ip_address(const sai_thrift_ip_address_t &thrift_ip_address, sai_ip_address_t *ip_address) {
+  sai_status_t sai_thrift_parse_ip_address(const sai_thrift_ip_address_t &thrift_ip_address, sai_ip_address_t *ip_address) {
       ip_address->addr_family = (sai_ip_addr_family_t) thrift_ip_address.addr_family;
       if ((sai_ip_addr_family_t)thrift_ip_address.addr_family == SAI_IP_ADDR_FAMILY_IPV4) {
-          sai_thrift_string_to_v4_ip(thrift_ip_address.addr.ip4, &ip_address->addr.ip4);
+          return sai_thrift_string_to_v4_ip(thrift_ip_address.addr.ip4, &ip_address->addr.ip4);
       } else {
-          sai_thrift_string_to_v6_ip(thrift_ip_address.addr.ip6, ip_address->addr.ip6);
+          return sai_thrift_string_to_v6_ip(thrift_ip_address.addr.ip6, ip_address->addr.ip6);
       }
   }
 
-  void sai_thrift_parse_ip_prefix(const sai_thrift_ip_prefix_t &thrift_ip_prefix, sai_ip_prefix_t *ip_prefix) {
+  sai_status_t sai_thrift_parse_ip_prefix(const sai_thrift_ip_prefix_t &thrift_ip_prefix, sai_ip_prefix_t *ip_prefix) {
+      sai_status_t status = SAI_STATUS_SUCCESS;
       ip_prefix->addr_family = (sai_ip_addr_family_t) thrift_ip_prefix.addr_family;
       if ((sai_ip_addr_family_t)thrift_ip_prefix.addr_family == SAI_IP_ADDR_FAMILY_IPV4) {
-          sai_thrift_string_to_v4_ip(thrift_ip_prefix.addr.ip4, &ip_prefix->addr.ip4);
-          sai_thrift_string_to_v4_ip(thrift_ip_prefix.mask.ip4, &ip_prefix->mask.ip4);
+          status = sai_thrift_string_to_v4_ip(thrift_ip_prefix.addr.ip4, &ip_prefix->addr.ip4);
+          if (status == SAI_STATUS_SUCCESS) {
+              status = sai_thrift_string_to_v4_mask(thrift_ip_prefix.mask.ip4, &ip_prefix->mask.ip4);
+          }
       } else {
-          sai_thrift_string_to_v6_ip(thrift_ip_prefix.addr.ip6, ip_prefix->addr.ip6);
-          sai_thrift_string_to_v6_ip(thrift_ip_prefix.mask.ip6, ip_prefix->mask.ip6);
+          status = sai_thrift_string_to_v6_ip(thrift_ip_prefix.addr.ip6, ip_prefix->addr.ip6);
+          if (status == SAI_STATUS_SUCCESS) {
+              status = sai_thrift_string_to_v6_mask(thrift_ip_prefix.mask.ip6, ip_prefix->mask.ip6);
+          }
       }
+      return status;
   }
 
-  void sai_thrift_parse_fdb_entry(const sai_thrift_fdb_entry_t &thrift_fdb_entry, sai_fdb_entry_t *fdb_entry) {
+  sai_status_t sai_thrift_parse_fdb_entry(const sai_thrift_fdb_entry_t &thrift_fdb_entry, sai_fdb_entry_t *fdb_entry) {
       fdb_entry->vlan_id = (sai_vlan_id_t) thrift_fdb_entry.vlan_id;
-      sai_thrift_string_to_mac(thrift_fdb_entry.mac_address, fdb_entry->mac_address);
+      return sai_thrift_string_to_mac(thrift_fdb_entry.mac_address, fdb_entry->mac_address);
   }
 
-  void sai_thrift_parse_unicast_route_entry(const sai_thrift_unicast_route_entry_t &thrift_unicast_route_entry, sai_unicast_route_entry_t *unicast_route_entry) {
+  sai_status_t sai_thrift_parse_unicast_route_entry(const sai_thrift_unicast_route_entry_t &thrift_unicast_route_entry, sai_unicast_route_entry_t *unicast_route_entry) {
       unicast_route_entry->vr_id = (sai_object_id_t) thrift_unicast_route_entry.vr_id;
-      sai_thrift_parse_ip_prefix(thrift_unicast_route_entry.destination, &unicast_route_entry->destination);
+      return sai_thrift_parse_ip_prefix(thrift_unicast_route_entry.destination, &unicast_route_entry->destination);
   }
 
-  void sai_thrift_parse_neighbor_entry(const sai_thrift_neighbor_entry_t &thrift_neighbor_entry, sai_neighbor_entry_t *neighbor_entry) {
+  sai_status_t sai_thrift_parse_neighbor_entry(const sai_thrift_neighbor_entry_t &thrift_neighbor_entry, sai_neighbor_entry_t *neighbor_entry) {
       neighbor_entry->rif_id = (sai_object_id_t) thrift_neighbor_entry.rif_id;
-      sai_thrift_parse_ip_address(thrift_neighbor_entry.ip_address, &neighbor_entry->ip_address);
-  }
-
-  void sai_thrift_parse_fdb_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list) {
-      std::vector<sai_thrift_attribute_t>::const_iterator it = thrift_attr_list.begin();
-      sai_thrift_attribute_t attribute;
-      for(uint32_t i = 0; i < thrift_attr_list.size(); i++, it++) {
-          attribute = (sai_thrift_attribute_t)*it;
-          attr_list[i].id = attribute.id;
-          switch (attribute.id) {
-              case SAI_FDB_ENTRY_ATTR_TYPE:
-                  attr_list[i].value.u8 = attribute.value.u8;
-                  break;
-              case SAI_FDB_ENTRY_ATTR_PORT_ID:
-                  attr_list[i].value.oid = attribute.value.oid;
-                  break;
-              case SAI_FDB_ENTRY_ATTR_PACKET_ACTION:
-                  attr_list[i].value.u8 = attribute.value.u8;
-                  break;
-              default:
-                  break;
-          }
-      }
+      return sai_thrift_parse_ip_address(thrift_neighbor_entry.ip_address, &neighbor_entry->ip_address);
   }
 
-  void sai_thrift_parse_fdb_flush_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list) {
-      std::vector<sai_thrift_attribute_t>::const_iterator it = thrift_attr_list.begin();
-      sai_thrift_attribute_t attribute;
-      for(uint32_t i = 0; i < thrift_attr_list.size(); i++, it++) {
-          attribute = (sai_thrift_attribute_t)*it;
-          attr_list[i].id = attribute.id;
-          switch (attribute.id) {
-              case SAI_FDB_FLUSH_ATTR_PORT_ID:
-                  attr_list[i].value.oid = (sai_object_id_t) attribute.value.oid;
-                  break;
-              case SAI_FDB_FLUSH_ATTR_VLAN_ID:
-                  attr_list[i].value.u16 = attribute.value.u16;
-                  break;
-              case SAI_FDB_FLUSH_ATTR_ENTRY_TYPE:
-                  attr_list[i].value.u8 = attribute.value.u8;
-                  break;
+  static const sai_thrift_attr_desc_t *sai_thrift_attr_desc_find(const sai_thrift_attr_desc_t *desc, uint32_t desc_count, uint32_t id) {
+      for (uint32_t i = 0; i < desc_count; i++) {
+          if (desc[i].id == id) {
+              return &desc[i];
           }
       }
+      return NULL;
   }
 
-  void sai_thrift_parse_vr_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list) {
-      std::vector<sai_thrift_attribute_t>::const_iterator it = thrift_attr_list.begin();
-      sai_thrift_attribute_t attribute;
-      for(uint32_t i = 0; i < thrift_attr_list.size(); i++, it++) {
-          attribute = (sai_thrift_attribute_t)*it;
-          attr_list[i].id = attribute.id;
-          switch (attribute.id) {
-              case SAI_VIRTUAL_ROUTER_ATTR_ADMIN_V4_STATE:
-              case SAI_VIRTUAL_ROUTER_ATTR_ADMIN_V6_STATE:
-                  attr_list[i].value.booldata = attribute.value.booldata;
-                  break;
-              case SAI_VIRTUAL_ROUTER_ATTR_SRC_MAC_ADDRESS:
-                  sai_thrift_string_to_mac(attribute.value.mac, attr_list[i].value.mac);
-                  break;
-          }
-      }
+  void sai_thrift_parse_object_list(const std::vector<sai_thrift_object_id_t> &thrift_object_id_list, sai_object_list_t *object_list, sai_thrift_arena &arena) {
+      object_list->count = thrift_object_id_list.size();
+      object_list->list = arena.alloc_array<sai_object_id_t>(object_list->count);
+      sai_thrift_parse_object_id_list(thrift_object_id_list, object_list->list);
   }
 
-  void sai_thrift_parse_route_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list) {
-      std::vector<sai_thrift_attribute_t>::const_iterator it = thrift_attr_list.begin();
-      sai_thrift_attribute_t attribute;
-      for(uint32_t i = 0; i < thrift_attr_list.size(); i++, it++) {
-          attribute = (sai_thrift_attribute_t)*it;
-          attr_list[i].id = attribute.id;
-          switch (attribute.id) {
-              case SAI_ROUTE_ATTR_NEXT_HOP_ID:
-                  attr_list[i].value.oid = attribute.value.oid;
-                  break;
-              default:
-                  break;
-          }
+  sai_status_t sai_thrift_parse_attribute_value(sai_thrift_attr_kind_t kind, const sai_thrift_attribute_value_t &thrift_value, sai_attribute_value_t *value, sai_thrift_arena &arena) {
+      sai_status_t status = SAI_STATUS_SUCCESS;
+      switch (kind) {
+          case SAI_THRIFT_ATTR_KIND_BOOL:
+              value->booldata = thrift_value.booldata;
+              break;
+          case SAI_THRIFT_ATTR_KIND_U8:
+              value->u8 = thrift_value.u8;
+              break;
+          case SAI_THRIFT_ATTR_KIND_U16:
+              value->u16 = thrift_value.u16;
+              break;
+          case SAI_THRIFT_ATTR_KIND_U32:
+              value->u32 = thrift_value.u32;
+              break;
+          case SAI_THRIFT_ATTR_KIND_S32:
+              value->s32 = thrift_value.s32;
+              break;
+          case SAI_THRIFT_ATTR_KIND_OID:
+              value->oid = (sai_object_id_t) thrift_value.oid;
+              break;
+          case SAI_THRIFT_ATTR_KIND_MAC:
+              status = sai_thrift_string_to_mac(thrift_value.mac, value->mac);
+              break;
+          case SAI_THRIFT_ATTR_KIND_IPADDR:
+              status = sai_thrift_parse_ip_address(thrift_value.ipaddr, &value->ipaddr);
+              break;
+          case SAI_THRIFT_ATTR_KIND_OBJLIST:
+              sai_thrift_parse_object_list(thrift_value.objlist.object_id_list, &value->objlist, arena);
+              break;
+          case SAI_THRIFT_ATTR_KIND_VLANLIST:
+              {
+                  const std::vector<sai_thrift_vlan_id_t> &thrift_vlan_list = thrift_value.vlanlist.vlan_list;
+                  value->vlanlist.vlan_count = thrift_vlan_list.size();
+                  value->vlanlist.vlan_list = arena.alloc_array<sai_vlan_id_t>(thrift_vlan_list.size());
+                  for (uint32_t j = 0; j < thrift_vlan_list.size(); j++) {
+                      value->vlanlist.vlan_list[j] = (sai_vlan_id_t) thrift_vlan_list[j];
+                  }
+              }
+              break;
+          case SAI_THRIFT_ATTR_KIND_CHARDATA:
+              {
+                  size_t len = thrift_value.chardata.size();
+                  if (len > HOSTIF_NAME_SIZE) {
+                      len = HOSTIF_NAME_SIZE;
+                  }
+                  memset(value->chardata, 0, HOSTIF_NAME_SIZE);
+                  memcpy(value->chardata, thrift_value.chardata.data(), len);
+              }
+              break;
+          case SAI_THRIFT_ATTR_KIND_ACL_DATA_U8:
+              value->aclfield.data.u8 = thrift_value.aclfield.data.u8;
+              break;
+          case SAI_THRIFT_ATTR_KIND_ACL_DATA_U32:
+              value->aclfield.data.u32 = thrift_value.aclfield.data.u32;
+              break;
+          case SAI_THRIFT_ATTR_KIND_ACL_DATA_OID:
+              value->aclfield.data.oid = (sai_object_id_t) thrift_value.aclfield.data.oid;
+              break;
+          case SAI_THRIFT_ATTR_KIND_ACL_DATA_OBJLIST:
+              sai_thrift_parse_object_list(thrift_value.aclfield.data.objlist.object_id_list, &value->aclfield.data.objlist, arena);
+              break;
+          case SAI_THRIFT_ATTR_KIND_ACL_FIELD_U8:
+              value->aclfield.data.u8 = thrift_value.aclfield.data.u8;
+              value->aclfield.mask.u8 = thrift_value.aclfield.mask.u8;
+              break;
+          case SAI_THRIFT_ATTR_KIND_ACL_FIELD_U16:
+              value->aclfield.data.u16 = thrift_value.aclfield.data.u16;
+              value->aclfield.mask.u16 = thrift_value.aclfield.mask.u16;
+              break;
+          case SAI_THRIFT_ATTR_KIND_ACL_FIELD_MAC:
+              status = sai_thrift_string_to_mac(thrift_value.aclfield.data.mac, value->aclfield.data.mac);
+              if (status == SAI_STATUS_SUCCESS) {
+                  status = sai_thrift_string_to_mac(thrift_value.aclfield.mask.mac, value->aclfield.mask.mac);
+              }
+              break;
+          case SAI_THRIFT_ATTR_KIND_ACL_FIELD_IP4:
+              status = sai_thrift_string_to_v4_ip(thrift_value.aclfield.data.ip4, &value->aclfield.data.ip4);
+              if (status == SAI_STATUS_SUCCESS) {
+                  status = sai_thrift_string_to_v4_mask(thrift_value.aclfield.mask.ip4, &value->aclfield.mask.ip4);
+              }
+              break;
+          case SAI_THRIFT_ATTR_KIND_ACL_FIELD_IP6:
+              status = sai_thrift_string_to_v6_ip(thrift_value.aclfield.data.ip6, value->aclfield.data.ip6);
+              if (status == SAI_STATUS_SUCCESS) {
+                  status = sai_thrift_string_to_v6_mask(thrift_value.aclfield.mask.ip6, value->aclfield.mask.ip6);
+              }
+              break;
+          case SAI_THRIFT_ATTR_KIND_NONE:
+          default:
+              break;
       }
+      return status;
   }
 
-  void sai_thrift_parse_router_interface_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list) {
-      std::vector<sai_thrift_attribute_t>::const_iterator it = thrift_attr_list.begin();
-      sai_thrift_attribute_t attribute;
-      for(uint32_t i = 0; i < thrift_attr_list.size(); i++, it++) {
-          attribute = (sai_thrift_attribute_t)*it;
-          attr_list[i].id = attribute.id;
-          switch (attribute.id) {
-              case SAI_ROUTER_INTERFACE_ATTR_VIRTUAL_ROUTER_ID:
-              case SAI_ROUTER_INTERFACE_ATTR_PORT_ID:
-                  attr_list[i].value.oid = attribute.value.oid;
-                  break;
-              case SAI_ROUTER_INTERFACE_ATTR_TYPE:
-                  attr_list[i].value.u8 = attribute.value.u8;
-                  break;
-              case SAI_ROUTER_INTERFACE_ATTR_VLAN_ID:
-                  attr_list[i].value.u16 = attribute.value.u16;
-                  break;
-              case SAI_ROUTER_INTERFACE_ATTR_SRC_MAC_ADDRESS:
-                  sai_thrift_string_to_mac(attribute.value.mac, attr_list[i].value.mac);
-                  break;
-              case SAI_ROUTER_INTERFACE_ATTR_ADMIN_V4_STATE:
-              case SAI_ROUTER_INTERFACE_ATTR_ADMIN_V6_STATE:
-                  attr_list[i].value.booldata = attribute.value.booldata;
-                  break;
-              default:
-                  break;
-          }
+  sai_status_t sai_thrift_parse_attribute(const sai_thrift_attr_desc_t *desc, uint32_t desc_count, const sai_thrift_attribute_t &thrift_attr, sai_attribute_t *attr, sai_thrift_arena &arena) {
+      const sai_thrift_attr_desc_t *attr_desc = sai_thrift_attr_desc_find(desc, desc_count, thrift_attr.id);
+      attr->id = thrift_attr.id;
+      if (!attr_desc) {
+          return SAI_STATUS_SUCCESS;
       }
+      return sai_thrift_parse_attribute_value(attr_desc->kind, thrift_attr.value, &attr->value, arena);
   }
 
-  void sai_thrift_parse_next_hop_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list) {
-      std::vector<sai_thrift_attribute_t>::const_iterator it = thrift_attr_list.begin();
-      sai_thrift_attribute_t attribute;
-      for(uint32_t i = 0; i < thrift_attr_list.size(); i++, it++) {
-          attribute = (sai_thrift_attribute_t)*it;
-          attr_list[i].id = attribute.id;
-          switch (attribute.id) {
-              case SAI_NEXT_HOP_ATTR_TYPE:
-                  attr_list[i].value.u8 = attribute.value.u8;
-                  break;
-              case SAI_NEXT_HOP_ATTR_IP:
-                  sai_thrift_parse_ip_address(attribute.value.ipaddr, &attr_list[i].value.ipaddr);
-                  break;
-              case SAI_NEXT_HOP_ATTR_ROUTER_INTERFACE_ID:
-                  attr_list[i].value.oid = attribute.value.oid;
-                  break;
+  sai_status_t sai_thrift_parse_attributes(const sai_thrift_attr_desc_t *desc, uint32_t desc_count, const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list, sai_thrift_arena &arena) {
+      sai_status_t status = SAI_STATUS_SUCCESS;
+      for (uint32_t i = 0; i < thrift_attr_list.size(); i++) {
+          status = sai_thrift_parse_attribute(desc, desc_count, thrift_attr_list[i], &attr_list[i], arena);
+          if (status != SAI_STATUS_SUCCESS) {
+              return status;
           }
       }
+      return status;
   }
 
-  void sai_thrift_parse_next_hop_group_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list, sai_object_id_t **nhop_list) {
-      std::vector<sai_thrift_attribute_t>::const_iterator it1 = thrift_attr_list.begin();
-      sai_thrift_attribute_t attribute;
-      for(uint32_t i = 0; i < thrift_attr_list.size(); i++, it1++) {
-          attribute = (sai_thrift_attribute_t)*it1;
-          attr_list[i].id = attribute.id;
-          switch (attribute.id) {
-              case SAI_NEXT_HOP_GROUP_ATTR_TYPE:
-                  attr_list[i].value.u8 = attribute.value.u8;
-                  break;
-              case SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_COUNT:
-                  attr_list[i].value.u32 = attribute.value.u32;
-                  break;
-              case SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_LIST:
-                  *nhop_list = (sai_object_id_t *) malloc(sizeof(sai_object_id_t) * attribute.value.objlist.count);
-                  std::vector<sai_thrift_object_id_t>::const_iterator it2 = attribute.value.objlist.object_id_list.begin();
-                  for (uint32_t j = 0; j < attribute.value.objlist.object_id_list.size(); j++, *it2++) {
-                      (*nhop_list)[j] = (sai_object_id_t) *it2;
-                  }
-                  attr_list[i].value.objlist.count = attribute.value.objlist.count;
-                  attr_list[i].value.objlist.list = *nhop_list;
-                  break;
-          }
-      }
+  sai_status_t sai_thrift_parse_fdb_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attributes(sai_thrift_fdb_attr_desc, SAI_THRIFT_ATTR_DESC_COUNT(sai_thrift_fdb_attr_desc),
+                                         thrift_attr_list, attr_list, arena);
   }
 
-  void sai_thrift_parse_lag_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list, sai_object_id_t **port_list) {
-      std::vector<sai_thrift_attribute_t>::const_iterator it1 = thrift_attr_list.begin();
-      sai_thrift_attribute_t attribute;
-      for(uint32_t i = 0; i < thrift_attr_list.size(); i++, it1++) {
-          attribute = (sai_thrift_attribute_t)*it1;
-          attr_list[i].id = attribute.id;
-          switch (attribute.id) {
-              case SAI_LAG_ATTR_PORT_LIST:
-                  *port_list = (sai_object_id_t *) malloc(sizeof(sai_object_id_t) * attribute.value.objlist.count);
-                  std::vector<sai_thrift_object_id_t>::const_iterator it2 = attribute.value.objlist.object_id_list.begin();
-                  for (uint32_t j = 0; j < attribute.value.objlist.object_id_list.size(); j++, it2++) {
-                      (*port_list)[j] = (sai_object_id_t) *it2;
-                  }
-                  attr_list[i].value.objlist.count = attribute.value.objlist.count;
-                  attr_list[i].value.objlist.list = *port_list;
-                  break;
-          }
-      }
+  sai_status_t sai_thrift_parse_fdb_attribute(const sai_thrift_attribute_t &thrift_attr, sai_attribute_t *attr, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attribute(sai_thrift_fdb_attr_desc, SAI_THRIFT_ATTR_DESC_COUNT(sai_thrift_fdb_attr_desc),
+                                        thrift_attr, attr, arena);
   }
 
-  void sai_thrift_parse_stp_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list, sai_vlan_id_t **vlan_list) {
-      std::vector<sai_thrift_attribute_t>::const_iterator it1 = thrift_attr_list.begin();
-      sai_thrift_attribute_t attribute;
-      for(uint32_t i = 0; i < thrift_attr_list.size(); i++, it1++) {
-          attribute = (sai_thrift_attribute_t)*it1;
-          attr_list[i].id = attribute.id;
-          switch (attribute.id) {
-              case SAI_STP_ATTR_VLAN_LIST:
-                  *vlan_list = (sai_vlan_id_t *) malloc(sizeof(sai_vlan_id_t) * attribute.value.vlanlist.vlan_count);
-                  std::vector<sai_thrift_vlan_id_t>::const_iterator it2 = attribute.value.vlanlist.vlan_list.begin();
-                  for (uint32_t j = 0; j < attribute.value.vlanlist.vlan_list.size(); j++, *it2++) {
-                      *vlan_list[j] = (sai_vlan_id_t) *it2;
-                  }
-                  attr_list[i].value.vlanlist.vlan_count = attribute.value.vlanlist.vlan_count;
-                  attr_list[i].value.vlanlist.vlan_list = *vlan_list;
-                  break;
-          }
-      }
+  sai_status_t sai_thrift_parse_fdb_flush_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attributes(sai_thrift_fdb_flush_attr_desc, SAI_THRIFT_ATTR_DESC_COUNT(sai_thrift_fdb_flush_attr_desc),
+                                         thrift_attr_list, attr_list, arena);
   }
 
-  void sai_thrift_parse_neighbor_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list) {
-      std::vector<sai_thrift_attribute_t>::const_iterator it1 = thrift_attr_list.begin();
-      sai_thrift_attribute_t attribute;
-      for(uint32_t i = 0; i < thrift_attr_list.size(); i++, it1++) {
-          attribute = (sai_thrift_attribute_t)*it1;
-          attr_list[i].id = attribute.id;
-          switch (attribute.id) {
-              case SAI_NEIGHBOR_ATTR_DST_MAC_ADDRESS:
-                  sai_thrift_string_to_mac(attribute.value.mac, attr_list[i].value.mac);
-                  break;
-          }
-      }
+  sai_status_t sai_thrift_parse_vr_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attributes(sai_thrift_vr_attr_desc, SAI_THRIFT_ATTR_DESC_COUNT(sai_thrift_vr_attr_desc),
+                                         thrift_attr_list, attr_list, arena);
   }
 
-  void sai_thrift_parse_hostif_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list) {
-      std::vector<sai_thrift_attribute_t>::const_iterator it1 = thrift_attr_list.begin();
-      sai_thrift_attribute_t attribute;
-      for(uint32_t i = 0; i < thrift_attr_list.size(); i++, it1++) {
-          attribute = (sai_thrift_attribute_t)*it1;
-          attr_list[i].id = attribute.id;
-          switch (attribute.id) {
-              case SAI_HOSTIF_ATTR_TYPE:
-                  attr_list[i].value.u32 = attribute.value.u32;
-                  break;
-              case SAI_HOSTIF_ATTR_RIF_OR_PORT_ID:
-                  attr_list[i].value.oid = attribute.value.oid;
-                  break;
-              case SAI_HOSTIF_ATTR_NAME:
-                  memcpy(attr_list[i].value.chardata, attribute.value.chardata.c_str(), HOSTIF_NAME_SIZE);
-                  break;
-          }
-      }
+  sai_status_t sai_thrift_parse_route_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attributes(sai_thrift_route_attr_desc, SAI_THRIFT_ATTR_DESC_COUNT(sai_thrift_route_attr_desc),
+                                         thrift_attr_list, attr_list, arena);
   }
 
-  void sai_thrift_parse_hostif_trap_group_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list) {
-      std::vector<sai_thrift_attribute_t>::const_iterator it1 = thrift_attr_list.begin();
-      sai_thrift_attribute_t attribute;
-      for(uint32_t i = 0; i < thrift_attr_list.size(); i++, it1++) {
-          attribute = (sai_thrift_attribute_t)*it1;
-          attr_list[i].id = attribute.id;
-          switch (attribute.id) {
-              case SAI_HOSTIF_TRAP_GROUP_ATTR_QUEUE:
-                  attr_list[i].value.u32 = attribute.value.u32;
-                  break;
-              case SAI_HOSTIF_TRAP_GROUP_ATTR_PRIO:
-                  attr_list[i].value.u32 = attribute.value.u32;
-                  break;
-          }
-      }
+  sai_status_t sai_thrift_parse_route_attribute(const sai_thrift_attribute_t &thrift_attr, sai_attribute_t *attr, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attribute(sai_thrift_route_attr_desc, SAI_THRIFT_ATTR_DESC_COUNT(sai_thrift_route_attr_desc),
+                                        thrift_attr, attr, arena);
   }
 
-  void sai_thrift_parse_hostif_trap_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list) {
-      std::vector<sai_thrift_attribute_t>::const_iterator it1 = thrift_attr_list.begin();
-      sai_thrift_attribute_t attribute;
-      for(uint32_t i = 0; i < thrift_attr_list.size(); i++, it1++) {
-          attribute = (sai_thrift_attribute_t)*it1;
-          attr_list[i].id = attribute.id;
-          switch (attribute.id) {
-              case SAI_HOSTIF_TRAP_ATTR_PACKET_ACTION:
-                  attr_list[i].value.u32 = attribute.value.u32;
-                  break;
-              case SAI_HOSTIF_TRAP_ATTR_TRAP_PRIORITY:
-                  attr_list[i].value.u32 = attribute.value.u32;
-                  break;
-              case SAI_HOSTIF_TRAP_ATTR_TRAP_CHANNEL:
-                  attr_list[i].value.u32 = attribute.value.u32;
-                  break;
-              case SAI_HOSTIF_TRAP_ATTR_TRAP_GROUP:
-                  attr_list[i].value.oid = attribute.value.oid;
-                  break;
-              default:
-                  break;
-          }
-      }
+  sai_status_t sai_thrift_parse_router_interface_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attributes(sai_thrift_router_interface_attr_desc, SAI_THRIFT_ATTR_DESC_COUNT(sai_thrift_router_interface_attr_desc),
+                                         thrift_attr_list, attr_list, arena);
   }
 
-  void sai_thrift_parse_hostif_trap_attribute(const sai_thrift_attribute_t &thrift_attr, sai_attribute_t *attr) {
-      attr->id = thrift_attr.id;
-      switch (thrift_attr.id) {
-          case SAI_HOSTIF_TRAP_ATTR_PACKET_ACTION:
-              attr->value.u32 = thrift_attr.value.u32;
-              break;
-          case SAI_HOSTIF_TRAP_ATTR_TRAP_PRIORITY:
-              attr->value.u32 = thrift_attr.value.u32;
-              break;
-          case SAI_HOSTIF_TRAP_ATTR_TRAP_CHANNEL:
-              attr->value.u32 = thrift_attr.value.u32;
-              break;
-          case SAI_HOSTIF_TRAP_ATTR_TRAP_GROUP:
-              attr->value.oid = thrift_attr.value.oid;
-              break;
-          default:
-              break;
-      }
+  sai_status_t sai_thrift_parse_next_hop_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attributes(sai_thrift_next_hop_attr_desc, SAI_THRIFT_ATTR_DESC_COUNT(sai_thrift_next_hop_attr_desc),
+                                         thrift_attr_list, attr_list, arena);
+  }
+
+  sai_status_t sai_thrift_parse_next_hop_group_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attributes(sai_thrift_next_hop_group_attr_desc, SAI_THRIFT_ATTR_DESC_COUNT(sai_thrift_next_hop_group_attr_desc),
+                                         thrift_attr_list, attr_list, arena);
+  }
+
+  sai_status_t sai_thrift_parse_next_hop_group_attribute(const sai_thrift_attribute_t &thrift_attr, sai_attribute_t *attr, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attribute(sai_thrift_next_hop_group_attr_desc, SAI_THRIFT_ATTR_DESC_COUNT(sai_thrift_next_hop_group_attr_desc),
+                                        thrift_attr, attr, arena);
+  }
+
+  sai_status_t sai_thrift_parse_lag_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attributes(sai_thrift_lag_attr_desc, SAI_THRIFT_ATTR_DESC_COUNT(sai_thrift_lag_attr_desc),
+                                         thrift_attr_list, attr_list, arena);
+  }
+
+  sai_status_t sai_thrift_parse_lag_attribute(const sai_thrift_attribute_t &thrift_attr, sai_attribute_t *attr, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attribute(sai_thrift_lag_attr_desc, SAI_THRIFT_ATTR_DESC_COUNT(sai_thrift_lag_attr_desc),
+                                        thrift_attr, attr, arena);
+  }
+
+  sai_status_t sai_thrift_parse_stp_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attributes(sai_thrift_stp_attr_desc, SAI_THRIFT_ATTR_DESC_COUNT(sai_thrift_stp_attr_desc),
+                                         thrift_attr_list, attr_list, arena);
+  }
+
+  sai_status_t sai_thrift_parse_neighbor_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attributes(sai_thrift_neighbor_attr_desc, SAI_THRIFT_ATTR_DESC_COUNT(sai_thrift_neighbor_attr_desc),
+                                         thrift_attr_list, attr_list, arena);
+  }
+
+  sai_status_t sai_thrift_parse_neighbor_attribute(const sai_thrift_attribute_t &thrift_attr, sai_attribute_t *attr, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attribute(sai_thrift_neighbor_attr_desc, SAI_THRIFT_ATTR_DESC_COUNT(sai_thrift_neighbor_attr_desc),
+                                        thrift_attr, attr, arena);
+  }
+
+  sai_status_t sai_thrift_parse_hostif_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attributes(sai_thrift_hostif_attr_desc, SAI_THRIFT_ATTR_DESC_COUNT(sai_thrift_hostif_attr_desc),
+                                         thrift_attr_list, attr_list, arena);
+  }
+
+  sai_status_t sai_thrift_parse_hostif_trap_group_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attributes(sai_thrift_hostif_trap_group_attr_desc, SAI_THRIFT_ATTR_DESC_COUNT(sai_thrift_hostif_trap_group_attr_desc),
+                                         thrift_attr_list, attr_list, arena);
+  }
+
+  sai_status_t sai_thrift_parse_hostif_trap_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attributes(sai_thrift_hostif_trap_attr_desc, SAI_THRIFT_ATTR_DESC_COUNT(sai_thrift_hostif_trap_attr_desc),
+                                         thrift_attr_list, attr_list, arena);
+  }
+
+  sai_status_t sai_thrift_parse_hostif_trap_attribute(const sai_thrift_attribute_t &thrift_attr, sai_attribute_t *attr, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attribute(sai_thrift_hostif_trap_attr_desc, SAI_THRIFT_ATTR_DESC_COUNT(sai_thrift_hostif_trap_attr_desc),
+                                        thrift_attr, attr, arena);
+  }
+
+  sai_status_t sai_thrift_parse_switch_attribute(const sai_thrift_attribute_t &thrift_attr, sai_attribute_t *attr, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attribute(sai_thrift_switch_attr_desc, SAI_THRIFT_ATTR_DESC_COUNT(sai_thrift_switch_attr_desc),
+                                        thrift_attr, attr, arena);
+  }
+
+  sai_status_t sai_thrift_parse_acl_table_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attributes(NULL, 0, thrift_attr_list, attr_list, arena);
+  }
+
+  sai_status_t sai_thrift_parse_acl_entry_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list, sai_thrift_arena &arena) {
+      return sai_thrift_parse_attributes(sai_thrift_acl_entry_attr_desc, SAI_THRIFT_ATTR_DESC_COUNT(sai_thrift_acl_entry_attr_desc),
+                                         thrift_attr_list, attr_list, arena);
   }
 
 
   int32_t sai_thrift_create_fdb_entry(const sai_thrift_fdb_entry_t& thrift_fdb_entry, const std::vector<sai_thrift_attribute_t> & thrift_attr_list) {
       printf("sai_thrift_create_fdb_entry\n");
+      sai_thrift_api_guard guard(SAI_API_FDB);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_fdb_api_t *fdb_api;
       sai_fdb_entry_t fdb_entry;
@@ -447,17 +656,24 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
       if (status != SAI_STATUS_SUCCESS) {
          return status;
       }
-      sai_thrift_parse_fdb_entry(thrift_fdb_entry, &fdb_entry);
-      sai_attribute_t *attr_list = (sai_attribute_t *) malloc(sizeof(sai_attribute_t) * thrift_attr_list.size());
-      sai_thrift_parse_fdb_attributes(thrift_attr_list, attr_list);
+      status = sai_thrift_parse_fdb_entry(thrift_fdb_entry, &fdb_entry);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
+      sai_thrift_arena arena;
+      sai_attribute_t *attr_list = arena.alloc_array<sai_attribute_t>(thrift_attr_list.size());
+      status = sai_thrift_parse_fdb_attributes(thrift_attr_list, attr_list, arena);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
       uint32_t attr_count = thrift_attr_list.size();
       status = fdb_api->create_fdb_entry(&fdb_entry, attr_count, attr_list);
-      free(attr_list);
       return status;
   }
 
   int32_t sai_thrift_delete_fdb_entry(const sai_thrift_fdb_entry_t& thrift_fdb_entry) {
       printf("sai_thrift_delete_fdb_entry\n");
+      sai_thrift_api_guard guard(SAI_API_FDB);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_fdb_api_t *fdb_api;
       sai_fdb_entry_t fdb_entry;
@@ -465,29 +681,222 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
       if (status != SAI_STATUS_SUCCESS) {
           return status;
       }
-      sai_thrift_parse_fdb_entry(thrift_fdb_entry, &fdb_entry);
+      status = sai_thrift_parse_fdb_entry(thrift_fdb_entry, &fdb_entry);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
       status = fdb_api->remove_fdb_entry(&fdb_entry);
       return status;
   }
 
   int32_t sai_thrift_flush_fdb_entries(const std::vector<sai_thrift_attribute_t> & thrift_attr_list) {
       printf("sai_thrift_flush_fdb_entries\n");
+      sai_thrift_api_guard guard(SAI_API_FDB);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_fdb_api_t *fdb_api;
       status = sai_api_query(SAI_API_FDB, (void **) &fdb_api);
       if (status != SAI_STATUS_SUCCESS) {
          return status;
       }
-      sai_attribute_t *attr_list = (sai_attribute_t *) malloc(sizeof(sai_attribute_t) * thrift_attr_list.size());
-      sai_thrift_parse_fdb_flush_attributes(thrift_attr_list, attr_list);
+      sai_thrift_arena arena;
+      sai_attribute_t *attr_list = arena.alloc_array<sai_attribute_t>(thrift_attr_list.size());
+      status = sai_thrift_parse_fdb_flush_attributes(thrift_attr_list, attr_list, arena);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
       uint32_t attr_count = thrift_attr_list.size();
       status = fdb_api->flush_fdb_entries(attr_count, attr_list);
-      free(attr_list);
       return status;
   }
 
+  void sai_thrift_create_fdb_entries(std::vector<sai_thrift_status_t> & thrift_statuses, const std::vector<sai_thrift_fdb_entry_t> & thrift_fdb_entries, const std::vector<std::vector<sai_thrift_attribute_t> > & thrift_attr_lists) {
+      printf("sai_thrift_create_fdb_entries\n");
+      sai_thrift_api_guard guard(SAI_API_FDB);
+      uint32_t entry_count = thrift_fdb_entries.size();
+      uint32_t total_attr_count = 0;
+      if (thrift_attr_lists.size() != entry_count) {
+          thrift_statuses.assign(entry_count, SAI_STATUS_INVALID_PARAMETER);
+          return;
+      }
+      if (!entry_count) {
+          return;
+      }
+      for (uint32_t i = 0; i < entry_count; i++) {
+          total_attr_count += thrift_attr_lists[i].size();
+      }
+      sai_thrift_arena arena;
+      sai_fdb_entry_t *fdb_entries = arena.alloc_array<sai_fdb_entry_t>(entry_count);
+      uint32_t *attr_count = arena.alloc_array<uint32_t>(entry_count);
+      const sai_attribute_t **attr_list = arena.alloc_array<const sai_attribute_t *>(entry_count);
+      sai_attribute_t *attrs = arena.alloc_array<sai_attribute_t>(total_attr_count);
+      sai_status_t *statuses = arena.alloc_array<sai_status_t>(entry_count);
+      uint32_t *entry_index = arena.alloc_array<uint32_t>(entry_count);
+      sai_attribute_t *attr = attrs;
+      uint32_t valid_count = 0;
+      thrift_statuses.resize(entry_count);
+      for (uint32_t i = 0; i < entry_count; i++) {
+          sai_status_t status = sai_thrift_parse_fdb_entry(thrift_fdb_entries[i], &fdb_entries[valid_count]);
+          if (status == SAI_STATUS_SUCCESS) {
+              status = sai_thrift_parse_fdb_attributes(thrift_attr_lists[i], attr, arena);
+          }
+          if (status != SAI_STATUS_SUCCESS) {
+              thrift_statuses[i] = status;
+              continue;
+          }
+          attr_count[valid_count] = thrift_attr_lists[i].size();
+          attr_list[valid_count] = attr;
+          attr += attr_count[valid_count];
+          entry_index[valid_count++] = i;
+      }
+      if (valid_count) {
+          sai_bulk_create_fdb_entry(valid_count, fdb_entries, attr_count, attr_list, statuses);
+      }
+      for (uint32_t i = 0; i < valid_count; i++) {
+          thrift_statuses[entry_index[i]] = statuses[i];
+      }
+  }
+
+  void sai_thrift_delete_fdb_entries(std::vector<sai_thrift_status_t> & thrift_statuses, const std::vector<sai_thrift_fdb_entry_t> & thrift_fdb_entries) {
+      printf("sai_thrift_delete_fdb_entries\n");
+      sai_thrift_api_guard guard(SAI_API_FDB);
+      uint32_t entry_count = thrift_fdb_entries.size();
+      if (!entry_count) {
+          return;
+      }
+      sai_thrift_arena arena;
+      sai_fdb_entry_t *fdb_entries = arena.alloc_array<sai_fdb_entry_t>(entry_count);
+      sai_status_t *statuses = arena.alloc_array<sai_status_t>(entry_count);
+      uint32_t *entry_index = arena.alloc_array<uint32_t>(entry_count);
+      uint32_t valid_count = 0;
+      thrift_statuses.resize(entry_count);
+      for (uint32_t i = 0; i < entry_count; i++) {
+          sai_status_t status = sai_thrift_parse_fdb_entry(thrift_fdb_entries[i], &fdb_entries[valid_count]);
+          if (status != SAI_STATUS_SUCCESS) {
+              thrift_statuses[i] = status;
+              continue;
+          }
+          entry_index[valid_count++] = i;
+      }
+      if (valid_count) {
+          sai_bulk_remove_fdb_entry(valid_count, fdb_entries, statuses);
+      }
+      for (uint32_t i = 0; i < valid_count; i++) {
+          thrift_statuses[entry_index[i]] = statuses[i];
+      }
+  }
+
+  sai_thrift_status_t sai_thrift_set_fdb_entry_attribute(const sai_thrift_fdb_entry_t& thrift_fdb_entry, const sai_thrift_attribute_t& thrift_attr) {
+      printf("sai_thrift_set_fdb_entry_attribute\n");
+      sai_thrift_api_guard guard(SAI_API_FDB);
+      sai_status_t status = SAI_STATUS_SUCCESS;
+      sai_fdb_api_t *fdb_api;
+      sai_fdb_entry_t fdb_entry;
+      sai_attribute_t attr;
+      status = sai_api_query(SAI_API_FDB, (void **) &fdb_api);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
+      status = sai_thrift_parse_fdb_entry(thrift_fdb_entry, &fdb_entry);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
+      sai_thrift_arena arena;
+      status = sai_thrift_parse_fdb_attribute(thrift_attr, &attr, arena);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
+      status = fdb_api->set_fdb_entry_attribute(&fdb_entry, &attr);
+      return status;
+  }
+
+  void sai_thrift_get_fdb_entry_attribute(sai_thrift_attribute_list_t& thrift_attr_list, const sai_thrift_fdb_entry_t& thrift_fdb_entry) {
+      printf("sai_thrift_get_fdb_entry_attribute\n");
+      sai_thrift_api_guard guard(SAI_API_FDB);
+      sai_status_t status = SAI_STATUS_SUCCESS;
+      sai_fdb_api_t *fdb_api;
+      sai_fdb_entry_t fdb_entry;
+      sai_attribute_t attr_list[3];
+      thrift_attr_list.attr_count = 0;
+      status = sai_api_query(SAI_API_FDB, (void **) &fdb_api);
+      if (status != SAI_STATUS_SUCCESS) {
+          return;
+      }
+      status = sai_thrift_parse_fdb_entry(thrift_fdb_entry, &fdb_entry);
+      if (status != SAI_STATUS_SUCCESS) {
+          return;
+      }
+      attr_list[0].id = SAI_FDB_ENTRY_ATTR_TYPE;
+      attr_list[1].id = SAI_FDB_ENTRY_ATTR_PORT_ID;
+      attr_list[2].id = SAI_FDB_ENTRY_ATTR_PACKET_ACTION;
+      status = fdb_api->get_fdb_entry_attribute(&fdb_entry, 3, attr_list);
+      if (status != SAI_STATUS_SUCCESS) {
+          return;
+      }
+      sai_thrift_attribute_t thrift_attr;
+      thrift_attr.id = SAI_FDB_ENTRY_ATTR_TYPE;
+      thrift_attr.value.__set_u8(attr_list[0].value.u8);
+      thrift_attr_list.attr_list.push_back(thrift_attr);
+      thrift_attr.id = SAI_FDB_ENTRY_ATTR_PORT_ID;
+      thrift_attr.value.__set_oid(attr_list[1].value.oid);
+      thrift_attr_list.attr_list.push_back(thrift_attr);
+      thrift_attr.id = SAI_FDB_ENTRY_ATTR_PACKET_ACTION;
+      thrift_attr.value.__set_u8(attr_list[2].value.u8);
+      thrift_attr_list.attr_list.push_back(thrift_attr);
+      thrift_attr_list.attr_count = thrift_attr_list.attr_list.size();
+  }
+
+  void sai_thrift_get_fdb_entries(sai_thrift_fdb_page_t& thrift_page, const std::vector<sai_thrift_attribute_t> & thrift_filter_list, const sai_thrift_fdb_entry_t& thrift_cursor, const int32_t max_count) {
+      printf("sai_thrift_get_fdb_entries\n");
+      sai_thrift_api_guard guard(SAI_API_FDB);
+      sai_status_t status = SAI_STATUS_SUCCESS;
+      sai_fdb_entry_t cursor;
+      sai_fdb_entry_t *cursor_ptr = NULL;
+      uint32_t entry_count = SAI_THRIFT_FDB_PAGE_MAX;
+      bool more = false;
+      char mac_str[SWITCH_SAI_MAC_STR_LEN + 1];
+      thrift_page.more = false;
+      if (max_count <= 0) {
+          thrift_page.status = SAI_STATUS_INVALID_PARAMETER;
+          return;
+      }
+      if ((uint32_t) max_count < entry_count) {
+          entry_count = max_count;
+      }
+      sai_thrift_arena arena;
+      sai_attribute_t *attr_list = arena.alloc_array<sai_attribute_t>(thrift_filter_list.size());
+      status = sai_thrift_parse_fdb_flush_attributes(thrift_filter_list, attr_list, arena);
+      // an empty cursor starts from the beginning of the table
+      if (status == SAI_STATUS_SUCCESS && !thrift_cursor.mac_address.empty()) {
+          status = sai_thrift_parse_fdb_entry(thrift_cursor, &cursor);
+          cursor_ptr = &cursor;
+      }
+      if (status != SAI_STATUS_SUCCESS) {
+          thrift_page.status = status;
+          return;
+      }
+      sai_fdb_entry_info_t *entries = arena.alloc_array<sai_fdb_entry_info_t>(entry_count);
+      status = sai_get_fdb_entries(thrift_filter_list.size(), attr_list, cursor_ptr,
+                                   &entry_count, entries, &more);
+      thrift_page.status = status;
+      if (status != SAI_STATUS_SUCCESS) {
+          return;
+      }
+      thrift_page.entries.resize(entry_count);
+      for (uint32_t i = 0; i < entry_count; i++) {
+          sai_thrift_fdb_entry_info_t &thrift_entry = thrift_page.entries[i];
+          switch_sai_addr_format_mac(entries[i].fdb_entry.mac_address, mac_str);
+          thrift_entry.fdb_entry.mac_address.assign(mac_str, SWITCH_SAI_MAC_STR_LEN);
+          thrift_entry.fdb_entry.vlan_id = entries[i].fdb_entry.vlan_id;
+          thrift_entry.entry_type = entries[i].type;
+          thrift_entry.port_id = entries[i].port_id;
+          thrift_entry.packet_action = entries[i].packet_action;
+      }
+      thrift_page.more = more;
+  }
+
   int32_t sai_thrift_create_vlan(const sai_thrift_vlan_id_t vlan_id) {
       printf("sai_thrift_create_vlan\n");
+      sai_thrift_api_guard guard(SAI_API_VLAN);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_vlan_api_t *vlan_api;
       status = sai_api_query(SAI_API_VLAN, (void **) &vlan_api);
@@ -500,6 +909,7 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
 
   int32_t sai_thrift_delete_vlan(const sai_thrift_vlan_id_t vlan_id) {
       printf("sai_thrift_delete_vlan\n");
+      sai_thrift_api_guard guard(SAI_API_VLAN);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_vlan_api_t *vlan_api;
       status = sai_api_query(SAI_API_VLAN, (void **) &vlan_api);
@@ -512,38 +922,41 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
 
   int32_t sai_thrift_add_ports_to_vlan(const sai_thrift_vlan_id_t vlan_id, const std::vector<sai_thrift_vlan_port_t> & thrift_port_list) {
       printf("sai_thrift_add_ports_to_vlan\n");
+      sai_thrift_api_guard guard(SAI_API_VLAN);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_vlan_api_t *vlan_api;
       status = sai_api_query(SAI_API_VLAN, (void **) &vlan_api);
       if (status != SAI_STATUS_SUCCESS) {
           return status;
       }
-      sai_vlan_port_t *port_list = (sai_vlan_port_t *) malloc(sizeof(sai_vlan_port_t) * thrift_port_list.size());
+      sai_thrift_arena arena;
+      sai_vlan_port_t *port_list = arena.alloc_array<sai_vlan_port_t>(thrift_port_list.size());
       sai_thrift_parse_vlan_port_id_list(thrift_port_list, port_list);
       uint32_t port_count = thrift_port_list.size();
       status = vlan_api->add_ports_to_vlan(vlan_id, port_count, port_list);
-      free(port_list);
       return status;
   }
 
   int32_t sai_thrift_remove_ports_from_vlan(const sai_thrift_vlan_id_t vlan_id, const std::vector<sai_thrift_vlan_port_t> & thrift_port_list) {
       printf("sai_thrift_remove_ports_from_vlan\n");
+      sai_thrift_api_guard guard(SAI_API_VLAN);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_vlan_api_t *vlan_api;
       status = sai_api_query(SAI_API_VLAN, (void **) &vlan_api);
       if (status != SAI_STATUS_SUCCESS) {
           return status;
       }
-      sai_vlan_port_t *port_list = (sai_vlan_port_t *) malloc(sizeof(sai_vlan_port_t) * thrift_port_list.size());
+      sai_thrift_arena arena;
+      sai_vlan_port_t *port_list = arena.alloc_array<sai_vlan_port_t>(thrift_port_list.size());
       sai_thrift_parse_vlan_port_id_list(thrift_port_list, port_list);
       uint32_t port_count = thrift_port_list.size();
       status = vlan_api->remove_ports_from_vlan(vlan_id, port_count, port_list);
-      free(port_list);
       return status;
   }
 
   sai_thrift_object_id_t sai_thrift_create_virtual_router(const std::vector<sai_thrift_attribute_t> & thrift_attr_list) {
     printf("sai_thrift_create_virtual_router\n");
+      sai_thrift_api_guard guard(SAI_API_VIRTUAL_ROUTER);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_virtual_router_api_t *vr_api;
       sai_object_id_t vr_id = 0;
@@ -551,8 +964,12 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
       if (status != SAI_STATUS_SUCCESS) {
           return status;
       }
-      sai_attribute_t *attr_list = (sai_attribute_t *) malloc(sizeof(sai_attribute_t) * thrift_attr_list.size());
-      sai_thrift_parse_vr_attributes(thrift_attr_list, attr_list);
+      sai_thrift_arena arena;
+      sai_attribute_t *attr_list = arena.alloc_array<sai_attribute_t>(thrift_attr_list.size());
+      status = sai_thrift_parse_vr_attributes(thrift_attr_list, attr_list, arena);
+      if (status != SAI_STATUS_SUCCESS) {
+          return SAI_NULL_OBJECT_ID;
+      }
       uint32_t attr_count = thrift_attr_list.size();
       vr_api->create_virtual_router(&vr_id, attr_count, attr_list);
       return vr_id;
@@ -560,6 +977,7 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
 
   sai_thrift_status_t sai_thrift_remove_virtual_router(const sai_thrift_object_id_t vr_id) {
     printf("sai_thrift_remove_virtual_router\n");
+      sai_thrift_api_guard guard(SAI_API_VIRTUAL_ROUTER);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_virtual_router_api_t *vr_api;
       status = sai_api_query(SAI_API_VIRTUAL_ROUTER, (void **) &vr_api);
@@ -572,6 +990,7 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
 
   sai_thrift_status_t sai_thrift_create_route(const sai_thrift_unicast_route_entry_t& thrift_unicast_route_entry, const std::vector<sai_thrift_attribute_t> & thrift_attr_list) {
       printf("sai_thrift_create_route\n");
+      sai_thrift_api_guard guard(SAI_API_ROUTE, SAI_API_NEXT_HOP_GROUP);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_route_api_t *route_api;
       sai_unicast_route_entry_t unicast_route_entry;
@@ -579,17 +998,24 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
       if (status != SAI_STATUS_SUCCESS) {
           return status;
       }
-      sai_thrift_parse_unicast_route_entry(thrift_unicast_route_entry, &unicast_route_entry);
-      sai_attribute_t *attr_list = (sai_attribute_t *) malloc(sizeof(sai_attribute_t) * thrift_attr_list.size());
-      sai_thrift_parse_route_attributes(thrift_attr_list, attr_list);
+      status = sai_thrift_parse_unicast_route_entry(thrift_unicast_route_entry, &unicast_route_entry);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
+      sai_thrift_arena arena;
+      sai_attribute_t *attr_list = arena.alloc_array<sai_attribute_t>(thrift_attr_list.size());
+      status = sai_thrift_parse_route_attributes(thrift_attr_list, attr_list, arena);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
       uint32_t attr_count = thrift_attr_list.size();
       status = route_api->create_route(&unicast_route_entry, attr_count, attr_list);
-      free(attr_list);
       return status;
   }
 
   sai_thrift_status_t sai_thrift_remove_route(const sai_thrift_unicast_route_entry_t& thrift_unicast_route_entry) {
       printf("sai_thrift_remove_route\n");
+      sai_thrift_api_guard guard(SAI_API_ROUTE, SAI_API_NEXT_HOP_GROUP);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_route_api_t *route_api;
       sai_unicast_route_entry_t unicast_route_entry;
@@ -597,13 +1023,117 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
       if (status != SAI_STATUS_SUCCESS) {
           return status;
       }
-      sai_thrift_parse_unicast_route_entry(thrift_unicast_route_entry, &unicast_route_entry);
+      status = sai_thrift_parse_unicast_route_entry(thrift_unicast_route_entry, &unicast_route_entry);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
       status = route_api->remove_route(&unicast_route_entry);
       return status;
   }
 
+  sai_thrift_status_t sai_thrift_set_route_attribute(const sai_thrift_unicast_route_entry_t& thrift_unicast_route_entry, const sai_thrift_attribute_t& thrift_attr) {
+      printf("sai_thrift_set_route_attribute\n");
+      sai_thrift_api_guard guard(SAI_API_ROUTE, SAI_API_NEXT_HOP_GROUP);
+      sai_status_t status = SAI_STATUS_SUCCESS;
+      sai_route_api_t *route_api;
+      sai_unicast_route_entry_t unicast_route_entry;
+      sai_attribute_t attr;
+      status = sai_api_query(SAI_API_ROUTE, (void **) &route_api);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
+      status = sai_thrift_parse_unicast_route_entry(thrift_unicast_route_entry, &unicast_route_entry);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
+      sai_thrift_arena arena;
+      status = sai_thrift_parse_route_attribute(thrift_attr, &attr, arena);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
+      status = route_api->set_route_attribute(&unicast_route_entry, &attr);
+      return status;
+  }
+
+  void sai_thrift_create_routes(std::vector<sai_thrift_status_t> & thrift_statuses, const std::vector<sai_thrift_unicast_route_entry_t> & thrift_unicast_route_entries, const std::vector<std::vector<sai_thrift_attribute_t> > & thrift_attr_lists) {
+      printf("sai_thrift_create_routes\n");
+      sai_thrift_api_guard guard(SAI_API_ROUTE, SAI_API_NEXT_HOP_GROUP);
+      uint32_t route_count = thrift_unicast_route_entries.size();
+      uint32_t total_attr_count = 0;
+      if (thrift_attr_lists.size() != route_count) {
+          thrift_statuses.assign(route_count, SAI_STATUS_INVALID_PARAMETER);
+          return;
+      }
+      if (!route_count) {
+          return;
+      }
+      for (uint32_t i = 0; i < route_count; i++) {
+          total_attr_count += thrift_attr_lists[i].size();
+      }
+      sai_thrift_arena arena;
+      sai_unicast_route_entry_t *route_entries = arena.alloc_array<sai_unicast_route_entry_t>(route_count);
+      uint32_t *attr_count = arena.alloc_array<uint32_t>(route_count);
+      const sai_attribute_t **attr_list = arena.alloc_array<const sai_attribute_t *>(route_count);
+      sai_attribute_t *attrs = arena.alloc_array<sai_attribute_t>(total_attr_count);
+      sai_status_t *statuses = arena.alloc_array<sai_status_t>(route_count);
+      uint32_t *entry_index = arena.alloc_array<uint32_t>(route_count);
+      sai_attribute_t *attr = attrs;
+      uint32_t valid_count = 0;
+      thrift_statuses.resize(route_count);
+      for (uint32_t i = 0; i < route_count; i++) {
+          sai_status_t status = sai_thrift_parse_unicast_route_entry(thrift_unicast_route_entries[i], &route_entries[valid_count]);
+          if (status == SAI_STATUS_SUCCESS) {
+              status = sai_thrift_parse_route_attributes(thrift_attr_lists[i], attr, arena);
+          }
+          if (status != SAI_STATUS_SUCCESS) {
+              thrift_statuses[i] = status;
+              continue;
+          }
+          attr_count[valid_count] = thrift_attr_lists[i].size();
+          attr_list[valid_count] = attr;
+          attr += attr_count[valid_count];
+          entry_index[valid_count++] = i;
+      }
+      if (valid_count) {
+          sai_bulk_create_route_entry(valid_count, route_entries, attr_count, attr_list, statuses);
+      }
+      for (uint32_t i = 0; i < valid_count; i++) {
+          thrift_statuses[entry_index[i]] = statuses[i];
+      }
+  }
+
+  void sai_thrift_remove_routes(std::vector<sai_thrift_status_t> & thrift_statuses, const std::vector<sai_thrift_unicast_route_entry_t> & thrift_unicast_route_entries) {
+      printf("sai_thrift_remove_routes\n");
+      sai_thrift_api_guard guard(SAI_API_ROUTE, SAI_API_NEXT_HOP_GROUP);
+      uint32_t route_count = thrift_unicast_route_entries.size();
+      if (!route_count) {
+          return;
+      }
+      sai_thrift_arena arena;
+      sai_unicast_route_entry_t *route_entries = arena.alloc_array<sai_unicast_route_entry_t>(route_count);
+      sai_status_t *statuses = arena.alloc_array<sai_status_t>(route_count);
+      uint32_t *entry_index = arena.alloc_array<uint32_t>(route_count);
+      uint32_t valid_count = 0;
+      thrift_statuses.resize(route_count);
+      for (uint32_t i = 0; i < route_count; i++) {
+          sai_status_t status = sai_thrift_parse_unicast_route_entry(thrift_unicast_route_entries[i], &route_entries[valid_count]);
+          if (status != SAI_STATUS_SUCCESS) {
+              thrift_statuses[i] = status;
+              continue;
+          }
+          entry_index[valid_count++] = i;
+      }
+      if (valid_count) {
+          sai_bulk_remove_route_entry(valid_count, route_entries, statuses);
+      }
+      for (uint32_t i = 0; i < valid_count; i++) {
+          thrift_statuses[entry_index[i]] = statuses[i];
+      }
+  }
+
   sai_thrift_object_id_t sai_thrift_create_router_interface(const std::vector<sai_thrift_attribute_t> & thrift_attr_list) {
       printf("sai_thrift_create_router_interface\n");
+      sai_thrift_api_guard guard(SAI_API_ROUTER_INTERFACE);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_router_interface_api_t *rif_api;
       sai_object_id_t rif_id = 0;
@@ -611,8 +1141,12 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
       if (status != SAI_STATUS_SUCCESS) {
           return status;
       }
-      sai_attribute_t *attr_list = (sai_attribute_t *) malloc(sizeof(sai_attribute_t) * thrift_attr_list.size());
-      sai_thrift_parse_router_interface_attributes(thrift_attr_list, attr_list);
+      sai_thrift_arena arena;
+      sai_attribute_t *attr_list = arena.alloc_array<sai_attribute_t>(thrift_attr_list.size());
+      status = sai_thrift_parse_router_interface_attributes(thrift_attr_list, attr_list, arena);
+      if (status != SAI_STATUS_SUCCESS) {
+          return SAI_NULL_OBJECT_ID;
+      }
       uint32_t attr_count = thrift_attr_list.size();
       status = rif_api->create_router_interface(&rif_id, attr_count, attr_list);
       return rif_id;
@@ -620,6 +1154,7 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
 
   sai_thrift_status_t sai_thrift_remove_router_interface(const sai_thrift_object_id_t rif_id) {
       printf("sai_thrift_remove_router_interface\n");
+      sai_thrift_api_guard guard(SAI_API_ROUTER_INTERFACE);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_router_interface_api_t *rif_api;
       status = sai_api_query(SAI_API_ROUTER_INTERFACE, (void **) &rif_api);
@@ -632,6 +1167,7 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
 
   sai_thrift_object_id_t sai_thrift_create_next_hop(const std::vector<sai_thrift_attribute_t> & thrift_attr_list) {
       printf("sai_thrift_create_next_hop\n");
+      sai_thrift_api_guard guard(SAI_API_NEXT_HOP);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_next_hop_api_t *nhop_api;
       sai_object_id_t nhop_id = 0;
@@ -639,8 +1175,12 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
       if (status != SAI_STATUS_SUCCESS) {
           return status;
       }
-      sai_attribute_t *attr_list = (sai_attribute_t *) malloc(sizeof(sai_attribute_t) * thrift_attr_list.size());
-      sai_thrift_parse_next_hop_attributes(thrift_attr_list, attr_list);
+      sai_thrift_arena arena;
+      sai_attribute_t *attr_list = arena.alloc_array<sai_attribute_t>(thrift_attr_list.size());
+      status = sai_thrift_parse_next_hop_attributes(thrift_attr_list, attr_list, arena);
+      if (status != SAI_STATUS_SUCCESS) {
+          return SAI_NULL_OBJECT_ID;
+      }
       uint32_t attr_count = thrift_attr_list.size();
       status = nhop_api->create_next_hop(&nhop_id, attr_count, attr_list);
       return nhop_id;
@@ -648,6 +1188,7 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
 
   sai_thrift_status_t sai_thrift_remove_next_hop(const sai_thrift_object_id_t next_hop_id) {
       printf("sai_thrift_remove_next_hop\n");
+      sai_thrift_api_guard guard(SAI_API_NEXT_HOP);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_next_hop_api_t *nhop_api;
       status = sai_api_query(SAI_API_NEXT_HOP, (void **) &nhop_api);
@@ -660,38 +1201,60 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
 
   sai_thrift_object_id_t sai_thrift_create_next_hop_group(const std::vector<sai_thrift_attribute_t> & thrift_attr_list) {
       printf("sai_thrift_create_next_hop_group\n");
+      sai_thrift_api_guard guard(SAI_API_ROUTE, SAI_API_NEXT_HOP_GROUP);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_next_hop_group_api_t *nhop_group_api;
       sai_object_id_t nhop_group_id = 0;
-      sai_object_id_t *nhop_list;
       status = sai_api_query(SAI_API_NEXT_HOP_GROUP, (void **) &nhop_group_api);
       if (status != SAI_STATUS_SUCCESS) {
           return status;
       }
-      sai_attribute_t *attr_list = (sai_attribute_t *) malloc(sizeof(sai_attribute_t) * thrift_attr_list.size());
-      sai_thrift_parse_next_hop_group_attributes(thrift_attr_list, attr_list, &nhop_list);
+      sai_thrift_arena arena;
+      sai_attribute_t *attr_list = arena.alloc_array<sai_attribute_t>(thrift_attr_list.size());
+      status = sai_thrift_parse_next_hop_group_attributes(thrift_attr_list, attr_list, arena);
+      if (status != SAI_STATUS_SUCCESS) {
+          return SAI_NULL_OBJECT_ID;
+      }
       uint32_t attr_count = thrift_attr_list.size();
       status = nhop_group_api->create_next_hop_group(&nhop_group_id, attr_count, attr_list);
-      if (nhop_list) free(nhop_list);
-      free(attr_list);
       return nhop_group_id;
   }
 
   sai_thrift_status_t sai_thrift_remove_next_hop_group(const sai_thrift_object_id_t next_hop_group_id) {
       printf("sai_thrift_remove_next_hop_group\n");
+      sai_thrift_api_guard guard(SAI_API_ROUTE, SAI_API_NEXT_HOP_GROUP);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_next_hop_group_api_t *nhop_group_api;
-      sai_object_id_t nhop_group_id = 0;
       status = sai_api_query(SAI_API_NEXT_HOP_GROUP, (void **) &nhop_group_api);
       if (status != SAI_STATUS_SUCCESS) {
           return status;
       }
-      status = nhop_group_api->remove_next_hop_group(nhop_group_id);
+      status = nhop_group_api->remove_next_hop_group(next_hop_group_id);
+      return status;
+  }
+
+  sai_thrift_status_t sai_thrift_set_next_hop_group_attribute(const sai_thrift_object_id_t next_hop_group_id, const sai_thrift_attribute_t& thrift_attr) {
+      printf("sai_thrift_set_next_hop_group_attribute\n");
+      sai_thrift_api_guard guard(SAI_API_ROUTE, SAI_API_NEXT_HOP_GROUP);
+      sai_status_t status = SAI_STATUS_SUCCESS;
+      sai_next_hop_group_api_t *nhop_group_api;
+      sai_attribute_t attr;
+      status = sai_api_query(SAI_API_NEXT_HOP_GROUP, (void **) &nhop_group_api);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
+      sai_thrift_arena arena;
+      status = sai_thrift_parse_next_hop_group_attribute(thrift_attr, &attr, arena);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
+      status = nhop_group_api->set_next_hop_group_attribute(next_hop_group_id, &attr);
       return status;
   }
 
   sai_thrift_status_t sai_thrift_add_next_hop_to_group(const sai_thrift_object_id_t next_hop_group_id, const std::vector<sai_thrift_object_id_t> & thrift_nexthops) {
       printf("sai_thrift_add_next_hop_to_group\n");
+      sai_thrift_api_guard guard(SAI_API_ROUTE, SAI_API_NEXT_HOP_GROUP);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_next_hop_group_api_t *nhop_group_api;
       sai_object_id_t *nhop_list;
@@ -699,16 +1262,17 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
       if (status != SAI_STATUS_SUCCESS) {
           return status;
       }
-      nhop_list = (sai_object_id_t *) malloc(sizeof(sai_object_id_t) * thrift_nexthops.size());
+      sai_thrift_arena arena;
+      nhop_list = arena.alloc_array<sai_object_id_t>(thrift_nexthops.size());
       sai_thrift_parse_object_id_list(thrift_nexthops, nhop_list);
       uint32_t nhop_count = thrift_nexthops.size();
       status = nhop_group_api->add_next_hop_to_group(next_hop_group_id, nhop_count, nhop_list);
-      free(nhop_list);
       return status;
   }
 
   sai_thrift_status_t sai_thrift_remove_next_hop_from_group(const sai_thrift_object_id_t next_hop_group_id, const std::vector<sai_thrift_object_id_t> & thrift_nexthops) {
       printf("sai_thrift_remove_next_hop_from_group\n");
+      sai_thrift_api_guard guard(SAI_API_ROUTE, SAI_API_NEXT_HOP_GROUP);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_next_hop_group_api_t *nhop_group_api;
       sai_object_id_t *nhop_list;
@@ -716,37 +1280,38 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
       if (status != SAI_STATUS_SUCCESS) {
           return status;
       }
-      nhop_list = (sai_object_id_t *) malloc(sizeof(sai_object_id_t) * thrift_nexthops.size());
+      sai_thrift_arena arena;
+      nhop_list = arena.alloc_array<sai_object_id_t>(thrift_nexthops.size());
       sai_thrift_parse_object_id_list(thrift_nexthops, nhop_list);
       uint32_t nhop_count = thrift_nexthops.size();
       status = nhop_group_api->remove_next_hop_from_group(next_hop_group_id, nhop_count, nhop_list);
-      free(nhop_list);
       return status;
   }
 
   sai_thrift_object_id_t sai_thrift_create_lag(const std::vector<sai_thrift_attribute_t> & thrift_attr_list) {
       printf("sai_thrift_create_lag\n");
+      sai_thrift_api_guard guard(SAI_API_LAG);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_lag_api_t *lag_api;
-      sai_object_id_t *port_list;
       sai_object_id_t lag_id = 0;
       status = sai_api_query(SAI_API_LAG, (void **) &lag_api);
       if (status != SAI_STATUS_SUCCESS) {
           return status;
       }
-      sai_attribute_t *attr_list = (sai_attribute_t *) malloc(sizeof(sai_attribute_t) * thrift_attr_list.size());
-      sai_thrift_parse_lag_attributes(thrift_attr_list, attr_list, &port_list);
+      sai_thrift_arena arena;
+      sai_attribute_t *attr_list = arena.alloc_array<sai_attribute_t>(thrift_attr_list.size());
+      status = sai_thrift_parse_lag_attributes(thrift_attr_list, attr_list, arena);
+      if (status != SAI_STATUS_SUCCESS) {
+          return SAI_NULL_OBJECT_ID;
+      }
       uint32_t attr_count = thrift_attr_list.size();
       status = lag_api->create_lag(&lag_id, attr_count, attr_list);
-      if (port_list) {
-          free(port_list);
-      }
-      free(attr_list);
       return lag_id;
   }
 
   sai_thrift_status_t sai_thrift_remove_lag(const sai_thrift_object_id_t lag_id) {
       printf("sai_thrift_remove_lag\n");
+      sai_thrift_api_guard guard(SAI_API_LAG);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_lag_api_t *lag_api;
       status = sai_api_query(SAI_API_LAG, (void **) &lag_api);
@@ -757,8 +1322,28 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
       return status;
   }
 
+  sai_thrift_status_t sai_thrift_set_lag_attribute(const sai_thrift_object_id_t lag_id, const sai_thrift_attribute_t& thrift_attr) {
+      printf("sai_thrift_set_lag_attribute\n");
+      sai_thrift_api_guard guard(SAI_API_LAG);
+      sai_status_t status = SAI_STATUS_SUCCESS;
+      sai_lag_api_t *lag_api;
+      sai_attribute_t attr;
+      status = sai_api_query(SAI_API_LAG, (void **) &lag_api);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
+      sai_thrift_arena arena;
+      status = sai_thrift_parse_lag_attribute(thrift_attr, &attr, arena);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
+      status = lag_api->set_lag_attribute(lag_id, &attr);
+      return status;
+  }
+
   sai_thrift_status_t sai_thrift_add_ports_to_lag(const sai_thrift_object_id_t lag_id, const std::vector<sai_thrift_object_id_t> & thrift_port_list) {
       printf("sai_thrift_add_ports_to_lag\n");
+      sai_thrift_api_guard guard(SAI_API_LAG);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_lag_api_t *lag_api;
       sai_object_list_t port_list;
@@ -766,16 +1351,17 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
       if (status != SAI_STATUS_SUCCESS) {
           return status;
       }
-      port_list.list = (sai_object_id_t *) malloc(sizeof(sai_object_id_t) * thrift_port_list.size());
+      sai_thrift_arena arena;
+      port_list.list = arena.alloc_array<sai_object_id_t>(thrift_port_list.size());
       sai_thrift_parse_object_id_list(thrift_port_list, port_list.list);
       port_list.count = thrift_port_list.size();
       status = lag_api->add_ports_to_lag(lag_id, &port_list);
-      free(port_list.list);
       return status;
   }
 
   sai_thrift_status_t sai_thrift_remove_ports_from_lag(const sai_thrift_object_id_t lag_id, const std::vector<sai_thrift_object_id_t> & thrift_port_list) {
       printf("sai_thrift_remove_ports_from_lag\n");
+      sai_thrift_api_guard guard(SAI_API_LAG);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_lag_api_t *lag_api;
       sai_object_list_t port_list;
@@ -783,35 +1369,38 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
       if (status != SAI_STATUS_SUCCESS) {
           return status;
       }
-      port_list.list = (sai_object_id_t *) malloc(sizeof(sai_object_id_t) * thrift_port_list.size());
+      sai_thrift_arena arena;
+      port_list.list = arena.alloc_array<sai_object_id_t>(thrift_port_list.size());
       sai_thrift_parse_object_id_list(thrift_port_list, port_list.list);
       port_list.count = thrift_port_list.size();
       status = lag_api->remove_ports_from_lag(lag_id, &port_list);
-      free(port_list.list);
       return status;
   }
 
   sai_thrift_object_id_t sai_thrift_create_stp_entry(const std::vector<sai_thrift_attribute_t> & thrift_attr_list) {
       printf("sai_thrift_create_stp\n");
+      sai_thrift_api_guard guard(SAI_API_STP);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_stp_api_t *stp_api;
-      sai_vlan_id_t *vlan_list;
       sai_object_id_t stp_id;
       status = sai_api_query(SAI_API_STP, (void **) &stp_api);
       if (status != SAI_STATUS_SUCCESS) {
           return status;
       }
-      sai_attribute_t *attr_list = (sai_attribute_t *) malloc(sizeof(sai_attribute_t) * thrift_attr_list.size());
-      sai_thrift_parse_stp_attributes(thrift_attr_list, attr_list, &vlan_list);
+      sai_thrift_arena arena;
+      sai_attribute_t *attr_list = arena.alloc_array<sai_attribute_t>(thrift_attr_list.size());
+      status = sai_thrift_parse_stp_attributes(thrift_attr_list, attr_list, arena);
+      if (status != SAI_STATUS_SUCCESS) {
+          return SAI_NULL_OBJECT_ID;
+      }
       uint32_t attr_count = thrift_attr_list.size();
       status = (sai_object_id_t) stp_api->create_stp(&stp_id, attr_count, attr_list);
-      if (vlan_list) free(vlan_list);
-      free(attr_list);
       return stp_id;
   }
 
   sai_thrift_status_t sai_thrift_remove_stp_entry(const sai_thrift_object_id_t stp_id) {
       printf("sai_thrift_remove_stp\n");
+      sai_thrift_api_guard guard(SAI_API_STP);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_stp_api_t *stp_api;
       status = sai_api_query(SAI_API_STP, (void **) &stp_api);
@@ -824,6 +1413,7 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
 
   sai_thrift_status_t sai_thrift_set_stp_port_state(const sai_thrift_object_id_t stp_id, const sai_thrift_object_id_t port_id, const sai_thrift_port_stp_port_state_t stp_port_state) {
     printf("sai_thrift_set_stp_port_state\n");
+      sai_thrift_api_guard guard(SAI_API_STP);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_stp_api_t *stp_api;
       status = sai_api_query(SAI_API_STP, (void **) &stp_api);
@@ -838,6 +1428,7 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
 
   sai_thrift_port_stp_port_state_t sai_thrift_get_stp_port_state(const sai_thrift_object_id_t stp_id, const sai_thrift_object_id_t port_id) {
     printf("sai_thrift_get_stp_port_state\n");
+      sai_thrift_api_guard guard(SAI_API_STP);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_stp_api_t *stp_api;
       status = sai_api_query(SAI_API_STP, (void **) &stp_api);
@@ -853,6 +1444,7 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
 
   sai_thrift_status_t sai_thrift_create_neighbor_entry(const sai_thrift_neighbor_entry_t& thrift_neighbor_entry, const std::vector<sai_thrift_attribute_t> & thrift_attr_list) {
       printf("sai_thrift_create_neighbor_entry\n");
+      sai_thrift_api_guard guard(SAI_API_ROUTE, SAI_API_ROUTER_INTERFACE, SAI_API_NEIGHBOR);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_neighbor_api_t *neighbor_api;
       status = sai_api_query(SAI_API_NEIGHBOR, (void **) &neighbor_api);
@@ -860,17 +1452,24 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
       if (status != SAI_STATUS_SUCCESS) {
           return status;
       }
-      sai_thrift_parse_neighbor_entry(thrift_neighbor_entry, &neighbor_entry);
-      sai_attribute_t *attr_list = (sai_attribute_t *) malloc(sizeof(sai_attribute_t) * thrift_attr_list.size());
-      sai_thrift_parse_neighbor_attributes(thrift_attr_list, attr_list);
+      status = sai_thrift_parse_neighbor_entry(thrift_neighbor_entry, &neighbor_entry);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
+      sai_thrift_arena arena;
+      sai_attribute_t *attr_list = arena.alloc_array<sai_attribute_t>(thrift_attr_list.size());
+      status = sai_thrift_parse_neighbor_attributes(thrift_attr_list, attr_list, arena);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
       uint32_t attr_count = thrift_attr_list.size();
       status = neighbor_api->create_neighbor_entry(&neighbor_entry, attr_count, attr_list);
-      free(attr_list);
       return status;
   }
 
   sai_thrift_status_t sai_thrift_remove_neighbor_entry(const sai_thrift_neighbor_entry_t& thrift_neighbor_entry) {
     printf("sai_thrift_remove_neighbor_entry\n");
+      sai_thrift_api_guard guard(SAI_API_ROUTE, SAI_API_ROUTER_INTERFACE, SAI_API_NEIGHBOR);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_neighbor_api_t *neighbor_api;
       sai_neighbor_entry_t neighbor_entry;
@@ -878,19 +1477,161 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
       if (status != SAI_STATUS_SUCCESS) {
           return status;
       }
-      sai_thrift_parse_neighbor_entry(thrift_neighbor_entry, &neighbor_entry);
+      status = sai_thrift_parse_neighbor_entry(thrift_neighbor_entry, &neighbor_entry);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
       status = neighbor_api->remove_neighbor_entry(&neighbor_entry);
       return status;
   }
 
+  sai_thrift_status_t sai_thrift_set_neighbor_attribute(const sai_thrift_neighbor_entry_t& thrift_neighbor_entry, const sai_thrift_attribute_t& thrift_attr) {
+      printf("sai_thrift_set_neighbor_attribute\n");
+      sai_thrift_api_guard guard(SAI_API_ROUTE, SAI_API_ROUTER_INTERFACE, SAI_API_NEIGHBOR);
+      sai_status_t status = SAI_STATUS_SUCCESS;
+      sai_neighbor_api_t *neighbor_api;
+      sai_neighbor_entry_t neighbor_entry;
+      sai_attribute_t attr;
+      status = sai_api_query(SAI_API_NEIGHBOR, (void **) &neighbor_api);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
+      status = sai_thrift_parse_neighbor_entry(thrift_neighbor_entry, &neighbor_entry);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
+      sai_thrift_arena arena;
+      status = sai_thrift_parse_neighbor_attribute(thrift_attr, &attr, arena);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
+      status = neighbor_api->set_neighbor_attribute(&neighbor_entry, &attr);
+      return status;
+  }
+
+  void sai_thrift_create_neighbor_entries(std::vector<sai_thrift_status_t> & thrift_statuses, const std::vector<sai_thrift_neighbor_entry_t> & thrift_neighbor_entries, const std::vector<std::vector<sai_thrift_attribute_t> > & thrift_attr_lists) {
+      printf("sai_thrift_create_neighbor_entries\n");
+      sai_thrift_api_guard guard(SAI_API_ROUTE, SAI_API_ROUTER_INTERFACE, SAI_API_NEIGHBOR);
+      uint32_t entry_count = thrift_neighbor_entries.size();
+      uint32_t total_attr_count = 0;
+      if (thrift_attr_lists.size() != entry_count) {
+          thrift_statuses.assign(entry_count, SAI_STATUS_INVALID_PARAMETER);
+          return;
+      }
+      if (!entry_count) {
+          return;
+      }
+      for (uint32_t i = 0; i < entry_count; i++) {
+          total_attr_count += thrift_attr_lists[i].size();
+      }
+      sai_thrift_arena arena;
+      sai_neighbor_entry_t *neighbor_entries = arena.alloc_array<sai_neighbor_entry_t>(entry_count);
+      uint32_t *attr_count = arena.alloc_array<uint32_t>(entry_count);
+      const sai_attribute_t **attr_list = arena.alloc_array<const sai_attribute_t *>(entry_count);
+      sai_attribute_t *attrs = arena.alloc_array<sai_attribute_t>(total_attr_count);
+      sai_status_t *statuses = arena.alloc_array<sai_status_t>(entry_count);
+      uint32_t *entry_index = arena.alloc_array<uint32_t>(entry_count);
+      sai_attribute_t *attr = attrs;
+      uint32_t valid_count = 0;
+      thrift_statuses.resize(entry_count);
+      for (uint32_t i = 0; i < entry_count; i++) {
+          sai_status_t status = sai_thrift_parse_neighbor_entry(thrift_neighbor_entries[i], &neighbor_entries[valid_count]);
+          if (status == SAI_STATUS_SUCCESS) {
+              status = sai_thrift_parse_neighbor_attributes(thrift_attr_lists[i], attr, arena);
+          }
+          if (status != SAI_STATUS_SUCCESS) {
+              thrift_statuses[i] = status;
+              continue;
+          }
+          attr_count[valid_count] = thrift_attr_lists[i].size();
+          attr_list[valid_count] = attr;
+          attr += attr_count[valid_count];
+          entry_index[valid_count++] = i;
+      }
+      if (valid_count) {
+          sai_bulk_create_neighbor_entry(valid_count, neighbor_entries, attr_count, attr_list, statuses);
+      }
+      for (uint32_t i = 0; i < valid_count; i++) {
+          thrift_statuses[entry_index[i]] = statuses[i];
+      }
+  }
+
+  void sai_thrift_remove_neighbor_entries(std::vector<sai_thrift_status_t> & thrift_statuses, const std::vector<sai_thrift_neighbor_entry_t> & thrift_neighbor_entries) {
+      printf("sai_thrift_remove_neighbor_entries\n");
+      sai_thrift_api_guard guard(SAI_API_ROUTE, SAI_API_ROUTER_INTERFACE, SAI_API_NEIGHBOR);
+      uint32_t entry_count = thrift_neighbor_entries.size();
+      if (!entry_count) {
+          return;
+      }
+      sai_thrift_arena arena;
+      sai_neighbor_entry_t *neighbor_entries = arena.alloc_array<sai_neighbor_entry_t>(entry_count);
+      sai_status_t *statuses = arena.alloc_array<sai_status_t>(entry_count);
+      uint32_t *entry_index = arena.alloc_array<uint32_t>(entry_count);
+      uint32_t valid_count = 0;
+      thrift_statuses.resize(entry_count);
+      for (uint32_t i = 0; i < entry_count; i++) {
+          sai_status_t status = sai_thrift_parse_neighbor_entry(thrift_neighbor_entries[i], &neighbor_entries[valid_count]);
+          if (status != SAI_STATUS_SUCCESS) {
+              thrift_statuses[i] = status;
+              continue;
+          }
+          entry_index[valid_count++] = i;
+      }
+      if (valid_count) {
+          sai_bulk_remove_neighbor_entry(valid_count, neighbor_entries, statuses);
+      }
+      for (uint32_t i = 0; i < valid_count; i++) {
+          thrift_statuses[entry_index[i]] = statuses[i];
+      }
+  }
+
+  void sai_thrift_set_neighbor_entries_attribute(std::vector<sai_thrift_status_t> & thrift_statuses, const std::vector<sai_thrift_neighbor_entry_t> & thrift_neighbor_entries, const std::vector<sai_thrift_attribute_t> & thrift_attr_list) {
+      printf("sai_thrift_set_neighbor_entries_attribute\n");
+      sai_thrift_api_guard guard(SAI_API_ROUTE, SAI_API_ROUTER_INTERFACE, SAI_API_NEIGHBOR);
+      uint32_t entry_count = thrift_neighbor_entries.size();
+      if (thrift_attr_list.size() != entry_count) {
+          thrift_statuses.assign(entry_count, SAI_STATUS_INVALID_PARAMETER);
+          return;
+      }
+      if (!entry_count) {
+          return;
+      }
+      sai_thrift_arena arena;
+      sai_neighbor_entry_t *neighbor_entries = arena.alloc_array<sai_neighbor_entry_t>(entry_count);
+      sai_attribute_t *attr_list = arena.alloc_array<sai_attribute_t>(entry_count);
+      sai_status_t *statuses = arena.alloc_array<sai_status_t>(entry_count);
+      uint32_t *entry_index = arena.alloc_array<uint32_t>(entry_count);
+      uint32_t valid_count = 0;
+      thrift_statuses.resize(entry_count);
+      for (uint32_t i = 0; i < entry_count; i++) {
+          sai_status_t status = sai_thrift_parse_neighbor_entry(thrift_neighbor_entries[i], &neighbor_entries[valid_count]);
+          if (status == SAI_STATUS_SUCCESS) {
+              status = sai_thrift_parse_neighbor_attribute(thrift_attr_list[i], &attr_list[valid_count], arena);
+          }
+          if (status != SAI_STATUS_SUCCESS) {
+              thrift_statuses[i] = status;
+              continue;
+          }
+          entry_index[valid_count++] = i;
+      }
+      if (valid_count) {
+          sai_bulk_set_neighbor_entry_attribute(valid_count, neighbor_entries, attr_list, statuses);
+      }
+      for (uint32_t i = 0; i < valid_count; i++) {
+          thrift_statuses[entry_index[i]] = statuses[i];
+      }
+  }
+
   void sai_thrift_get_switch_attribute(sai_thrift_attribute_list_t& thrift_attr_list) {
       printf("sai_thrift_get_switch_attribute\n");
+      sai_thrift_api_guard guard(SAI_API_SWITCH);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_switch_api_t *switch_api;
       sai_attribute_t max_port_attribute;
       sai_attribute_t port_list_object_attribute;
       sai_thrift_attribute_t thrift_port_list_attribute;
       sai_object_list_t *port_list_object;
+      sai_thrift_arena arena;
       int max_ports = 0;
       status = sai_api_query(SAI_API_SWITCH, (void **) &switch_api);
       if (status != SAI_STATUS_SUCCESS) {
@@ -902,7 +1643,7 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
       switch_api->get_switch_attribute(1, &max_port_attribute);
       max_ports = max_port_attribute.value.u32;
       port_list_object_attribute.id = SAI_SWITCH_ATTR_PORT_LIST;
-      port_list_object_attribute.value.objlist.list = (sai_object_id_t *) malloc(sizeof(sai_object_id_t) * max_ports);
+      port_list_object_attribute.value.objlist.list = arena.alloc_array<sai_object_id_t>(max_ports);
       switch_api->get_switch_attribute(1, &port_list_object_attribute);
 
       thrift_attr_list.attr_count = 1;
@@ -915,11 +1656,11 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
           port_list.push_back((sai_thrift_object_id_t) port_list_object->list[index]);
       }
       attr_list.push_back(thrift_port_list_attribute);
-      free(port_list_object_attribute.value.objlist.list);
   }
 
   sai_thrift_status_t sai_thrift_set_switch_attribute(const sai_thrift_attribute_t& thrift_attr) {
       printf("sai_thrift_set_switch_attribute\n");
+      sai_thrift_api_guard guard(SAI_API_SWITCH);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_switch_api_t *switch_api;
       sai_attribute_t attr;
@@ -928,11 +1669,10 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
           printf("sai_api_query failed!!!\n");
           return status;
       }
-      attr.id = thrift_attr.id;
-      switch(thrift_attr.id) {
-          case SAI_SWITCH_ATTR_SRC_MAC_ADDRESS:
-              sai_thrift_string_to_mac(thrift_attr.value.mac, attr.value.mac);
-              break;
+      sai_thrift_arena arena;
+      status = sai_thrift_parse_switch_attribute(thrift_attr, &attr, arena);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
       }
       status = switch_api->set_switch_attribute(&attr);
       return status;
@@ -940,6 +1680,7 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
 
   sai_thrift_object_id_t sai_thrift_create_hostif(const std::vector<sai_thrift_attribute_t> & thrift_attr_list) {
       printf("sai_thrift_create_hostif\n");
+      sai_thrift_api_guard guard(SAI_API_HOST_INTERFACE);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_hostif_api_t *hostif_api;
       sai_object_id_t hif_id;
@@ -947,16 +1688,20 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
       if (status != SAI_STATUS_SUCCESS) {
           return status;
       }
-      sai_attribute_t *attr_list = (sai_attribute_t *) malloc(sizeof(sai_attribute_t) * thrift_attr_list.size());
-      sai_thrift_parse_hostif_attributes(thrift_attr_list, attr_list);
+      sai_thrift_arena arena;
+      sai_attribute_t *attr_list = arena.alloc_array<sai_attribute_t>(thrift_attr_list.size());
+      status = sai_thrift_parse_hostif_attributes(thrift_attr_list, attr_list, arena);
+      if (status != SAI_STATUS_SUCCESS) {
+          return SAI_NULL_OBJECT_ID;
+      }
       uint32_t attr_count = thrift_attr_list.size();
       status = hostif_api->create_hostif(&hif_id, attr_count, attr_list);
-      free(attr_list);
       return hif_id;
   }
 
   sai_thrift_status_t sai_thrift_remove_hostif(const sai_thrift_object_id_t hif_id) {
        printf("sai_thrift_remove_hostif\n");
+      sai_thrift_api_guard guard(SAI_API_HOST_INTERFACE);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_hostif_api_t *hostif_api;
       status = sai_api_query(SAI_API_HOST_INTERFACE, (void **) &hostif_api);
@@ -969,6 +1714,7 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
 
   sai_thrift_object_id_t sai_thrift_create_hostif_trap_group(const std::vector<sai_thrift_attribute_t> & thrift_attr_list) {
       printf("sai_thrift_create_hostif_trap_group\n");
+      sai_thrift_api_guard guard(SAI_API_HOST_INTERFACE);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_hostif_api_t *hostif_api;
       sai_object_id_t hif_trap_group_id;
@@ -976,16 +1722,20 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
       if (status != SAI_STATUS_SUCCESS) {
           return status;
       }
-      sai_attribute_t *attr_list = (sai_attribute_t *) malloc(sizeof(sai_attribute_t) * thrift_attr_list.size());
-      sai_thrift_parse_hostif_trap_group_attributes(thrift_attr_list, attr_list);
+      sai_thrift_arena arena;
+      sai_attribute_t *attr_list = arena.alloc_array<sai_attribute_t>(thrift_attr_list.size());
+      status = sai_thrift_parse_hostif_trap_group_attributes(thrift_attr_list, attr_list, arena);
+      if (status != SAI_STATUS_SUCCESS) {
+          return SAI_NULL_OBJECT_ID;
+      }
       uint32_t attr_count = thrift_attr_list.size();
       status = hostif_api->create_hostif_trap_group(&hif_trap_group_id, attr_count, attr_list);
-      free(attr_list);
       return hif_trap_group_id;
   }
 
   sai_thrift_status_t sai_thrift_remove_hostif_trap_group(const sai_thrift_object_id_t hif_trap_group_id) {
       printf("sai_thrift_remove_hostif_trap_group\n");
+      sai_thrift_api_guard guard(SAI_API_HOST_INTERFACE);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_hostif_api_t *hostif_api;
       status = sai_api_query(SAI_API_HOST_INTERFACE, (void **) &hostif_api);
@@ -1008,6 +1758,7 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
 
   sai_thrift_status_t sai_thrift_set_hostif_trap(const sai_thrift_hostif_trap_id_t trap_id, const sai_thrift_attribute_t& thrift_attr) {
       printf("sai_thrift_set_hostif_trap\n");
+      sai_thrift_api_guard guard(SAI_API_HOST_INTERFACE);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_hostif_api_t *hostif_api;
       sai_attribute_t attr;
@@ -1015,143 +1766,17 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
       if (status != SAI_STATUS_SUCCESS) {
           return status;
       }
-      sai_thrift_parse_hostif_trap_attribute(thrift_attr, &attr);
+      sai_thrift_arena arena;
+      status = sai_thrift_parse_hostif_trap_attribute(thrift_attr, &attr, arena);
+      if (status != SAI_STATUS_SUCCESS) {
+          return status;
+      }
       status = hostif_api->set_trap_attribute((sai_hostif_trap_id_t) trap_id, &attr);
       return status;
   }
 
-  void sai_thrift_parse_acl_table_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list) {
-      std::vector<sai_thrift_attribute_t>::const_iterator it = thrift_attr_list.begin();
-      sai_thrift_attribute_t attribute;
-      for(uint32_t i = 0; i < thrift_attr_list.size(); i++, it++) {
-          attribute = (sai_thrift_attribute_t)*it;
-          attr_list[i].id = attribute.id;
-          switch (attribute.id) {
-            case SAI_ACL_TABLE_ATTR_FIELD_SRC_IPv6:
-            case SAI_ACL_TABLE_ATTR_FIELD_DST_IPv6:
-            case SAI_ACL_TABLE_ATTR_FIELD_SRC_MAC:
-            case SAI_ACL_TABLE_ATTR_FIELD_DST_MAC:
-            case SAI_ACL_TABLE_ATTR_FIELD_SRC_IP:
-            case SAI_ACL_TABLE_ATTR_FIELD_DST_IP:
-            case SAI_ACL_TABLE_ATTR_FIELD_IN_PORTS:
-            case SAI_ACL_TABLE_ATTR_FIELD_OUT_PORTS:
-            case SAI_ACL_TABLE_ATTR_FIELD_IN_PORT:
-            case SAI_ACL_TABLE_ATTR_FIELD_OUT_PORT:
-            case SAI_ACL_TABLE_ATTR_FIELD_OUTER_VLAN_ID:
-            case SAI_ACL_TABLE_ATTR_FIELD_OUTER_VLAN_PRI:
-            case SAI_ACL_TABLE_ATTR_FIELD_OUTER_VLAN_CFI:
-            case SAI_ACL_TABLE_ATTR_FIELD_INNER_VLAN_ID:
-            case SAI_ACL_TABLE_ATTR_FIELD_INNER_VLAN_PRI:
-            case SAI_ACL_TABLE_ATTR_FIELD_INNER_VLAN_CFI:
-            case SAI_ACL_TABLE_ATTR_FIELD_L4_SRC_PORT:
-            case SAI_ACL_TABLE_ATTR_FIELD_L4_DST_PORT:
-            case SAI_ACL_TABLE_ATTR_FIELD_ETHER_TYPE:
-            case SAI_ACL_TABLE_ATTR_FIELD_IP_PROTOCOL:
-            case SAI_ACL_TABLE_ATTR_FIELD_DSCP:
-            case SAI_ACL_TABLE_ATTR_FIELD_ECN:
-            case SAI_ACL_TABLE_ATTR_FIELD_TTL:
-            case SAI_ACL_TABLE_ATTR_FIELD_TOS:
-            case SAI_ACL_TABLE_ATTR_FIELD_IP_FLAGS:
-            case SAI_ACL_TABLE_ATTR_FIELD_TCP_FLAGS:
-            case SAI_ACL_TABLE_ATTR_FIELD_IP_TYPE:
-            case SAI_ACL_TABLE_ATTR_FIELD_IP_FRAG:
-            case SAI_ACL_TABLE_ATTR_FIELD_IPv6_FLOW_LABEL:
-            case SAI_ACL_TABLE_ATTR_FIELD_TC:
-                break;
-              default:
-                break;
-          }
-      }
-  }
-
-  void sai_thrift_parse_acl_entry_attributes(const std::vector<sai_thrift_attribute_t> &thrift_attr_list, sai_attribute_t *attr_list) {
-      std::vector<sai_thrift_attribute_t>::const_iterator it = thrift_attr_list.begin();
-      sai_thrift_attribute_t attribute;
-      for(uint32_t i = 0; i < thrift_attr_list.size(); i++, it++) {
-          attribute = (sai_thrift_attribute_t)*it;
-          attr_list[i].id = attribute.id;
-          switch (attribute.id) {
-            case SAI_ACL_ENTRY_ATTR_TABLE_ID:
-                attr_list[i].value.aclfield.data.oid = attribute.value.aclfield.data.oid;
-                break;
-            case SAI_ACL_ENTRY_ATTR_PRIORITY:
-                attr_list[i].value.aclfield.data.u32 = attribute.value.aclfield.data.u32;
-                break;
-            case SAI_ACL_ENTRY_ATTR_ADMIN_STATE:
-                attr_list[i].value.aclfield.data.u8 = attribute.value.aclfield.data.u8;
-                break;
-            case SAI_ACL_ENTRY_ATTR_FIELD_SRC_IPv6:
-            case SAI_ACL_ENTRY_ATTR_FIELD_DST_IPv6:
-                sai_thrift_string_to_v6_ip(attribute.value.aclfield.data.ip6, attr_list[i].value.aclfield.data.ip6);
-                sai_thrift_string_to_v6_ip(attribute.value.aclfield.mask.ip6, attr_list[i].value.aclfield.mask.ip6);
-                break;
-            case SAI_ACL_ENTRY_ATTR_FIELD_SRC_MAC:
-            case SAI_ACL_ENTRY_ATTR_FIELD_DST_MAC:
-                sai_thrift_string_to_mac(attribute.value.aclfield.data.mac, attr_list[i].value.aclfield.data.mac);
-                sai_thrift_string_to_mac(attribute.value.aclfield.mask.mac, attr_list[i].value.aclfield.mask.mac);
-                break;
-            case SAI_ACL_ENTRY_ATTR_FIELD_SRC_IP:
-            case SAI_ACL_ENTRY_ATTR_FIELD_DST_IP:
-                sai_thrift_string_to_v4_ip(attribute.value.aclfield.data.ip4, &attr_list[i].value.aclfield.data.ip4);
-                sai_thrift_string_to_v4_ip(attribute.value.aclfield.mask.ip4, &attr_list[i].value.aclfield.mask.ip4);
-                break;
-            case SAI_ACL_ENTRY_ATTR_FIELD_IN_PORT:
-                attr_list[i].value.aclfield.data.oid = attribute.value.aclfield.data.oid;
-                break;
-            case SAI_ACL_ENTRY_ATTR_FIELD_IN_PORTS:
-                {
-                    int count = attribute.value.aclfield.data.objlist.object_id_list.size();
-                    sai_object_id_t *oid=NULL;
-                    std::vector<sai_thrift_object_id_t>::const_iterator it = attribute.value.aclfield.data.objlist.object_id_list.begin();
-                    oid = (sai_object_id_t *)malloc(sizeof(sai_object_id_t)*count);
-                    for(int i=0;i<count;i++, it++)
-                        *(oid+i) = (sai_object_id_t) *it;
-                    attr_list[i].value.aclfield.data.objlist.list =  oid;
-                    attr_list[i].value.aclfield.data.objlist.count =  count;
-
-                }
-                break;
-            /*
-            case SAI_ACL_ENTRY_ATTR_FIELD_OUT_PORTS:
-            case SAI_ACL_ENTRY_ATTR_FIELD_OUT_PORT:
-            */
-            case SAI_ACL_ENTRY_ATTR_FIELD_OUTER_VLAN_PRI:
-            case SAI_ACL_ENTRY_ATTR_FIELD_OUTER_VLAN_CFI:
-            case SAI_ACL_ENTRY_ATTR_FIELD_INNER_VLAN_PRI:
-            case SAI_ACL_ENTRY_ATTR_FIELD_INNER_VLAN_CFI:
-                break;
-            case SAI_ACL_ENTRY_ATTR_FIELD_OUTER_VLAN_ID:
-            case SAI_ACL_ENTRY_ATTR_FIELD_INNER_VLAN_ID:
-            case SAI_ACL_ENTRY_ATTR_FIELD_L4_SRC_PORT:
-            case SAI_ACL_ENTRY_ATTR_FIELD_L4_DST_PORT:
-            case SAI_ACL_ENTRY_ATTR_FIELD_ETHER_TYPE:
-                attr_list[i].value.aclfield.data.u16 = attribute.value.aclfield.data.u16;
-                attr_list[i].value.aclfield.mask.u16 = attribute.value.aclfield.mask.u16;
-                break;
-            case SAI_ACL_ENTRY_ATTR_FIELD_IP_PROTOCOL:
-            case SAI_ACL_ENTRY_ATTR_FIELD_DSCP:
-            case SAI_ACL_ENTRY_ATTR_FIELD_ECN:
-            case SAI_ACL_ENTRY_ATTR_FIELD_TTL:
-            case SAI_ACL_ENTRY_ATTR_FIELD_TOS:
-//            case SAI_ACL_ENTRY_ATTR_FIELD_IP_FLAGS:
-            case SAI_ACL_ENTRY_ATTR_FIELD_TCP_FLAGS:
-//            case SAI_ACL_ENTRY_ATTR_FIELD_IP_TYPE:
-//            case SAI_ACL_ENTRY_ATTR_FIELD_IP_FRAG:
-            case SAI_ACL_ENTRY_ATTR_FIELD_TC:
-                attr_list[i].value.aclfield.data.u8 = attribute.value.aclfield.data.u8;
-                attr_list[i].value.aclfield.mask.u8 = attribute.value.aclfield.mask.u8;
-                break;
-            case SAI_ACL_ENTRY_ATTR_FIELD_IPv6_FLOW_LABEL:
-                attr_list[i].value.aclfield.data.u16 = attribute.value.aclfield.data.u16;
-                attr_list[i].value.aclfield.mask.u16 = attribute.value.aclfield.mask.u16;
-                break;
-              default:
-                break;
-          }
-      }
-  }
-
   sai_thrift_object_id_t sai_thrift_create_acl_table(const std::vector<sai_thrift_attribute_t> & thrift_attr_list) {
+      sai_thrift_api_guard guard(SAI_API_ACL);
       sai_object_id_t acl_table = 0ULL;
       sai_acl_api_t *acl_api;
       sai_status_t status = SAI_STATUS_SUCCESS;
@@ -1160,15 +1785,19 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
           return status;
       }
 
-      sai_attribute_t *attr_list = (sai_attribute_t *) malloc(sizeof(sai_attribute_t) * thrift_attr_list.size());
-      sai_thrift_parse_acl_table_attributes(thrift_attr_list, attr_list);
+      sai_thrift_arena arena;
+      sai_attribute_t *attr_list = arena.alloc_array<sai_attribute_t>(thrift_attr_list.size());
+      status = sai_thrift_parse_acl_table_attributes(thrift_attr_list, attr_list, arena);
+      if (status != SAI_STATUS_SUCCESS) {
+          return SAI_NULL_OBJECT_ID;
+      }
       uint32_t attr_count = thrift_attr_list.size();
       status = acl_api->create_acl_table(&acl_table, attr_count, attr_list);
-      free(attr_list);
       return acl_table;
   }
 
   sai_thrift_status_t sai_thrift_delete_acl_table(const sai_thrift_object_id_t acl_table_id) {
+      sai_thrift_api_guard guard(SAI_API_ACL);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_acl_api_t *acl_api;
       status = sai_api_query(SAI_API_ACL, (void **) &acl_api);
@@ -1180,6 +1809,7 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
   }
 
   sai_thrift_object_id_t sai_thrift_create_acl_entry(const std::vector<sai_thrift_attribute_t> & thrift_attr_list) {
+      sai_thrift_api_guard guard(SAI_API_NEXT_HOP_GROUP, SAI_API_ACL);
       sai_object_id_t acl_entry = 0ULL;
       sai_acl_api_t *acl_api;
       sai_status_t status = SAI_STATUS_SUCCESS;
@@ -1188,15 +1818,19 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
           return status;
       }
 
-      sai_attribute_t *attr_list = (sai_attribute_t *) malloc(sizeof(sai_attribute_t) * thrift_attr_list.size());
-      sai_thrift_parse_acl_entry_attributes(thrift_attr_list, attr_list);
+      sai_thrift_arena arena;
+      sai_attribute_t *attr_list = arena.alloc_array<sai_attribute_t>(thrift_attr_list.size());
+      status = sai_thrift_parse_acl_entry_attributes(thrift_attr_list, attr_list, arena);
+      if (status != SAI_STATUS_SUCCESS) {
+          return SAI_NULL_OBJECT_ID;
+      }
       uint32_t attr_count = thrift_attr_list.size();
       status = acl_api->create_acl_entry(&acl_entry, attr_count, attr_list);
-      free(attr_list);
       return acl_entry;
   }
 
   sai_thrift_status_t sai_thrift_delete_acl_entry(const sai_thrift_object_id_t acl_entry) {
+      sai_thrift_api_guard guard(SAI_API_ACL);
       sai_status_t status = SAI_STATUS_SUCCESS;
       sai_acl_api_t *acl_api;
       status = sai_api_query(SAI_API_ACL, (void **) &acl_api);
@@ -1209,33 +1843,92 @@ class switch_sai_rpcHandler : virtual public switch_sai_rpcIf {
 
 };
 
+typedef struct switch_sai_thrift_rpc_server_args_ {
+  int port;
+  int num_workers;
+  int transport;
+} switch_sai_thrift_rpc_server_args_t;
+
 static void * switch_sai_thrift_rpc_server_thread(void *arg) {
-  int port = *(int *) arg;
+  switch_sai_thrift_rpc_server_args_t *server_args = (switch_sai_thrift_rpc_server_args_t *) arg;
+  int port = server_args->port;
+  int num_workers = server_args->num_workers;
+  int transport = server_args->transport;
+  free(server_args);
   shared_ptr<switch_sai_rpcHandler> handler(new switch_sai_rpcHandler());
   shared_ptr<TProcessor> processor(new switch_sai_rpcProcessor(handler));
   shared_ptr<TServerTransport> serverTransport(new TServerSocket(port));
-  shared_ptr<TTransportFactory> transportFactory(new TBufferedTransportFactory());
-  shared_ptr<TProtocolFactory> protocolFactory(new TBinaryProtocolFactory());
-
-  TSimpleServer server(processor, serverTransport, transportFactory, protocolFactory);
-  server.serve();
+  shared_ptr<TTransportFactory> transportFactory;
+  shared_ptr<TProtocolFactory> protocolFactory;
+
+  switch (transport) {
+      case SAI_THRIFT_RPC_TRANSPORT_FRAMED_COMPACT:
+          transportFactory.reset(new TFramedTransportFactory());
+          protocolFactory.reset(new TCompactProtocolFactory());
+          break;
+      case SAI_THRIFT_RPC_TRANSPORT_BUFFERED_BINARY:
+      default:
+          transportFactory.reset(new TBufferedTransportFactory());
+          protocolFactory.reset(new TBinaryProtocolFactory());
+          break;
+  }
+
+  if (num_workers > 0) {
+      shared_ptr<ThreadManager> threadManager = ThreadManager::newSimpleThreadManager(num_workers);
+      shared_ptr<PosixThreadFactory> threadFactory(new PosixThreadFactory());
+      threadManager->threadFactory(threadFactory);
+      threadManager->start();
+      TThreadPoolServer server(processor, serverTransport, transportFactory, protocolFactory, threadManager);
+      server.serve();
+  } else {
+      TSimpleServer server(processor, serverTransport, transportFactory, protocolFactory);
+      server.serve();
+  }
   return 0;
 }
 
 static pthread_t switch_sai_thrift_rpc_thread;
 
 extern "C" {
-extern void sai_initialize(void);
 
-int start_p4_sai_thrift_rpc_server(int port)
+int start_p4_sai_thrift_rpc_server_with_options(int port, int num_workers, int transport)
 {
-    std::cerr << "Starting SAI RPC server on port " << port << std::endl;
-
-    int *port_arg = (int *) malloc(sizeof(int));
-    *port_arg = port;
+    sai_status_t status = SAI_STATUS_SUCCESS;
+
+    std::cerr << "Starting SAI RPC server on port " << port
+              << " with " << num_workers << " workers"
+              << (transport == SAI_THRIFT_RPC_TRANSPORT_FRAMED_COMPACT ?
+                  ", framed/compact" : ", buffered/binary")
+              << std::endl;
+
+    switch_sai_thrift_rpc_server_args_t *server_args =
+        (switch_sai_thrift_rpc_server_args_t *) malloc(sizeof(switch_sai_thrift_rpc_server_args_t));
+    server_args->port = port;
+    server_args->num_workers = num_workers;
+    server_args->transport = transport;
+
+    for (int api = 0; api <= SAI_API_SCHEDULER_GROUP; api++) {
+        pthread_mutex_init(&sai_thrift_api_lock[api], NULL);
+    }
+
+    status = sai_initialize();
+    if (status != SAI_STATUS_SUCCESS) {
+        std::cerr << "SAI initialization failed: " << status << std::endl;
+        free(server_args);
+        return status;
+    }
+
+    return pthread_create(&switch_sai_thrift_rpc_thread, NULL, switch_sai_thrift_rpc_server_thread, server_args);
+}
 
-    sai_initialize();
+int start_p4_sai_thrift_rpc_server_with_workers(int port, int num_workers)
+{
+    return start_p4_sai_thrift_rpc_server_with_options(port, num_workers,
+                                                       SAI_THRIFT_RPC_TRANSPORT_BUFFERED_BINARY);
+}
 
-    return pthread_create(&switch_sai_thrift_rpc_thread, NULL, switch_sai_thrift_rpc_server_thread, port_arg);
+int start_p4_sai_thrift_rpc_server(int port)
+{
+    return start_p4_sai_thrift_rpc_server_with_workers(port, 0);
 }
 }
@@ -0,0 +1,44 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef __SWITCH_SAI_RPC_SERVER_H_
+#define __SWITCH_SAI_RPC_SERVER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Transport/protocol pairs the RPC server can be started with. There is no
+ * in-band negotiation in thrift, so clients must open the same pair, e.g.
+ * TFramedTransport + TCompactProtocol for SAI_THRIFT_RPC_TRANSPORT_FRAMED_COMPACT.
+ */
+#define SAI_THRIFT_RPC_TRANSPORT_BUFFERED_BINARY        0
+#define SAI_THRIFT_RPC_TRANSPORT_FRAMED_COMPACT         1
+
+/*
+ * Start the SAI RPC server on port. With num_workers > 0 requests are served
+ * by a pool of that many threads, otherwise by a single-threaded server.
+ */
+int start_p4_sai_thrift_rpc_server_with_options(int port, int num_workers, int transport);
+int start_p4_sai_thrift_rpc_server_with_workers(int port, int num_workers);
+int start_p4_sai_thrift_rpc_server(int port);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SWITCH_SAI_RPC_SERVER_H_
@@ -0,0 +1,166 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+* Flow disruption simulator for next hop group member changes.
+*
+* A set of random flow hashes is spread over the ECMP members the SAI
+* layer programs, picking member hash % count the way a plain ECMP table
+* does. Each scenario changes the group through the SAI API and counts
+* the flows that changed next hop, split into flows whose old next hop
+* left the group (unavoidable) and flows whose next hop stayed (collateral).
+* A resilient group would keep the collateral at 0; SAI has none, as
+* switchapi cannot rewrite one ECMP member slot in place.
+*
+* Member positions come from the mock, which appends new members and
+* closes the gap left by a deleted one. Real switchapi may place members
+* differently; the collateral figures hold for this model only.
+*
+* usage: nhop_group_flow_sim [flows]
+*/
+
+#include "switchapi_mock.h"
+#include "saiinternal.h"
+
+#define SIM_DEFAULT_FLOWS       100000
+#define SIM_MEMBERS             8
+
+extern sai_next_hop_group_api_t nhop_group_api;
+
+static uint32_t sim_flow_count;
+static uint32_t *sim_flows;
+static switch_handle_t *sim_before;
+
+static uint32_t sim_random(void) {
+    static uint64_t state = 0x9E3779B97F4A7C15ULL;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return (uint32_t) state;
+}
+
+static void sim_snapshot(
+        sai_object_id_t group_id,
+        switch_handle_t *next_hops) {
+    const switch_handle_t *members = NULL;
+    uint32_t count = 0;
+    uint32_t index = 0;
+
+    count = mock_ecmp_members(sai_next_hop_group_nhop_get(group_id), &members);
+    for (index = 0; index < sim_flow_count; index++) {
+        next_hops[index] = count ? members[sim_flows[index] % count] : 0;
+    }
+}
+
+static bool sim_member(
+        sai_object_id_t group_id,
+        switch_handle_t next_hop) {
+    const switch_handle_t *members = NULL;
+    uint32_t count = 0;
+    uint32_t index = 0;
+
+    count = mock_ecmp_members(sai_next_hop_group_nhop_get(group_id), &members);
+    for (index = 0; index < count; index++) {
+        if (members[index] == next_hop) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void sim_report(
+        const char *scenario,
+        sai_object_id_t group_id,
+        switch_handle_t *after) {
+    uint32_t moved = 0, collateral = 0;
+    uint32_t index = 0;
+
+    sim_snapshot(group_id, after);
+    for (index = 0; index < sim_flow_count; index++) {
+        if (sim_before[index] == after[index]) {
+            continue;
+        }
+        moved++;
+        if (sim_member(group_id, sim_before[index])) {
+            collateral++;
+        }
+        // a flow never lands on a next hop that is not in the group
+        CHECK(sim_member(group_id, after[index]));
+    }
+    printf("%-28s moved %6.2f%%  collateral %6.2f%%\n", scenario,
+           100.0 * moved / sim_flow_count, 100.0 * collateral / sim_flow_count);
+    memcpy(sim_before, after, sizeof(switch_handle_t) * sim_flow_count);
+}
+
+int main(int argc, char **argv) {
+    sai_api_service_t service;
+    sai_object_id_t next_hops[SIM_MEMBERS + 1];
+    sai_object_id_t group_id = 0;
+    sai_attribute_t attr;
+    switch_handle_t *after = NULL;
+    uint32_t index = 0;
+
+    sim_flow_count = (argc > 1) ? (uint32_t) atoi(argv[1]) : SIM_DEFAULT_FLOWS;
+    if (!sim_flow_count) {
+        fprintf(stderr, "usage: %s [flows]\n", argv[0]);
+        return 1;
+    }
+    sim_flows = (uint32_t *) malloc(sizeof(uint32_t) * sim_flow_count);
+    sim_before = (switch_handle_t *) malloc(sizeof(switch_handle_t) * sim_flow_count);
+    after = (switch_handle_t *) malloc(sizeof(switch_handle_t) * sim_flow_count);
+    if (!sim_flows || !sim_before || !after) {
+        return 1;
+    }
+    for (index = 0; index < sim_flow_count; index++) {
+        sim_flows[index] = sim_random();
+    }
+
+    sai_route_initialize(&service);
+    sai_next_hop_group_initialize(&service);
+    mock_reset();
+
+    for (index = 0; index <= SIM_MEMBERS; index++) {
+        next_hops[index] = MOCK_NHOP_BASE + 1 + index;
+    }
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_LIST;
+    attr.value.objlist.count = SIM_MEMBERS;
+    attr.value.objlist.list = next_hops;
+    CHECK(nhop_group_api.create_next_hop_group(&group_id, 1, &attr) == SAI_STATUS_SUCCESS);
+    sim_snapshot(group_id, sim_before);
+
+    printf("%u flows, %u members\n", sim_flow_count, SIM_MEMBERS);
+    CHECK(nhop_group_api.remove_next_hop_from_group(group_id, 1, &next_hops[SIM_MEMBERS - 1]) ==
+          SAI_STATUS_SUCCESS);
+    sim_report("remove last member", group_id, after);
+    CHECK(nhop_group_api.add_next_hop_to_group(group_id, 1, &next_hops[SIM_MEMBERS - 1]) ==
+          SAI_STATUS_SUCCESS);
+    sim_report("add it back", group_id, after);
+    CHECK(nhop_group_api.remove_next_hop_from_group(group_id, 1, &next_hops[0]) ==
+          SAI_STATUS_SUCCESS);
+    sim_report("remove first member", group_id, after);
+    CHECK(nhop_group_api.add_next_hop_to_group(group_id, 1, &next_hops[SIM_MEMBERS]) ==
+          SAI_STATUS_SUCCESS);
+    sim_report("add a new member", group_id, after);
+    CHECK(nhop_group_api.add_next_hop_to_group(group_id, 1, &next_hops[0]) ==
+          SAI_STATUS_SUCCESS);
+    sim_report("add first member back", group_id, after);
+
+    free(after);
+    free(sim_before);
+    free(sim_flows);
+    CHECK_DONE();
+}
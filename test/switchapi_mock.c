@@ -0,0 +1,508 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <stdarg.h>
+#include "switchapi_mock.h"
+#include <switchapi/switch_hostif.h>
+#include <switchapi/switch_l2.h>
+#include <switchapi/switch_l3.h>
+#include <switchapi/switch_lag.h>
+#include <switchapi/switch_neighbor.h>
+#include <switchapi/switch_nhop.h>
+
+#define MOCK_NEIGHBOR_BASE      0x3000
+#define MOCK_ECMP_BASE          0x4000
+#define MOCK_LAG_BASE           0x5000
+
+typedef struct _mock_group_t {
+    bool used;
+    unsigned count;
+    switch_handle_t members[MOCK_MAX_MEMBERS];
+} mock_group_t;
+
+switch_device_t device;
+
+unsigned mock_calls;
+unsigned mock_fail_at;
+unsigned mock_failures;
+
+static mock_route_t mock_routes[MOCK_MAX_OBJECTS];
+static unsigned mock_route_used;
+static bool mock_neighbors[MOCK_MAX_OBJECTS];
+static mock_group_t mock_ecmps[MOCK_MAX_OBJECTS];
+static mock_group_t mock_lags[MOCK_MAX_OBJECTS];
+static switch_api_mac_entry_t mock_macs[MOCK_MAX_MAC_ENTRIES];
+static unsigned mock_mac_used;
+static uint64_t mock_mac_aging;
+
+void my_log(int level, sai_api_t api, char *fmt, ...) {
+}
+
+void mock_reset(void) {
+    mock_calls = 0;
+    mock_fail_at = 0;
+    mock_route_used = 0;
+    memset(mock_neighbors, 0, sizeof(mock_neighbors));
+    memset(mock_ecmps, 0, sizeof(mock_ecmps));
+    memset(mock_lags, 0, sizeof(mock_lags));
+    mock_mac_used = 0;
+    mock_mac_aging = 0;
+}
+
+// count a state changing call, true if it is the one to fail
+static bool mock_fail(void) {
+    return ++mock_calls == mock_fail_at;
+}
+
+/*
+* Routes
+*/
+static int mock_route_index(
+        switch_handle_t vrf_handle,
+        const switch_ip_addr_t *ip_addr) {
+    unsigned index = 0;
+
+    for (index = 0; index < mock_route_used; index++) {
+        if (mock_routes[index].vrf_handle == vrf_handle &&
+            mock_routes[index].ip_addr.type == ip_addr->type &&
+            mock_routes[index].ip_addr.prefix_len == ip_addr->prefix_len &&
+            !memcmp(&mock_routes[index].ip_addr.ip, &ip_addr->ip, sizeof(ip_addr->ip))) {
+            return (int) index;
+        }
+    }
+    return -1;
+}
+
+unsigned mock_route_count(void) {
+    return mock_route_used;
+}
+
+const mock_route_t *mock_route_find(
+        switch_handle_t vrf_handle,
+        const switch_ip_addr_t *ip_addr) {
+    int index = mock_route_index(vrf_handle, ip_addr);
+    return (index < 0) ? NULL : &mock_routes[index];
+}
+
+switch_status_t switch_api_l3_route_add(
+        switch_device_t device,
+        switch_handle_t vrf_handle,
+        switch_ip_addr_t *ip_addr,
+        switch_handle_t nhop_handle) {
+    if (mock_fail() || mock_route_index(vrf_handle, ip_addr) >= 0 ||
+        !nhop_handle || mock_route_used == MOCK_MAX_OBJECTS) {
+        return SAI_STATUS_FAILURE;
+    }
+    mock_routes[mock_route_used].vrf_handle = vrf_handle;
+    mock_routes[mock_route_used].ip_addr = *ip_addr;
+    mock_routes[mock_route_used].nhop_handle = nhop_handle;
+    mock_route_used++;
+    return SAI_STATUS_SUCCESS;
+}
+
+switch_status_t switch_api_l3_route_update(
+        switch_device_t device,
+        switch_handle_t vrf_handle,
+        switch_ip_addr_t *ip_addr,
+        switch_handle_t nhop_handle) {
+    int index = mock_route_index(vrf_handle, ip_addr);
+
+    if (mock_fail() || index < 0 || !nhop_handle) {
+        return SAI_STATUS_FAILURE;
+    }
+    mock_routes[index].nhop_handle = nhop_handle;
+    return SAI_STATUS_SUCCESS;
+}
+
+switch_status_t switch_api_l3_route_delete(
+        switch_device_t device,
+        switch_handle_t vrf_handle,
+        switch_ip_addr_t *ip_addr,
+        switch_handle_t nhop_handle) {
+    int index = mock_route_index(vrf_handle, ip_addr);
+
+    if (mock_fail() || index < 0) {
+        return SAI_STATUS_FAILURE;
+    }
+    mock_routes[index] = mock_routes[--mock_route_used];
+    return SAI_STATUS_SUCCESS;
+}
+
+switch_handle_t switch_api_cpu_nhop_get(
+        switch_hostif_reason_code_t reason_code) {
+    return MOCK_CPU_NHOP_BASE + reason_code;
+}
+
+/*
+* Next hops and neighbor rewrites
+*/
+switch_handle_t mock_nhop_handle(
+        const switch_ip_addr_t *ip_addr) {
+    return MOCK_NHOP_BASE + (ip_addr->ip.v4addr & 0xFF);
+}
+
+switch_handle_t switch_api_nhop_handle_get(
+        switch_nhop_key_t *nhop_key) {
+    return mock_nhop_handle(&nhop_key->ip_addr);
+}
+
+unsigned mock_neighbor_count(void) {
+    unsigned count = 0;
+    unsigned index = 0;
+
+    for (index = 0; index < MOCK_MAX_OBJECTS; index++) {
+        count += mock_neighbors[index];
+    }
+    return count;
+}
+
+switch_handle_t switch_api_neighbor_entry_add(
+        switch_device_t device,
+        switch_api_neighbor_t *api_neighbor) {
+    unsigned index = 0;
+
+    if (mock_fail()) {
+        return SWITCH_API_INVALID_HANDLE;
+    }
+    for (index = 0; index < MOCK_MAX_OBJECTS; index++) {
+        if (!mock_neighbors[index]) {
+            mock_neighbors[index] = true;
+            return MOCK_NEIGHBOR_BASE + index;
+        }
+    }
+    return SWITCH_API_INVALID_HANDLE;
+}
+
+switch_status_t switch_api_neighbor_entry_remove(
+        switch_device_t device,
+        switch_handle_t neighbor_handle) {
+    switch_handle_t index = neighbor_handle - MOCK_NEIGHBOR_BASE;
+
+    if (mock_fail() || index >= MOCK_MAX_OBJECTS || !mock_neighbors[index]) {
+        return SAI_STATUS_FAILURE;
+    }
+    mock_neighbors[index] = false;
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+* ECMP groups and LAGs share the member list handling
+*/
+static mock_group_t *mock_group_get(
+        mock_group_t *groups,
+        switch_handle_t base,
+        switch_handle_t handle) {
+    switch_handle_t index = handle - base;
+
+    if (index >= MOCK_MAX_OBJECTS || !groups[index].used) {
+        return NULL;
+    }
+    return &groups[index];
+}
+
+static switch_handle_t mock_group_create(
+        mock_group_t *groups,
+        switch_handle_t base) {
+    unsigned index = 0;
+
+    if (mock_fail()) {
+        return SWITCH_API_INVALID_HANDLE;
+    }
+    for (index = 0; index < MOCK_MAX_OBJECTS; index++) {
+        if (!groups[index].used) {
+            groups[index].used = true;
+            groups[index].count = 0;
+            return base + index;
+        }
+    }
+    return SWITCH_API_INVALID_HANDLE;
+}
+
+static switch_status_t mock_group_delete(
+        mock_group_t *groups,
+        switch_handle_t base,
+        switch_handle_t handle) {
+    mock_group_t *group = mock_group_get(groups, base, handle);
+
+    if (mock_fail() || !group) {
+        return SAI_STATUS_FAILURE;
+    }
+    group->used = false;
+    return SAI_STATUS_SUCCESS;
+}
+
+static switch_status_t mock_group_member_add(
+        mock_group_t *groups,
+        switch_handle_t base,
+        switch_handle_t handle,
+        unsigned count,
+        const switch_handle_t *members) {
+    mock_group_t *group = mock_group_get(groups, base, handle);
+    unsigned index = 0;
+
+    if (mock_fail() || !group || group->count + count > MOCK_MAX_MEMBERS) {
+        return SAI_STATUS_FAILURE;
+    }
+    for (index = 0; index < count; index++) {
+        group->members[group->count++] = members[index];
+    }
+    return SAI_STATUS_SUCCESS;
+}
+
+static switch_status_t mock_group_member_delete(
+        mock_group_t *groups,
+        switch_handle_t base,
+        switch_handle_t handle,
+        unsigned count,
+        const switch_handle_t *members) {
+    mock_group_t *group = mock_group_get(groups, base, handle);
+    unsigned index = 0, pos = 0;
+
+    if (mock_fail() || !group) {
+        return SAI_STATUS_FAILURE;
+    }
+    for (index = 0; index < count; index++) {
+        for (pos = 0; pos < group->count && group->members[pos] != members[index]; pos++) {
+        }
+        if (pos == group->count) {
+            return SAI_STATUS_FAILURE;
+        }
+        memmove(&group->members[pos], &group->members[pos + 1],
+                sizeof(switch_handle_t) * (group->count - pos - 1));
+        group->count--;
+    }
+    return SAI_STATUS_SUCCESS;
+}
+
+static unsigned mock_group_count(
+        const mock_group_t *groups) {
+    unsigned count = 0;
+    unsigned index = 0;
+
+    for (index = 0; index < MOCK_MAX_OBJECTS; index++) {
+        count += groups[index].used;
+    }
+    return count;
+}
+
+unsigned mock_ecmp_count(void) {
+    return mock_group_count(mock_ecmps);
+}
+
+unsigned mock_ecmp_members(
+        switch_handle_t ecmp_handle,
+        const switch_handle_t **members) {
+    mock_group_t *group = mock_group_get(mock_ecmps, MOCK_ECMP_BASE, ecmp_handle);
+
+    if (!group) {
+        return 0;
+    }
+    *members = group->members;
+    return group->count;
+}
+
+switch_handle_t switch_api_ecmp_create(
+        switch_device_t device) {
+    return mock_group_create(mock_ecmps, MOCK_ECMP_BASE);
+}
+
+switch_status_t switch_api_ecmp_delete(
+        switch_device_t device,
+        switch_handle_t ecmp_handle) {
+    return mock_group_delete(mock_ecmps, MOCK_ECMP_BASE, ecmp_handle);
+}
+
+switch_status_t switch_api_ecmp_member_add(
+        switch_device_t device,
+        switch_handle_t ecmp_handle,
+        uint16_t nhop_count,
+        switch_handle_t *nhop_handle_list) {
+    return mock_group_member_add(mock_ecmps, MOCK_ECMP_BASE, ecmp_handle,
+                                 nhop_count, nhop_handle_list);
+}
+
+switch_status_t switch_api_ecmp_member_delete(
+        switch_device_t device,
+        switch_handle_t ecmp_handle,
+        uint16_t nhop_count,
+        switch_handle_t *nhop_handle_list) {
+    return mock_group_member_delete(mock_ecmps, MOCK_ECMP_BASE, ecmp_handle,
+                                    nhop_count, nhop_handle_list);
+}
+
+unsigned mock_lag_count(void) {
+    return mock_group_count(mock_lags);
+}
+
+unsigned mock_lag_members(
+        switch_handle_t lag_handle,
+        const switch_handle_t **members) {
+    mock_group_t *group = mock_group_get(mock_lags, MOCK_LAG_BASE, lag_handle);
+
+    if (!group) {
+        return 0;
+    }
+    *members = group->members;
+    return group->count;
+}
+
+switch_handle_t switch_api_lag_create(
+        switch_device_t device) {
+    return mock_group_create(mock_lags, MOCK_LAG_BASE);
+}
+
+switch_status_t switch_api_lag_delete(
+        switch_device_t device,
+        switch_handle_t lag_handle) {
+    return mock_group_delete(mock_lags, MOCK_LAG_BASE, lag_handle);
+}
+
+switch_status_t switch_api_lag_member_add(
+        switch_device_t device,
+        switch_handle_t lag_handle,
+        switch_direction_t direction,
+        switch_handle_t port) {
+    return mock_group_member_add(mock_lags, MOCK_LAG_BASE, lag_handle, 1, &port);
+}
+
+switch_status_t switch_api_lag_member_delete(
+        switch_device_t device,
+        switch_handle_t lag_handle,
+        switch_direction_t direction,
+        switch_handle_t port) {
+    return mock_group_member_delete(mock_lags, MOCK_LAG_BASE, lag_handle, 1, &port);
+}
+
+/*
+* MAC table
+*/
+static int mock_mac_index(
+        switch_handle_t vlan_handle,
+        const uint8_t *mac) {
+    unsigned index = 0;
+
+    for (index = 0; index < mock_mac_used; index++) {
+        if (mock_macs[index].vlan_handle == vlan_handle &&
+            !memcmp(mock_macs[index].mac.mac_addr, mac, sizeof(switch_mac_addr_t))) {
+            return (int) index;
+        }
+    }
+    return -1;
+}
+
+unsigned mock_mac_count(void) {
+    return mock_mac_used;
+}
+
+const switch_api_mac_entry_t *mock_mac_find(
+        switch_handle_t vlan_handle,
+        const uint8_t *mac) {
+    int index = mock_mac_index(vlan_handle, mac);
+    return (index < 0) ? NULL : &mock_macs[index];
+}
+
+uint64_t mock_mac_aging_time(void) {
+    return mock_mac_aging;
+}
+
+switch_status_t switch_api_mac_table_aging_time_set(
+        uint64_t value) {
+    if (mock_fail()) {
+        return SAI_STATUS_FAILURE;
+    }
+    mock_mac_aging = value;
+    return SAI_STATUS_SUCCESS;
+}
+
+switch_status_t switch_api_mac_table_entry_add(
+        switch_device_t device,
+        switch_api_mac_entry_t *mac_entry) {
+    if (mock_fail() || mock_mac_index(mac_entry->vlan_handle, mac_entry->mac.mac_addr) >= 0 ||
+        mock_mac_used == MOCK_MAX_MAC_ENTRIES) {
+        return SAI_STATUS_FAILURE;
+    }
+    mock_macs[mock_mac_used++] = *mac_entry;
+    return SAI_STATUS_SUCCESS;
+}
+
+switch_status_t switch_api_mac_table_entry_update(
+        switch_device_t device,
+        switch_api_mac_entry_t *mac_entry) {
+    int index = mock_mac_index(mac_entry->vlan_handle, mac_entry->mac.mac_addr);
+
+    if (mock_fail() || index < 0) {
+        return SAI_STATUS_FAILURE;
+    }
+    mock_macs[index] = *mac_entry;
+    return SAI_STATUS_SUCCESS;
+}
+
+switch_status_t switch_api_mac_table_entry_delete(
+        switch_device_t device,
+        switch_api_mac_entry_t *mac_entry) {
+    int index = mock_mac_index(mac_entry->vlan_handle, mac_entry->mac.mac_addr);
+
+    if (mock_fail() || index < 0) {
+        return SAI_STATUS_FAILURE;
+    }
+    memmove(&mock_macs[index], &mock_macs[index + 1],
+            sizeof(switch_api_mac_entry_t) * (mock_mac_used - index - 1));
+    mock_mac_used--;
+    return SAI_STATUS_SUCCESS;
+}
+
+// delete every entry on the VLAN and port given, 0 matches any
+static switch_status_t mock_mac_delete_matching(
+        switch_handle_t vlan_handle,
+        switch_handle_t intf_handle) {
+    unsigned index = 0, kept = 0;
+
+    if (mock_fail()) {
+        return SAI_STATUS_FAILURE;
+    }
+    for (index = 0; index < mock_mac_used; index++) {
+        if ((vlan_handle && mock_macs[index].vlan_handle != vlan_handle) ||
+            (intf_handle && mock_macs[index].handle != intf_handle)) {
+            mock_macs[kept++] = mock_macs[index];
+        }
+    }
+    mock_mac_used = kept;
+    return SAI_STATUS_SUCCESS;
+}
+
+switch_status_t switch_api_mac_table_entries_delete_all(
+        switch_device_t device) {
+    return mock_mac_delete_matching(0, 0);
+}
+
+switch_status_t switch_api_mac_table_entries_delete_by_vlan(
+        switch_device_t device,
+        switch_handle_t vlan_handle) {
+    return mock_mac_delete_matching(vlan_handle, 0);
+}
+
+switch_status_t switch_api_mac_table_entries_delete_by_interface(
+        switch_device_t device,
+        switch_handle_t intf_handle) {
+    return mock_mac_delete_matching(0, intf_handle);
+}
+
+switch_status_t switch_api_mac_table_entries_delete_by_interface_vlan(
+        switch_device_t device,
+        switch_handle_t intf_handle,
+        switch_handle_t vlan_handle) {
+    return mock_mac_delete_matching(vlan_handle, intf_handle);
+}
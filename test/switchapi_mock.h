@@ -0,0 +1,103 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _SWITCHAPI_MOCK_H
+#define _SWITCHAPI_MOCK_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sai.h>
+#include <switchapi/switch_base_types.h>
+#include <switchapi/switch_l2.h>
+
+/*
+* In-memory stand-in for the switchapi calls made by the SAI modules under
+* test. It keeps the state switchapi would program so that tests can check
+* what reached the data plane, and can fail a chosen call to exercise the
+* rollback paths.
+*
+* ECMP and LAG members are kept in the order they were added; a member
+* delete removes the first occurrence and closes the gap. MAC entries are
+* keyed by (VLAN handle, MAC) as in switchapi.
+*/
+#define MOCK_MAX_OBJECTS        256
+#define MOCK_MAX_MEMBERS        1024
+#define MOCK_MAX_MAC_ENTRIES    4096
+
+typedef struct _mock_route_t {
+    switch_handle_t vrf_handle;
+    switch_ip_addr_t ip_addr;
+    switch_handle_t nhop_handle;
+} mock_route_t;
+
+extern unsigned mock_calls;             // switchapi calls that change state
+extern unsigned mock_fail_at;           // fail the n-th such call, 0 never
+
+void mock_reset(void);
+
+// routes
+unsigned mock_route_count(void);
+const mock_route_t *mock_route_find(
+        switch_handle_t vrf_handle,
+        const switch_ip_addr_t *ip_addr);
+
+// neighbor rewrites
+unsigned mock_neighbor_count(void);
+switch_handle_t mock_nhop_handle(
+        const switch_ip_addr_t *ip_addr);
+
+// ECMP groups and LAGs
+unsigned mock_ecmp_count(void);
+unsigned mock_ecmp_members(
+        switch_handle_t ecmp_handle,
+        const switch_handle_t **members);
+unsigned mock_lag_count(void);
+unsigned mock_lag_members(
+        switch_handle_t lag_handle,
+        const switch_handle_t **members);
+
+// MAC table
+unsigned mock_mac_count(void);
+const switch_api_mac_entry_t *mock_mac_find(
+        switch_handle_t vlan_handle,
+        const uint8_t *mac);
+uint64_t mock_mac_aging_time(void);
+
+#define MOCK_CPU_NHOP_BASE      0x1000
+#define MOCK_NHOP_BASE          0x2000
+
+/*
+* Test bookkeeping: CHECK records a failure and carries on, so one run
+* reports every broken expectation.
+*/
+extern unsigned mock_failures;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            mock_failures++; \
+        } \
+    } while (0)
+
+#define CHECK_DONE() \
+    do { \
+        printf("%s: %s\n", __FILE__, mock_failures ? "FAIL" : "PASS"); \
+        return mock_failures ? 1 : 0; \
+    } while (0)
+
+#endif // _SWITCHAPI_MOCK_H
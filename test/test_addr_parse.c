@@ -0,0 +1,204 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+* RPC address parsers: valid IPv6 forms parse as inet_pton does, malformed
+* MAC, IPv4 and IPv6 strings are refused and leave the output untouched,
+* and the mask cache returns what the parser returns.
+*/
+
+#include <arpa/inet.h>
+#include "switchapi_mock.h"
+#include "switch_sai_addr.h"
+
+#define TEST_POISON     0xa5
+
+static sai_status_t parse_mac(const char *str, uint8_t *mac) {
+    return switch_sai_addr_parse_mac(str, strlen(str), mac);
+}
+
+static sai_status_t parse_ipv4(const char *str, uint32_t *ip4) {
+    return switch_sai_addr_parse_ipv4(str, strlen(str), ip4);
+}
+
+static sai_status_t parse_ipv6(const char *str, uint8_t *ip6) {
+    return switch_sai_addr_parse_ipv6(str, strlen(str), ip6);
+}
+
+static bool untouched(const uint8_t *buf, size_t len) {
+    size_t index = 0;
+
+    for (index = 0; index < len; index++) {
+        if (buf[index] != TEST_POISON) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_mac(void) {
+    static const char *bad[] = {
+        "00:11-22:33:44:55",            // mixed separators
+        "00.11.22.33.44.55",            // unknown separator
+        "00:11:22:33:44:5g",
+        "0011223344g5",
+        "00:11:22:33:44:5",
+        "00:11:22:33:44:55:",
+        "",
+    };
+    const uint8_t expected[6] = { 0x00, 0x11, 0x22, 0xaa, 0xbb, 0xff };
+    uint8_t mac[6];
+    char str[SWITCH_SAI_MAC_STR_LEN + 1];
+    size_t index = 0;
+
+    CHECK(parse_mac("00:11:22:aa:bb:ff", mac) == SAI_STATUS_SUCCESS);
+    CHECK(!memcmp(mac, expected, 6));
+    CHECK(parse_mac("00-11-22-AA-BB-FF", mac) == SAI_STATUS_SUCCESS);
+    CHECK(!memcmp(mac, expected, 6));
+    CHECK(parse_mac("001122aAbBfF", mac) == SAI_STATUS_SUCCESS);
+    CHECK(!memcmp(mac, expected, 6));
+
+    switch_sai_addr_format_mac(expected, str);
+    CHECK(!strcmp(str, "00:11:22:aa:bb:ff"));
+
+    for (index = 0; index < sizeof(bad) / sizeof(bad[0]); index++) {
+        memset(mac, TEST_POISON, sizeof(mac));
+        CHECK(parse_mac(bad[index], mac) == SAI_STATUS_INVALID_PARAMETER);
+        CHECK(untouched(mac, sizeof(mac)));
+    }
+}
+
+static void test_ipv4(void) {
+    static const char *bad[] = {
+        "256.0.0.1",                    // octet overflow
+        "1.2.3.1000",
+        "1.2.3.4.",                     // trailing dot
+        ".1.2.3.4",
+        "1.2.3",
+        "1..2.3.4",
+        "1.2.3.4.5",
+        "0001.2.3.4",
+        "1.2.3.a",
+        "1.2.3.4 ",
+    };
+    uint32_t ip4 = 0;
+    size_t index = 0;
+
+    CHECK(parse_ipv4("1.2.3.4", &ip4) == SAI_STATUS_SUCCESS);
+    CHECK(ip4 == htonl(0x01020304));
+    CHECK(parse_ipv4("255.255.255.255", &ip4) == SAI_STATUS_SUCCESS);
+    CHECK(ip4 == 0xffffffff);
+    CHECK(parse_ipv4("010.0.0.0", &ip4) == SAI_STATUS_SUCCESS);
+    CHECK(ip4 == htonl(0x0a000000));
+    // the input need not be NUL terminated
+    CHECK(switch_sai_addr_parse_ipv4("10.1.2.3456", 8, &ip4) == SAI_STATUS_SUCCESS);
+    CHECK(ip4 == htonl(0x0a010203));
+
+    for (index = 0; index < sizeof(bad) / sizeof(bad[0]); index++) {
+        memset(&ip4, TEST_POISON, sizeof(ip4));
+        CHECK(parse_ipv4(bad[index], &ip4) == SAI_STATUS_INVALID_PARAMETER);
+        CHECK(untouched((const uint8_t *) &ip4, sizeof(ip4)));
+    }
+}
+
+static void test_ipv6(void) {
+    static const char *good[] = {
+        "::",
+        "1::",
+        "::1",
+        "::ffff:1.2.3.4",
+        "1:2:3:4:5:6:1.2.3.4",
+        "2001:db8::8:800:200c:417a",
+        "2001:DB8:0:0:8:800:200C:417A",
+        "1:2:3:4:5:6:7:8",
+        "1::3:4:5:6:7:8",
+        "1:2:3:4:5:6:7::",
+        "fe80::",
+        "0:0:0:0:0:0:0:0",
+    };
+    static const char *bad[] = {
+        "1::2::3",                      // double "::"
+        "::1::",
+        ":::",
+        "12345::",                      // 5 digit group
+        "1:23456::",
+        "::00000",
+        "1:2:3:4:5:6:7:8:9",
+        "1:2:3:4:5:6:7",
+        "1:2:3:4:5:6:7:8::",
+        "1::2:3:4:5:6:7:8",
+        ":1::",
+        "1:",
+        "1:2:3:4:5:6:7:",
+        "::ffff:1.2.3",
+        "::ffff:1.2.3.4.5",
+        "::ffff:256.2.3.4",
+        "1:2:3:4:5:6:7:1.2.3.4",
+        "::1.2.3.4:1",
+        "g::",
+        ":",
+    };
+    uint8_t ip6[16];
+    uint8_t expected[16];
+    size_t index = 0;
+
+    for (index = 0; index < sizeof(good) / sizeof(good[0]); index++) {
+        memset(ip6, TEST_POISON, sizeof(ip6));
+        CHECK(inet_pton(AF_INET6, good[index], expected) == 1);
+        CHECK(parse_ipv6(good[index], ip6) == SAI_STATUS_SUCCESS);
+        CHECK(!memcmp(ip6, expected, 16));
+    }
+    for (index = 0; index < sizeof(bad) / sizeof(bad[0]); index++) {
+        memset(ip6, TEST_POISON, sizeof(ip6));
+        CHECK(inet_pton(AF_INET6, bad[index], expected) != 1);
+        CHECK(parse_ipv6(bad[index], ip6) == SAI_STATUS_INVALID_PARAMETER);
+        CHECK(untouched(ip6, sizeof(ip6)));
+    }
+}
+
+static void test_mask_cache(void) {
+    uint32_t mask4 = 0;
+    uint8_t mask6[16];
+    uint8_t expected[16];
+    int pass = 0;
+
+    // a miss fills the cache, a hit must return the same value
+    for (pass = 0; pass < 2; pass++) {
+        CHECK(switch_sai_addr_parse_ipv4_mask("255.255.255.0", 13, &mask4) == SAI_STATUS_SUCCESS);
+        CHECK(mask4 == htonl(0xffffff00));
+        CHECK(switch_sai_addr_parse_ipv6_mask("ffff:ffff::", 11, mask6) == SAI_STATUS_SUCCESS);
+        CHECK(inet_pton(AF_INET6, "ffff:ffff::", expected) == 1);
+        CHECK(!memcmp(mask6, expected, 16));
+    }
+
+    // the same string is cached per family, and errors are not cached
+    CHECK(switch_sai_addr_parse_ipv6_mask("255.255.255.0", 13, mask6) == SAI_STATUS_INVALID_PARAMETER);
+    CHECK(switch_sai_addr_parse_ipv4_mask("255.255.255.0", 13, &mask4) == SAI_STATUS_SUCCESS);
+    for (pass = 0; pass < 2; pass++) {
+        memset(&mask4, TEST_POISON, sizeof(mask4));
+        CHECK(switch_sai_addr_parse_ipv4_mask("255.255.255.", 12, &mask4) == SAI_STATUS_INVALID_PARAMETER);
+        CHECK(untouched((const uint8_t *) &mask4, sizeof(mask4)));
+    }
+}
+
+int main(void) {
+    test_mac();
+    test_ipv4();
+    test_ipv6();
+    test_mask_cache();
+
+    CHECK_DONE();
+}
@@ -0,0 +1,181 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+* FDB aging: the aging time is programmed into switchapi, and entries
+* leave the shadow when switchapi reports them aged, never on a timer of
+* their own. Static entries are not aged.
+*/
+
+#include "switchapi_mock.h"
+#include "saiinternal.h"
+
+#define TEST_VLAN_BASE          0x100
+#define TEST_VLAN_A             10
+#define TEST_PORT_1             0x11
+
+extern sai_fdb_api_t fdb_api;
+
+sai_status_t sai_vlan_id_to_handle(
+        sai_vlan_id_t vlan_id,
+        switch_handle_t *vlan_handle) {
+    *vlan_handle = TEST_VLAN_BASE + vlan_id;
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t sai_vlan_handle_to_id(
+        switch_handle_t vlan_handle,
+        sai_vlan_id_t *vlan_id) {
+    *vlan_id = (sai_vlan_id_t) (vlan_handle - TEST_VLAN_BASE);
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t sai_fdb_event_initialize(void) {
+    return SAI_STATUS_SUCCESS;
+}
+
+void sai_fdb_event_post(
+        sai_fdb_event_t event_type,
+        const switch_api_mac_entry_t *mac_entry) {
+}
+
+static void fdb_init(
+        sai_fdb_entry_t *fdb_entry,
+        sai_vlan_id_t vlan_id,
+        uint8_t mac) {
+    memset(fdb_entry, 0, sizeof(sai_fdb_entry_t));
+    fdb_entry->vlan_id = vlan_id;
+    fdb_entry->mac_address[0] = 0x02;
+    fdb_entry->mac_address[5] = mac;
+}
+
+static sai_status_t fdb_create(
+        sai_vlan_id_t vlan_id,
+        uint8_t mac,
+        sai_fdb_entry_type_t type) {
+    sai_fdb_entry_t fdb_entry;
+    sai_attribute_t attrs[2];
+
+    fdb_init(&fdb_entry, vlan_id, mac);
+    memset(attrs, 0, sizeof(attrs));
+    attrs[0].id = SAI_FDB_ENTRY_ATTR_TYPE;
+    attrs[0].value.u8 = type;
+    attrs[1].id = SAI_FDB_ENTRY_ATTR_PORT_ID;
+    attrs[1].value.oid = TEST_PORT_1;
+    return fdb_api.create_fdb_entry(&fdb_entry, 2, attrs);
+}
+
+// port of the shadow entry, 0 if there is none
+static switch_handle_t fdb_port(
+        sai_vlan_id_t vlan_id,
+        uint8_t mac) {
+    sai_fdb_entry_t fdb_entry;
+    sai_attribute_t attr;
+
+    fdb_init(&fdb_entry, vlan_id, mac);
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_FDB_ENTRY_ATTR_PORT_ID;
+    if (fdb_api.get_fdb_entry_attribute(&fdb_entry, 1, &attr) != SAI_STATUS_SUCCESS) {
+        return 0;
+    }
+    return (switch_handle_t) attr.value.oid;
+}
+
+static void fdb_learn(
+        sai_fdb_event_t event_type,
+        sai_vlan_id_t vlan_id,
+        uint8_t mac,
+        switch_handle_t port) {
+    sai_fdb_event_notification_data_t event;
+    sai_attribute_t attr;
+
+    memset(&event, 0, sizeof(event));
+    memset(&attr, 0, sizeof(attr));
+    event.event_type = event_type;
+    fdb_init(&event.fdb_entry, vlan_id, mac);
+    attr.id = SAI_FDB_ENTRY_ATTR_PORT_ID;
+    attr.value.oid = port;
+    event.attr_count = 1;
+    event.attr = &attr;
+    sai_fdb_event_apply(1, &event);
+}
+
+static void test_aging_time(void) {
+    // programmed into switchapi in msec, kept when switchapi refuses it
+    CHECK(sai_fdb_aging_time_get() == 0);
+    CHECK(sai_fdb_aging_time_set(300) == SAI_STATUS_SUCCESS);
+    CHECK(mock_mac_aging_time() == 300000);
+    CHECK(sai_fdb_aging_time_get() == 300);
+    mock_calls = 0;
+    mock_fail_at = 1;
+    CHECK(sai_fdb_aging_time_set(60) != SAI_STATUS_SUCCESS);
+    mock_fail_at = 0;
+    CHECK(mock_mac_aging_time() == 300000);
+    CHECK(sai_fdb_aging_time_get() == 300);
+    CHECK(sai_fdb_aging_time_set(0) == SAI_STATUS_SUCCESS);
+    CHECK(mock_mac_aging_time() == 0);
+    CHECK(sai_fdb_aging_time_get() == 0);
+}
+
+static void test_aged(void) {
+    sai_fdb_entry_t fdb_entry;
+    switch_api_mac_entry_t mac_entry;
+
+    // a dynamic entry stays until switchapi reports it aged, however
+    // long ago it was created or learned
+    CHECK(sai_fdb_aging_time_set(1) == SAI_STATUS_SUCCESS);
+    CHECK(fdb_create(TEST_VLAN_A, 1, SAI_FDB_ENTRY_DYNAMIC) == SAI_STATUS_SUCCESS);
+    fdb_learn(SAI_FDB_EVENT_LEARNED, TEST_VLAN_A, 2, TEST_PORT_1);
+    CHECK(fdb_port(TEST_VLAN_A, 1) == TEST_PORT_1);
+    CHECK(fdb_port(TEST_VLAN_A, 2) == TEST_PORT_1);
+
+    // switchapi removes what it ages, SAI only drops the shadow entry
+    fdb_init(&fdb_entry, TEST_VLAN_A, 1);
+    memcpy(&mac_entry, mock_mac_find(TEST_VLAN_BASE + TEST_VLAN_A, fdb_entry.mac_address),
+           sizeof(mac_entry));
+    CHECK(switch_api_mac_table_entry_delete(device, &mac_entry) == SAI_STATUS_SUCCESS);
+    mock_calls = 0;
+    fdb_learn(SAI_FDB_EVENT_AGED, TEST_VLAN_A, 1, TEST_PORT_1);
+    fdb_learn(SAI_FDB_EVENT_AGED, TEST_VLAN_A, 2, TEST_PORT_1);
+    CHECK(mock_calls == 0);
+    CHECK(fdb_port(TEST_VLAN_A, 1) == 0);
+    CHECK(fdb_port(TEST_VLAN_A, 2) == 0);
+
+    // and the MAC can be created again
+    CHECK(fdb_create(TEST_VLAN_A, 1, SAI_FDB_ENTRY_DYNAMIC) == SAI_STATUS_SUCCESS);
+    CHECK(fdb_api.remove_fdb_entry(&fdb_entry) == SAI_STATUS_SUCCESS);
+
+    // static entries are not aged
+    CHECK(fdb_create(TEST_VLAN_A, 3, SAI_FDB_ENTRY_STATIC) == SAI_STATUS_SUCCESS);
+    fdb_learn(SAI_FDB_EVENT_AGED, TEST_VLAN_A, 3, TEST_PORT_1);
+    CHECK(fdb_port(TEST_VLAN_A, 3) == TEST_PORT_1);
+    fdb_init(&fdb_entry, TEST_VLAN_A, 3);
+    CHECK(fdb_api.remove_fdb_entry(&fdb_entry) == SAI_STATUS_SUCCESS);
+    CHECK(mock_mac_count() == 0);
+    CHECK(sai_fdb_aging_time_set(0) == SAI_STATUS_SUCCESS);
+}
+
+int main(void) {
+    sai_api_service_t service;
+
+    sai_fdb_initialize(&service);
+    mock_reset();
+
+    test_aging_time();
+    test_aged();
+
+    CHECK_DONE();
+}
@@ -0,0 +1,200 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+* FDB entry attributes: get is answered from the shadow without calling
+* switchapi, and a set of port, type or action is a single in place
+* update that leaves the shadow untouched when it fails.
+*/
+
+#include "switchapi_mock.h"
+#include "saiinternal.h"
+
+#define TEST_VLAN_BASE          0x100
+#define TEST_VLAN_A             10
+#define TEST_PORT_1             0x11
+#define TEST_PORT_2             0x12
+
+extern sai_fdb_api_t fdb_api;
+
+sai_status_t sai_vlan_id_to_handle(
+        sai_vlan_id_t vlan_id,
+        switch_handle_t *vlan_handle) {
+    *vlan_handle = TEST_VLAN_BASE + vlan_id;
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t sai_vlan_handle_to_id(
+        switch_handle_t vlan_handle,
+        sai_vlan_id_t *vlan_id) {
+    *vlan_id = (sai_vlan_id_t) (vlan_handle - TEST_VLAN_BASE);
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t sai_fdb_event_initialize(void) {
+    return SAI_STATUS_SUCCESS;
+}
+
+void sai_fdb_event_post(
+        sai_fdb_event_t event_type,
+        const switch_api_mac_entry_t *mac_entry) {
+}
+
+static void fdb_init(
+        sai_fdb_entry_t *fdb_entry,
+        sai_vlan_id_t vlan_id,
+        uint8_t mac) {
+    memset(fdb_entry, 0, sizeof(sai_fdb_entry_t));
+    fdb_entry->vlan_id = vlan_id;
+    fdb_entry->mac_address[0] = 0x02;
+    fdb_entry->mac_address[5] = mac;
+}
+
+// port of the shadow entry, 0 if there is none
+static switch_handle_t fdb_port(
+        sai_vlan_id_t vlan_id,
+        uint8_t mac) {
+    sai_fdb_entry_t fdb_entry;
+    sai_attribute_t attr;
+
+    fdb_init(&fdb_entry, vlan_id, mac);
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_FDB_ENTRY_ATTR_PORT_ID;
+    if (fdb_api.get_fdb_entry_attribute(&fdb_entry, 1, &attr) != SAI_STATUS_SUCCESS) {
+        return 0;
+    }
+    return (switch_handle_t) attr.value.oid;
+}
+
+static sai_status_t fdb_create(
+        const sai_fdb_entry_t *fdb_entry) {
+    sai_attribute_t attrs[3];
+
+    memset(attrs, 0, sizeof(attrs));
+    attrs[0].id = SAI_FDB_ENTRY_ATTR_TYPE;
+    attrs[0].value.u8 = SAI_FDB_ENTRY_DYNAMIC;
+    attrs[1].id = SAI_FDB_ENTRY_ATTR_PORT_ID;
+    attrs[1].value.oid = TEST_PORT_1;
+    attrs[2].id = SAI_FDB_ENTRY_ATTR_PACKET_ACTION;
+    attrs[2].value.u8 = SAI_PACKET_ACTION_FORWARD;
+    return fdb_api.create_fdb_entry(fdb_entry, 3, attrs);
+}
+
+static sai_status_t fdb_set(
+        const sai_fdb_entry_t *fdb_entry,
+        sai_fdb_entry_attr_t id,
+        sai_object_id_t value) {
+    sai_attribute_t attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.id = id;
+    if (id == SAI_FDB_ENTRY_ATTR_PORT_ID) {
+        attr.value.oid = value;
+    } else {
+        attr.value.u8 = (uint8_t) value;
+    }
+    return fdb_api.set_fdb_entry_attribute(fdb_entry, &attr);
+}
+
+static const switch_api_mac_entry_t *fdb_programmed(
+        const sai_fdb_entry_t *fdb_entry) {
+    return mock_mac_find(TEST_VLAN_BASE + fdb_entry->vlan_id, fdb_entry->mac_address);
+}
+
+static void test_get(void) {
+    sai_fdb_entry_t fdb_entry;
+    sai_attribute_t attrs[3];
+
+    // answered from the shadow, switchapi is not asked
+    fdb_init(&fdb_entry, TEST_VLAN_A, 1);
+    CHECK(fdb_create(&fdb_entry) == SAI_STATUS_SUCCESS);
+    memset(attrs, 0, sizeof(attrs));
+    attrs[0].id = SAI_FDB_ENTRY_ATTR_TYPE;
+    attrs[1].id = SAI_FDB_ENTRY_ATTR_PORT_ID;
+    attrs[2].id = SAI_FDB_ENTRY_ATTR_PACKET_ACTION;
+    mock_calls = 0;
+    CHECK(fdb_api.get_fdb_entry_attribute(&fdb_entry, 3, attrs) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 0);
+    CHECK(attrs[0].value.u8 == SAI_FDB_ENTRY_DYNAMIC);
+    CHECK(attrs[1].value.oid == TEST_PORT_1);
+    CHECK(attrs[2].value.u8 == SAI_PACKET_ACTION_FORWARD);
+
+    attrs[0].id = SAI_FDB_ENTRY_ATTR_CUSTOM_RANGE_BASE;
+    CHECK(fdb_api.get_fdb_entry_attribute(&fdb_entry, 1, attrs) == SAI_STATUS_NOT_SUPPORTED);
+    CHECK(fdb_api.get_fdb_entry_attribute(&fdb_entry, 1, NULL) == SAI_STATUS_INVALID_PARAMETER);
+
+    fdb_init(&fdb_entry, TEST_VLAN_A, 2);
+    CHECK(fdb_api.get_fdb_entry_attribute(&fdb_entry, 3, attrs) == SAI_STATUS_ITEM_NOT_FOUND);
+}
+
+static void test_set(void) {
+    sai_fdb_entry_t fdb_entry;
+    sai_attribute_t attr;
+
+    // each set is one in place update
+    fdb_init(&fdb_entry, TEST_VLAN_A, 1);
+    mock_calls = 0;
+    CHECK(fdb_set(&fdb_entry, SAI_FDB_ENTRY_ATTR_PORT_ID, TEST_PORT_2) == SAI_STATUS_SUCCESS);
+    CHECK(fdb_set(&fdb_entry, SAI_FDB_ENTRY_ATTR_TYPE, SAI_FDB_ENTRY_STATIC) == SAI_STATUS_SUCCESS);
+    CHECK(fdb_set(&fdb_entry, SAI_FDB_ENTRY_ATTR_PACKET_ACTION, SAI_PACKET_ACTION_DROP) ==
+          SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 3);
+    CHECK(mock_mac_count() == 1);
+    CHECK(fdb_programmed(&fdb_entry)->handle == TEST_PORT_2);
+    CHECK(fdb_programmed(&fdb_entry)->entry_type == SWITCH_MAC_ENTRY_STATIC);
+    CHECK(fdb_programmed(&fdb_entry)->mac_action == SWITCH_MAC_ACTION_DROP);
+    CHECK(fdb_port(TEST_VLAN_A, 1) == TEST_PORT_2);
+
+    // a failed update leaves the shadow as it was
+    mock_calls = 0;
+    mock_fail_at = 1;
+    CHECK(fdb_set(&fdb_entry, SAI_FDB_ENTRY_ATTR_PACKET_ACTION, SAI_PACKET_ACTION_FORWARD) !=
+          SAI_STATUS_SUCCESS);
+    mock_fail_at = 0;
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_FDB_ENTRY_ATTR_PACKET_ACTION;
+    CHECK(fdb_api.get_fdb_entry_attribute(&fdb_entry, 1, &attr) == SAI_STATUS_SUCCESS);
+    CHECK(attr.value.u8 == SAI_PACKET_ACTION_DROP);
+
+    // invalid values are refused before the lookup
+    mock_calls = 0;
+    CHECK(fdb_set(&fdb_entry, SAI_FDB_ENTRY_ATTR_TYPE, 7) == SAI_STATUS_INVALID_PARAMETER);
+    CHECK(fdb_set(&fdb_entry, SAI_FDB_ENTRY_ATTR_PACKET_ACTION, SAI_PACKET_ACTION_TRAP) ==
+          SAI_STATUS_INVALID_PARAMETER);
+    CHECK(fdb_set(&fdb_entry, SAI_FDB_ENTRY_ATTR_CUSTOM_RANGE_BASE, 0) == SAI_STATUS_NOT_SUPPORTED);
+    CHECK(fdb_api.set_fdb_entry_attribute(&fdb_entry, NULL) == SAI_STATUS_INVALID_PARAMETER);
+    CHECK(mock_calls == 0);
+
+    fdb_init(&fdb_entry, TEST_VLAN_A, 2);
+    CHECK(fdb_set(&fdb_entry, SAI_FDB_ENTRY_ATTR_PORT_ID, TEST_PORT_1) == SAI_STATUS_ITEM_NOT_FOUND);
+    CHECK(mock_calls == 0);
+
+    fdb_init(&fdb_entry, TEST_VLAN_A, 1);
+    CHECK(fdb_api.remove_fdb_entry(&fdb_entry) == SAI_STATUS_SUCCESS);
+    CHECK(mock_mac_count() == 0);
+}
+
+int main(void) {
+    sai_api_service_t service;
+
+    sai_fdb_initialize(&service);
+    mock_reset();
+
+    test_get();
+    test_set();
+
+    CHECK_DONE();
+}
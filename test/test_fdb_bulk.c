@@ -0,0 +1,215 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+* Bulk FDB create and remove: each VLAN is resolved once per request,
+* entries of a VLAN are applied in request order, and every entry gets
+* its own status, so one bad entry or VLAN fails nothing else.
+*/
+
+#include "switchapi_mock.h"
+#include "saiinternal.h"
+
+#define TEST_VLAN_BASE          0x100
+#define TEST_VLAN_A             10
+#define TEST_VLAN_B             20
+#define TEST_VLAN_MISSING       30
+#define TEST_PORT_1             0x11
+#define TEST_PORT_2             0x12
+#define TEST_ENTRIES            8
+
+extern sai_fdb_api_t fdb_api;
+
+static unsigned vlan_lookups;
+
+sai_status_t sai_vlan_id_to_handle(
+        sai_vlan_id_t vlan_id,
+        switch_handle_t *vlan_handle) {
+    vlan_lookups++;
+    if (vlan_id == TEST_VLAN_MISSING) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+    *vlan_handle = TEST_VLAN_BASE + vlan_id;
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t sai_vlan_handle_to_id(
+        switch_handle_t vlan_handle,
+        sai_vlan_id_t *vlan_id) {
+    *vlan_id = (sai_vlan_id_t) (vlan_handle - TEST_VLAN_BASE);
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t sai_fdb_event_initialize(void) {
+    return SAI_STATUS_SUCCESS;
+}
+
+void sai_fdb_event_post(
+        sai_fdb_event_t event_type,
+        const switch_api_mac_entry_t *mac_entry) {
+}
+
+static void fdb_init(
+        sai_fdb_entry_t *fdb_entry,
+        sai_vlan_id_t vlan_id,
+        uint8_t mac) {
+    memset(fdb_entry, 0, sizeof(sai_fdb_entry_t));
+    fdb_entry->vlan_id = vlan_id;
+    fdb_entry->mac_address[0] = 0x02;
+    fdb_entry->mac_address[5] = mac;
+}
+
+// port of the shadow entry, 0 if there is none
+static switch_handle_t fdb_port(
+        const sai_fdb_entry_t *fdb_entry) {
+    sai_attribute_t attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_FDB_ENTRY_ATTR_PORT_ID;
+    if (fdb_api.get_fdb_entry_attribute(fdb_entry, 1, &attr) != SAI_STATUS_SUCCESS) {
+        return 0;
+    }
+    return (switch_handle_t) attr.value.oid;
+}
+
+/*
+* VLANs A and B interleaved, MAC 1 twice on VLAN A with different ports,
+* one entry on a VLAN that does not exist and one without attributes.
+*/
+static sai_fdb_entry_t fdb_entries[TEST_ENTRIES];
+static sai_attribute_t fdb_attrs[TEST_ENTRIES][2];
+static const sai_attribute_t *fdb_attr_lists[TEST_ENTRIES];
+static uint32_t fdb_attr_counts[TEST_ENTRIES];
+
+static void fdb_request_init(void) {
+    static const sai_vlan_id_t vlans[TEST_ENTRIES] = {
+        TEST_VLAN_A, TEST_VLAN_B, TEST_VLAN_A, TEST_VLAN_MISSING,
+        TEST_VLAN_B, TEST_VLAN_A, TEST_VLAN_A, TEST_VLAN_B };
+    static const uint8_t macs[TEST_ENTRIES] = { 1, 1, 2, 1, 2, 1, 3, 3 };
+    uint32_t index = 0;
+
+    memset(fdb_attrs, 0, sizeof(fdb_attrs));
+    for (index = 0; index < TEST_ENTRIES; index++) {
+        fdb_init(&fdb_entries[index], vlans[index], macs[index]);
+        fdb_attrs[index][0].id = SAI_FDB_ENTRY_ATTR_TYPE;
+        fdb_attrs[index][0].value.u8 = SAI_FDB_ENTRY_STATIC;
+        fdb_attrs[index][1].id = SAI_FDB_ENTRY_ATTR_PORT_ID;
+        fdb_attrs[index][1].value.oid = (index < 4) ? TEST_PORT_1 : TEST_PORT_2;
+        fdb_attr_lists[index] = fdb_attrs[index];
+        fdb_attr_counts[index] = 2;
+    }
+    fdb_attr_lists[7] = NULL;
+}
+
+static void test_bulk_create(void) {
+    sai_status_t statuses[TEST_ENTRIES];
+    uint32_t index = 0;
+
+    fdb_request_init();
+    vlan_lookups = 0;
+    mock_calls = 0;
+    CHECK(sai_bulk_create_fdb_entry(TEST_ENTRIES, fdb_entries, fdb_attr_counts,
+                                    fdb_attr_lists, statuses) == SAI_STATUS_FAILURE);
+    CHECK(vlan_lookups == 3);
+    for (index = 0; index < TEST_ENTRIES; index++) {
+        if (index == 3 || index == 7) {
+            CHECK(statuses[index] == SAI_STATUS_INVALID_PARAMETER);
+            CHECK(fdb_port(&fdb_entries[index]) == 0);
+        } else {
+            CHECK(statuses[index] == SAI_STATUS_SUCCESS);
+        }
+    }
+
+    // the later request for MAC 1 on VLAN A wins, it updates the entry
+    CHECK(mock_calls == 6);
+    CHECK(mock_mac_count() == 5);
+    CHECK(fdb_port(&fdb_entries[0]) == TEST_PORT_2);
+    CHECK(mock_mac_find(TEST_VLAN_BASE + TEST_VLAN_A, fdb_entries[0].mac_address)->handle ==
+          TEST_PORT_2);
+    CHECK(fdb_port(&fdb_entries[1]) == TEST_PORT_1);
+    CHECK(fdb_port(&fdb_entries[6]) == TEST_PORT_2);
+}
+
+static void test_bulk_failure(void) {
+    sai_fdb_entry_t fdb_entry[3];
+    sai_status_t statuses[3];
+    uint32_t index = 0;
+
+    // the second switchapi call fails, the entries around it go through
+    fdb_request_init();
+    for (index = 0; index < 3; index++) {
+        fdb_init(&fdb_entry[index], TEST_VLAN_B, 10 + index);
+    }
+    mock_calls = 0;
+    mock_fail_at = 2;
+    CHECK(sai_bulk_create_fdb_entry(3, fdb_entry, fdb_attr_counts,
+                                    fdb_attr_lists, statuses) == SAI_STATUS_FAILURE);
+    mock_fail_at = 0;
+    CHECK(statuses[0] == SAI_STATUS_SUCCESS);
+    CHECK(statuses[1] != SAI_STATUS_SUCCESS);
+    CHECK(statuses[2] == SAI_STATUS_SUCCESS);
+    CHECK(fdb_port(&fdb_entry[0]) == TEST_PORT_1);
+    CHECK(fdb_port(&fdb_entry[1]) == 0);
+    CHECK(fdb_port(&fdb_entry[2]) == TEST_PORT_1);
+    CHECK(mock_mac_count() == 7);
+
+    CHECK(sai_bulk_remove_fdb_entry(3, fdb_entry, statuses) == SAI_STATUS_FAILURE);
+    CHECK(statuses[0] == SAI_STATUS_SUCCESS);
+    CHECK(statuses[1] != SAI_STATUS_SUCCESS);
+    CHECK(statuses[2] == SAI_STATUS_SUCCESS);
+    CHECK(mock_mac_count() == 5);
+}
+
+static void test_bulk_remove(void) {
+    sai_status_t statuses[TEST_ENTRIES];
+    uint32_t index = 0;
+
+    // MAC 1 on VLAN A is listed twice, only its first remove finds it,
+    // and the entry without attributes was never created
+    vlan_lookups = 0;
+    CHECK(sai_bulk_remove_fdb_entry(TEST_ENTRIES, fdb_entries, statuses) == SAI_STATUS_FAILURE);
+    CHECK(vlan_lookups == 3);
+    for (index = 0; index < TEST_ENTRIES; index++) {
+        if (index == 3) {
+            CHECK(statuses[index] == SAI_STATUS_INVALID_PARAMETER);
+        } else if (index == 5 || index == 7) {
+            CHECK(statuses[index] != SAI_STATUS_SUCCESS);
+        } else {
+            CHECK(statuses[index] == SAI_STATUS_SUCCESS);
+        }
+        CHECK(fdb_port(&fdb_entries[index]) == 0);
+    }
+    CHECK(mock_mac_count() == 0);
+
+    // empty requests and missing arrays
+    CHECK(sai_bulk_remove_fdb_entry(0, fdb_entries, statuses) == SAI_STATUS_SUCCESS);
+    CHECK(sai_bulk_remove_fdb_entry(1, NULL, statuses) == SAI_STATUS_INVALID_PARAMETER);
+    CHECK(sai_bulk_create_fdb_entry(1, fdb_entries, NULL, fdb_attr_lists, statuses) ==
+          SAI_STATUS_INVALID_PARAMETER);
+}
+
+int main(void) {
+    sai_api_service_t service;
+
+    sai_fdb_initialize(&service);
+    mock_reset();
+
+    test_bulk_create();
+    test_bulk_failure();
+    test_bulk_remove();
+
+    CHECK_DONE();
+}
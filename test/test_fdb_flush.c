@@ -0,0 +1,319 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+* FDB flush: a flush by port, VLAN, port and VLAN, or entry type removes
+* exactly the matching entries from switchapi and the shadow, and an
+* entry whose create, move or learn fails is in neither the shadow nor
+* its port index.
+*/
+
+#include "switchapi_mock.h"
+#include "saiinternal.h"
+
+#define TEST_VLAN_BASE          0x100
+#define TEST_VLAN_A             10
+#define TEST_VLAN_B             20
+#define TEST_PORT_1             0x11
+#define TEST_PORT_2             0x12
+#define TEST_PORT_3             0x13
+
+extern sai_fdb_api_t fdb_api;
+
+sai_status_t sai_vlan_id_to_handle(
+        sai_vlan_id_t vlan_id,
+        switch_handle_t *vlan_handle) {
+    *vlan_handle = TEST_VLAN_BASE + vlan_id;
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t sai_vlan_handle_to_id(
+        switch_handle_t vlan_handle,
+        sai_vlan_id_t *vlan_id) {
+    *vlan_id = (sai_vlan_id_t) (vlan_handle - TEST_VLAN_BASE);
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t sai_fdb_event_initialize(void) {
+    return SAI_STATUS_SUCCESS;
+}
+
+void sai_fdb_event_post(
+        sai_fdb_event_t event_type,
+        const switch_api_mac_entry_t *mac_entry) {
+}
+
+static void fdb_init(
+        sai_fdb_entry_t *fdb_entry,
+        sai_vlan_id_t vlan_id,
+        uint8_t mac) {
+    memset(fdb_entry, 0, sizeof(sai_fdb_entry_t));
+    fdb_entry->vlan_id = vlan_id;
+    fdb_entry->mac_address[0] = 0x02;
+    fdb_entry->mac_address[5] = mac;
+}
+
+static sai_status_t fdb_create(
+        sai_vlan_id_t vlan_id,
+        uint8_t mac,
+        switch_handle_t port,
+        sai_fdb_entry_type_t type) {
+    sai_fdb_entry_t fdb_entry;
+    sai_attribute_t attrs[3];
+
+    fdb_init(&fdb_entry, vlan_id, mac);
+    memset(attrs, 0, sizeof(attrs));
+    attrs[0].id = SAI_FDB_ENTRY_ATTR_TYPE;
+    attrs[0].value.u8 = type;
+    attrs[1].id = SAI_FDB_ENTRY_ATTR_PORT_ID;
+    attrs[1].value.oid = port;
+    attrs[2].id = SAI_FDB_ENTRY_ATTR_PACKET_ACTION;
+    attrs[2].value.u8 = SAI_PACKET_ACTION_FORWARD;
+    return fdb_api.create_fdb_entry(&fdb_entry, 3, attrs);
+}
+
+// port of the shadow entry, 0 if there is none
+static switch_handle_t fdb_port(
+        sai_vlan_id_t vlan_id,
+        uint8_t mac) {
+    sai_fdb_entry_t fdb_entry;
+    sai_attribute_t attr;
+
+    fdb_init(&fdb_entry, vlan_id, mac);
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_FDB_ENTRY_ATTR_PORT_ID;
+    if (fdb_api.get_fdb_entry_attribute(&fdb_entry, 1, &attr) != SAI_STATUS_SUCCESS) {
+        return 0;
+    }
+    return (switch_handle_t) attr.value.oid;
+}
+
+static bool fdb_programmed(
+        sai_vlan_id_t vlan_id,
+        uint8_t mac) {
+    sai_fdb_entry_t fdb_entry;
+
+    fdb_init(&fdb_entry, vlan_id, mac);
+    return mock_mac_find(TEST_VLAN_BASE + vlan_id, fdb_entry.mac_address) != NULL;
+}
+
+static sai_status_t fdb_flush(
+        bool port_valid,
+        switch_handle_t port,
+        bool vlan_valid,
+        sai_vlan_id_t vlan_id,
+        bool type_valid,
+        sai_fdb_flush_entry_type_t type) {
+    sai_attribute_t attrs[3];
+    uint32_t count = 0;
+
+    memset(attrs, 0, sizeof(attrs));
+    if (port_valid) {
+        attrs[count].id = SAI_FDB_FLUSH_ATTR_PORT_ID;
+        attrs[count++].value.oid = port;
+    }
+    if (vlan_valid) {
+        attrs[count].id = SAI_FDB_FLUSH_ATTR_VLAN_ID;
+        attrs[count++].value.u16 = vlan_id;
+    }
+    if (type_valid) {
+        attrs[count].id = SAI_FDB_FLUSH_ATTR_ENTRY_TYPE;
+        attrs[count++].value.u8 = type;
+    }
+    return fdb_api.flush_fdb_entries(count, attrs);
+}
+
+static void fdb_learn(
+        sai_fdb_event_t event_type,
+        sai_vlan_id_t vlan_id,
+        uint8_t mac,
+        switch_handle_t port) {
+    sai_fdb_event_notification_data_t event;
+    sai_attribute_t attr;
+
+    memset(&event, 0, sizeof(event));
+    memset(&attr, 0, sizeof(attr));
+    event.event_type = event_type;
+    fdb_init(&event.fdb_entry, vlan_id, mac);
+    attr.id = SAI_FDB_ENTRY_ATTR_PORT_ID;
+    attr.value.oid = port;
+    event.attr_count = 1;
+    event.attr = &attr;
+    sai_fdb_event_apply(1, &event);
+}
+
+/*
+* Entry n is on VLAN A if n is odd, port 1 or 2 by n % 4 < 2, and
+* static for n >= 8.
+*/
+static void fdb_populate(void) {
+    uint8_t mac = 0;
+
+    for (mac = 0; mac < 16; mac++) {
+        CHECK(fdb_create((mac & 1) ? TEST_VLAN_A : TEST_VLAN_B, mac,
+                         (mac % 4 < 2) ? TEST_PORT_1 : TEST_PORT_2,
+                         (mac >= 8) ? SAI_FDB_ENTRY_STATIC : SAI_FDB_ENTRY_DYNAMIC) ==
+              SAI_STATUS_SUCCESS);
+    }
+    CHECK(mock_mac_count() == 16);
+}
+
+// every entry is in the shadow and switchapi exactly when keep says so
+static void fdb_expect(bool (*keep)(uint8_t mac)) {
+    sai_vlan_id_t vlan_id = 0;
+    uint8_t mac = 0;
+    unsigned count = 0;
+
+    for (mac = 0; mac < 16; mac++) {
+        vlan_id = (mac & 1) ? TEST_VLAN_A : TEST_VLAN_B;
+        CHECK((fdb_port(vlan_id, mac) != 0) == keep(mac));
+        CHECK(fdb_programmed(vlan_id, mac) == keep(mac));
+        count += keep(mac);
+    }
+    CHECK(mock_mac_count() == count);
+    CHECK(fdb_flush(false, 0, false, 0, false, 0) == SAI_STATUS_SUCCESS);
+    CHECK(mock_mac_count() == 0);
+}
+
+static bool keep_not_port_1(uint8_t mac) {
+    return mac % 4 >= 2;
+}
+
+static bool keep_not_vlan_a(uint8_t mac) {
+    return !(mac & 1);
+}
+
+static bool keep_not_port_1_vlan_a(uint8_t mac) {
+    return mac % 4 >= 2 || !(mac & 1);
+}
+
+static bool keep_static(uint8_t mac) {
+    return mac >= 8;
+}
+
+static bool keep_not_static_port_2_vlan_b(uint8_t mac) {
+    return mac < 8 || mac % 4 < 2 || (mac & 1);
+}
+
+static void test_flush(void) {
+    fdb_populate();
+    CHECK(fdb_flush(true, TEST_PORT_1, false, 0, false, 0) == SAI_STATUS_SUCCESS);
+    fdb_expect(keep_not_port_1);
+
+    fdb_populate();
+    CHECK(fdb_flush(false, 0, true, TEST_VLAN_A, false, 0) == SAI_STATUS_SUCCESS);
+    fdb_expect(keep_not_vlan_a);
+
+    fdb_populate();
+    CHECK(fdb_flush(true, TEST_PORT_1, true, TEST_VLAN_A, false, 0) == SAI_STATUS_SUCCESS);
+    fdb_expect(keep_not_port_1_vlan_a);
+
+    // by type the entries are deleted one by one
+    fdb_populate();
+    mock_calls = 0;
+    CHECK(fdb_flush(false, 0, false, 0, true, SAI_FDB_FLUSH_ENTRY_DYNAMIC) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 8);
+    fdb_expect(keep_static);
+
+    fdb_populate();
+    CHECK(fdb_flush(true, TEST_PORT_2, true, TEST_VLAN_B, true, SAI_FDB_FLUSH_ENTRY_STATIC) ==
+          SAI_STATUS_SUCCESS);
+    fdb_expect(keep_not_static_port_2_vlan_b);
+
+    // nothing on the port
+    fdb_populate();
+    mock_calls = 0;
+    CHECK(fdb_flush(true, TEST_PORT_3, false, 0, true, SAI_FDB_FLUSH_ENTRY_DYNAMIC) ==
+          SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 0);
+    CHECK(fdb_flush(false, 0, false, 0, false, 0) == SAI_STATUS_SUCCESS);
+}
+
+static void test_unwind(void) {
+    sai_fdb_entry_t fdb_entry;
+    sai_attribute_t attr;
+
+    // a failed create leaves no shadow entry and no port list behind, so
+    // a flush by that port finds nothing to delete
+    mock_calls = 0;
+    mock_fail_at = 1;
+    CHECK(fdb_create(TEST_VLAN_A, 1, TEST_PORT_3, SAI_FDB_ENTRY_DYNAMIC) != SAI_STATUS_SUCCESS);
+    mock_fail_at = 0;
+    CHECK(fdb_port(TEST_VLAN_A, 1) == 0);
+    CHECK(mock_mac_count() == 0);
+    mock_calls = 0;
+    CHECK(fdb_flush(true, TEST_PORT_3, false, 0, true, SAI_FDB_FLUSH_ENTRY_DYNAMIC) ==
+          SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 0);
+
+    // a failed move keeps the entry on its port
+    CHECK(fdb_create(TEST_VLAN_A, 1, TEST_PORT_1, SAI_FDB_ENTRY_DYNAMIC) == SAI_STATUS_SUCCESS);
+    fdb_init(&fdb_entry, TEST_VLAN_A, 1);
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_FDB_ENTRY_ATTR_PORT_ID;
+    attr.value.oid = TEST_PORT_3;
+    mock_calls = 0;
+    mock_fail_at = 1;
+    CHECK(fdb_api.set_fdb_entry_attribute(&fdb_entry, &attr) != SAI_STATUS_SUCCESS);
+    mock_fail_at = 0;
+    CHECK(fdb_port(TEST_VLAN_A, 1) == TEST_PORT_1);
+    CHECK(mock_mac_find(TEST_VLAN_BASE + TEST_VLAN_A, fdb_entry.mac_address)->handle == TEST_PORT_1);
+    mock_calls = 0;
+    CHECK(fdb_flush(true, TEST_PORT_3, false, 0, true, SAI_FDB_FLUSH_ENTRY_DYNAMIC) ==
+          SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 0);
+    CHECK(fdb_flush(true, TEST_PORT_1, false, 0, true, SAI_FDB_FLUSH_ENTRY_DYNAMIC) ==
+          SAI_STATUS_SUCCESS);
+    CHECK(mock_mac_count() == 0);
+    CHECK(fdb_port(TEST_VLAN_A, 1) == 0);
+}
+
+static void test_learn(void) {
+    // learned and moved entries follow the data plane port
+    fdb_learn(SAI_FDB_EVENT_LEARNED, TEST_VLAN_A, 1, TEST_PORT_1);
+    CHECK(fdb_port(TEST_VLAN_A, 1) == TEST_PORT_1);
+    fdb_learn(SAI_FDB_EVENT_LEARNED, TEST_VLAN_A, 1, TEST_PORT_2);
+    CHECK(fdb_port(TEST_VLAN_A, 1) == TEST_PORT_2);
+    CHECK(mock_mac_count() == 0);
+    CHECK(fdb_flush(true, TEST_PORT_1, false, 0, false, 0) == SAI_STATUS_SUCCESS);
+    CHECK(fdb_port(TEST_VLAN_A, 1) == TEST_PORT_2);
+    CHECK(fdb_flush(true, TEST_PORT_2, false, 0, false, 0) == SAI_STATUS_SUCCESS);
+    CHECK(fdb_port(TEST_VLAN_A, 1) == 0);
+
+    // an aged entry leaves the shadow, a static one is never touched
+    fdb_learn(SAI_FDB_EVENT_LEARNED, TEST_VLAN_A, 2, TEST_PORT_1);
+    fdb_learn(SAI_FDB_EVENT_AGED, TEST_VLAN_A, 2, TEST_PORT_1);
+    CHECK(fdb_port(TEST_VLAN_A, 2) == 0);
+    CHECK(fdb_create(TEST_VLAN_A, 3, TEST_PORT_1, SAI_FDB_ENTRY_STATIC) == SAI_STATUS_SUCCESS);
+    fdb_learn(SAI_FDB_EVENT_LEARNED, TEST_VLAN_A, 3, TEST_PORT_2);
+    fdb_learn(SAI_FDB_EVENT_AGED, TEST_VLAN_A, 3, TEST_PORT_2);
+    CHECK(fdb_port(TEST_VLAN_A, 3) == TEST_PORT_1);
+    CHECK(fdb_flush(false, 0, false, 0, false, 0) == SAI_STATUS_SUCCESS);
+    CHECK(fdb_port(TEST_VLAN_A, 3) == 0);
+}
+
+int main(void) {
+    sai_api_service_t service;
+
+    sai_fdb_initialize(&service);
+    mock_reset();
+
+    test_flush();
+    test_unwind();
+    test_learn();
+
+    CHECK_DONE();
+}
@@ -0,0 +1,297 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+* FDB dump: pages come back in (VLAN, MAC) order whatever order entries
+* were created in, a dump by port, VLAN, port and VLAN, or type returns
+* exactly the matching entries once, more is only set when another
+* entry matches, and the cursor survives changes between pages.
+*/
+
+#include "switchapi_mock.h"
+#include "saiinternal.h"
+
+#define TEST_VLAN_BASE          0x100
+#define TEST_VLANS              5
+#define TEST_PORT_BASE          0x11
+#define TEST_PORTS              3
+#define TEST_ENTRIES            600
+#define TEST_PAGE_SIZE          7
+#define TEST_PAGE_MAX           64
+
+extern sai_fdb_api_t fdb_api;
+
+sai_status_t sai_vlan_id_to_handle(
+        sai_vlan_id_t vlan_id,
+        switch_handle_t *vlan_handle) {
+    *vlan_handle = TEST_VLAN_BASE + vlan_id;
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t sai_vlan_handle_to_id(
+        switch_handle_t vlan_handle,
+        sai_vlan_id_t *vlan_id) {
+    *vlan_id = (sai_vlan_id_t) (vlan_handle - TEST_VLAN_BASE);
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t sai_fdb_event_initialize(void) {
+    return SAI_STATUS_SUCCESS;
+}
+
+void sai_fdb_event_post(
+        sai_fdb_event_t event_type,
+        const switch_api_mac_entry_t *mac_entry) {
+}
+
+/*
+* What the table should hold, sorted on (VLAN, MAC) after creation.
+*/
+static sai_fdb_entry_info_t model[TEST_ENTRIES];
+
+static int model_order(const void *a, const void *b) {
+    const sai_fdb_entry_info_t *info1 = (const sai_fdb_entry_info_t *) a;
+    const sai_fdb_entry_info_t *info2 = (const sai_fdb_entry_info_t *) b;
+    if (info1->fdb_entry.vlan_id != info2->fdb_entry.vlan_id) {
+        return (info1->fdb_entry.vlan_id < info2->fdb_entry.vlan_id) ? -1 : 1;
+    }
+    return memcmp(info1->fdb_entry.mac_address, info2->fdb_entry.mac_address, sizeof(sai_mac_t));
+}
+
+static sai_status_t fdb_create(
+        const sai_fdb_entry_info_t *info) {
+    sai_attribute_t attrs[3];
+
+    memset(attrs, 0, sizeof(attrs));
+    attrs[0].id = SAI_FDB_ENTRY_ATTR_TYPE;
+    attrs[0].value.u8 = info->type;
+    attrs[1].id = SAI_FDB_ENTRY_ATTR_PORT_ID;
+    attrs[1].value.oid = info->port_id;
+    attrs[2].id = SAI_FDB_ENTRY_ATTR_PACKET_ACTION;
+    attrs[2].value.u8 = info->packet_action;
+    return fdb_api.create_fdb_entry(&info->fdb_entry, 3, attrs);
+}
+
+// MACs are created out of order: i * an odd constant is a permutation
+static void model_populate(void) {
+    sai_fdb_entry_info_t *info = NULL;
+    uint16_t mac = 0;
+    uint32_t index = 0;
+
+    memset(model, 0, sizeof(model));
+    for (index = 0; index < TEST_ENTRIES; index++) {
+        info = &model[index];
+        mac = (uint16_t) (index * 40503u);
+        info->fdb_entry.vlan_id = 1 + (index * 7) % TEST_VLANS;
+        info->fdb_entry.mac_address[0] = 0x02;
+        info->fdb_entry.mac_address[4] = mac >> 8;
+        info->fdb_entry.mac_address[5] = mac & 0xFF;
+        info->type = (index % 4) ? SAI_FDB_ENTRY_DYNAMIC : SAI_FDB_ENTRY_STATIC;
+        info->port_id = TEST_PORT_BASE + (index * 5) % TEST_PORTS;
+        info->packet_action = (index % 9) ? SAI_PACKET_ACTION_FORWARD : SAI_PACKET_ACTION_DROP;
+        CHECK(fdb_create(info) == SAI_STATUS_SUCCESS);
+    }
+    qsort(model, TEST_ENTRIES, sizeof(sai_fdb_entry_info_t), model_order);
+}
+
+typedef struct _test_filter_t {
+    sai_object_id_t port_id;            // 0 any
+    sai_vlan_id_t vlan_id;              // 0 any
+    bool type_valid;
+    sai_fdb_entry_type_t type;
+} test_filter_t;
+
+static uint32_t filter_attrs(
+        const test_filter_t *filter,
+        sai_attribute_t *attrs) {
+    uint32_t count = 0;
+
+    memset(attrs, 0, sizeof(sai_attribute_t) * 3);
+    if (filter->port_id) {
+        attrs[count].id = SAI_FDB_FLUSH_ATTR_PORT_ID;
+        attrs[count++].value.oid = filter->port_id;
+    }
+    if (filter->vlan_id) {
+        attrs[count].id = SAI_FDB_FLUSH_ATTR_VLAN_ID;
+        attrs[count++].value.u16 = filter->vlan_id;
+    }
+    if (filter->type_valid) {
+        attrs[count].id = SAI_FDB_FLUSH_ATTR_ENTRY_TYPE;
+        attrs[count++].value.u8 = (filter->type == SAI_FDB_ENTRY_STATIC) ?
+                                  SAI_FDB_FLUSH_ENTRY_STATIC : SAI_FDB_FLUSH_ENTRY_DYNAMIC;
+    }
+    return count;
+}
+
+static bool filter_match(
+        const test_filter_t *filter,
+        const sai_fdb_entry_info_t *info) {
+    return (!filter->port_id || info->port_id == filter->port_id) &&
+           (!filter->vlan_id || info->fdb_entry.vlan_id == filter->vlan_id) &&
+           (!filter->type_valid || info->type == filter->type);
+}
+
+static bool info_equal(
+        const sai_fdb_entry_info_t *info1,
+        const sai_fdb_entry_info_t *info2) {
+    return !model_order(info1, info2) && info1->type == info2->type &&
+           info1->port_id == info2->port_id && info1->packet_action == info2->packet_action;
+}
+
+/*
+* Dump with the filter in pages of page_size and compare with the model.
+* Every page but the last is full and says there is more.
+*/
+static void dump_check(
+        const test_filter_t *filter,
+        uint32_t page_size) {
+    sai_fdb_entry_info_t page[TEST_PAGE_MAX];
+    sai_fdb_entry_t cursor;
+    sai_attribute_t attrs[3];
+    uint32_t attr_count = filter_attrs(filter, attrs);
+    uint32_t count = 0, expected = 0, seen = 0;
+    uint32_t index = 0, position = 0;
+    bool more = false;
+    bool first = true;
+
+    for (index = 0; index < TEST_ENTRIES; index++) {
+        expected += filter_match(filter, &model[index]);
+    }
+    index = 0;
+    do {
+        count = page_size;
+        CHECK(sai_get_fdb_entries(attr_count, attrs, first ? NULL : &cursor,
+                                  &count, page, &more) == SAI_STATUS_SUCCESS);
+        CHECK(!more || count == page_size);
+        for (position = 0; position < count; position++, seen++) {
+            while (index < TEST_ENTRIES && !filter_match(filter, &model[index])) {
+                index++;
+            }
+            CHECK(index < TEST_ENTRIES && info_equal(&page[position], &model[index]));
+            index++;
+        }
+        if (count) {
+            cursor = page[count - 1].fdb_entry;
+        }
+        first = false;
+    } while (more && count);
+    CHECK(seen == expected);
+}
+
+static void test_dump(void) {
+    test_filter_t filter;
+
+    memset(&filter, 0, sizeof(filter));
+    dump_check(&filter, TEST_PAGE_SIZE);
+    dump_check(&filter, 1);
+    dump_check(&filter, TEST_PAGE_MAX);
+
+    filter.port_id = TEST_PORT_BASE + 1;
+    dump_check(&filter, TEST_PAGE_SIZE);
+    filter.vlan_id = 3;
+    dump_check(&filter, TEST_PAGE_SIZE);
+    filter.type_valid = true;
+    filter.type = SAI_FDB_ENTRY_STATIC;
+    dump_check(&filter, TEST_PAGE_SIZE);
+    filter.port_id = 0;
+    dump_check(&filter, TEST_PAGE_SIZE);
+    filter.vlan_id = 0;
+    filter.type = SAI_FDB_ENTRY_DYNAMIC;
+    dump_check(&filter, TEST_PAGE_SIZE);
+
+    // nothing on the VLAN or port
+    memset(&filter, 0, sizeof(filter));
+    filter.vlan_id = TEST_VLANS + 1;
+    dump_check(&filter, TEST_PAGE_SIZE);
+    memset(&filter, 0, sizeof(filter));
+    filter.port_id = TEST_PORT_BASE + TEST_PORTS;
+    dump_check(&filter, TEST_PAGE_SIZE);
+}
+
+static void test_more(void) {
+    sai_fdb_entry_info_t page[TEST_PAGE_SIZE];
+    sai_attribute_t attr;
+    uint32_t count = 0;
+    bool more = false;
+
+    // a page that ends on the last match says there is no more
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_FDB_FLUSH_ATTR_VLAN_ID;
+    attr.value.u16 = 1;
+    count = TEST_PAGE_SIZE;
+    CHECK(sai_get_fdb_entries(1, &attr, &model[TEST_ENTRIES / TEST_VLANS - TEST_PAGE_SIZE - 1].fdb_entry,
+                              &count, page, &more) == SAI_STATUS_SUCCESS);
+    CHECK(count == TEST_PAGE_SIZE);
+    CHECK(!more);
+    CHECK(info_equal(&page[TEST_PAGE_SIZE - 1], &model[TEST_ENTRIES / TEST_VLANS - 1]));
+
+    count = 0;
+    CHECK(sai_get_fdb_entries(0, NULL, NULL, &count, page, &more) == SAI_STATUS_INVALID_PARAMETER);
+    count = 1;
+    CHECK(sai_get_fdb_entries(0, NULL, NULL, &count, NULL, &more) == SAI_STATUS_INVALID_PARAMETER);
+}
+
+static void test_cursor(void) {
+    sai_fdb_entry_info_t page[2];
+    sai_fdb_entry_info_t added;
+    uint32_t count = 0;
+    bool more = false;
+
+    // the cursor entry goes away and one is added behind it, the next
+    // page still starts right after the cursor key
+    count = 2;
+    CHECK(sai_get_fdb_entries(0, NULL, NULL, &count, page, &more) == SAI_STATUS_SUCCESS);
+    CHECK(count == 2 && more);
+    CHECK(fdb_api.remove_fdb_entry(&page[1].fdb_entry) == SAI_STATUS_SUCCESS);
+    added = model[0];
+    added.fdb_entry.mac_address[0] = 0x00;
+    CHECK(fdb_create(&added) == SAI_STATUS_SUCCESS);
+    count = 2;
+    CHECK(sai_get_fdb_entries(0, NULL, &page[1].fdb_entry, &count, page, &more) ==
+          SAI_STATUS_SUCCESS);
+    CHECK(count == 2 && more);
+    CHECK(info_equal(&page[0], &model[2]));
+    CHECK(info_equal(&page[1], &model[3]));
+
+    // an entry past the cursor shows up
+    added = model[2];
+    added.fdb_entry.mac_address[5]++;
+    CHECK(model_order(&added, &model[3]) < 0);
+    CHECK(fdb_create(&added) == SAI_STATUS_SUCCESS);
+    count = 1;
+    CHECK(sai_get_fdb_entries(0, NULL, &page[0].fdb_entry, &count, page, &more) ==
+          SAI_STATUS_SUCCESS);
+    CHECK(count == 1 && info_equal(&page[0], &added));
+
+    CHECK(fdb_api.flush_fdb_entries(0, NULL) == SAI_STATUS_SUCCESS);
+    count = 2;
+    CHECK(sai_get_fdb_entries(0, NULL, NULL, &count, page, &more) == SAI_STATUS_SUCCESS);
+    CHECK(count == 0 && !more);
+}
+
+int main(void) {
+    sai_api_service_t service;
+
+    sai_fdb_initialize(&service);
+    mock_reset();
+
+    model_populate();
+    test_dump();
+    test_more();
+    test_cursor();
+
+    CHECK_DONE();
+}
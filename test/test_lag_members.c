@@ -0,0 +1,111 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+* LAG membership: a port list change sends only the ports that join or
+* leave, and a LAG whose initial port list cannot be programmed is not
+* left behind.
+*/
+
+#include "switchapi_mock.h"
+#include "saiinternal.h"
+
+extern sai_lag_api_t lag_api;
+
+static sai_status_t lag_create(
+        sai_object_id_t *lag_id,
+        uint32_t count,
+        sai_object_id_t *ports) {
+    sai_attribute_t attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_LAG_ATTR_PORT_LIST;
+    attr.value.objlist.count = count;
+    attr.value.objlist.list = ports;
+    return lag_api.create_lag(lag_id, 1, &attr);
+}
+
+static void test_create(void) {
+    sai_object_id_t ports[] = { 1, 2, 3 };
+    sai_object_id_t lag_id = 0;
+
+    // no LAG handle
+    mock_calls = 0;
+    mock_fail_at = 1;
+    CHECK(lag_create(&lag_id, 3, ports) == SAI_STATUS_FAILURE);
+    CHECK(mock_lag_count() == 0);
+
+    // the second port cannot be added: the first is taken back out and
+    // the LAG is deleted
+    mock_calls = 0;
+    mock_fail_at = 3;
+    CHECK(lag_create(&lag_id, 3, ports) != SAI_STATUS_SUCCESS);
+    mock_fail_at = 0;
+    CHECK(mock_lag_count() == 0);
+
+    CHECK(lag_create(&lag_id, 3, ports) == SAI_STATUS_SUCCESS);
+    CHECK(mock_lag_count() == 1);
+    CHECK(lag_api.remove_lag(lag_id) == SAI_STATUS_SUCCESS);
+    CHECK(mock_lag_count() == 0);
+}
+
+static void test_delta(void) {
+    sai_object_id_t ports[] = { 1, 2, 3 };
+    sai_object_id_t next[] = { 4, 3, 2 };
+    sai_object_id_t overlap[] = { 2, 5 };
+    const switch_handle_t *members = NULL;
+    sai_object_id_t lag_id = 0;
+    sai_attribute_t attr;
+
+    CHECK(lag_create(&lag_id, 3, ports) == SAI_STATUS_SUCCESS);
+
+    // ports 2 and 3 stay: one add and one delete
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_LAG_ATTR_PORT_LIST;
+    attr.value.objlist.count = 3;
+    attr.value.objlist.list = next;
+    mock_calls = 0;
+    CHECK(lag_api.set_lag_attribute(lag_id, &attr) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 2);
+    CHECK(mock_lag_members((switch_handle_t) lag_id, &members) == 3);
+
+    // port 2 is already a member
+    attr.value.objlist.count = 2;
+    attr.value.objlist.list = overlap;
+    mock_calls = 0;
+    CHECK(lag_api.add_ports_to_lag(lag_id, &attr.value.objlist) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 1);
+    CHECK(mock_lag_members((switch_handle_t) lag_id, &members) == 4);
+
+    mock_calls = 0;
+    CHECK(lag_api.remove_ports_from_lag(lag_id, &attr.value.objlist) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 2);
+    CHECK(mock_lag_members((switch_handle_t) lag_id, &members) == 2);
+
+    CHECK(lag_api.remove_lag(lag_id) == SAI_STATUS_SUCCESS);
+}
+
+int main(void) {
+    sai_api_service_t service;
+
+    sai_lag_initialize(&service);
+    mock_reset();
+
+    test_create();
+    test_delta();
+
+    CHECK_DONE();
+}
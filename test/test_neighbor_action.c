@@ -0,0 +1,166 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+* Neighbor packet actions: DROP and TRAP neighbors are host routes to the
+* CPU next hop, FORWARD neighbors are rewrites, and an action change
+* installs the new state before withdrawing the old one. The host route
+* shares the route shadow with the route API, which owns the prefix while
+* it has a route there.
+*/
+
+#include <arpa/inet.h>
+#include "switchapi_mock.h"
+#include "saiinternal.h"
+#include <switchapi/switch_hostif.h>
+
+#define TEST_RIF        1
+#define TEST_VRF        7
+#define TEST_NHOP       0x2222
+
+extern sai_neighbor_api_t neighbor_api;
+extern sai_route_api_t route_api;
+
+sai_status_t sai_router_interface_vrf_get(
+        switch_handle_t rif_handle,
+        switch_handle_t *vrf_handle) {
+    if (rif_handle != TEST_RIF) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+    *vrf_handle = TEST_VRF;
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_neighbor_entry_t neighbor;
+static sai_unicast_route_entry_t host_route;
+static switch_ip_addr_t host_ip;
+
+static sai_status_t neighbor_action_create(int action) {
+    sai_attribute_t attrs[2];
+
+    memset(attrs, 0, sizeof(attrs));
+    attrs[0].id = SAI_NEIGHBOR_ATTR_DST_MAC_ADDRESS;
+    attrs[0].value.mac[5] = 0x11;
+    attrs[1].id = SAI_NEIGHBOR_ATTR_PACKET_ACTION;
+    attrs[1].value.s32 = action;
+    return neighbor_api.create_neighbor_entry(&neighbor, 2, attrs);
+}
+
+static sai_status_t neighbor_action_set(int action) {
+    sai_attribute_t attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_NEIGHBOR_ATTR_PACKET_ACTION;
+    attr.value.s32 = action;
+    return neighbor_api.set_neighbor_attribute(&neighbor, &attr);
+}
+
+static switch_handle_t host_route_nhop(void) {
+    const mock_route_t *route = mock_route_find(TEST_VRF, &host_ip);
+    return route ? route->nhop_handle : 0;
+}
+
+static void test_actions(void) {
+    switch_handle_t drop = switch_api_cpu_nhop_get(SWITCH_HOSTIF_REASON_CODE_NULL_DROP);
+    switch_handle_t glean = switch_api_cpu_nhop_get(SWITCH_HOSTIF_REASON_CODE_GLEAN);
+
+    // pending resolution: no rewrite, host route drops
+    CHECK(neighbor_action_create(SAI_PACKET_ACTION_DROP) == SAI_STATUS_SUCCESS);
+    CHECK(mock_neighbor_count() == 0);
+    CHECK(host_route_nhop() == drop);
+
+    CHECK(neighbor_action_set(SAI_PACKET_ACTION_TRAP) == SAI_STATUS_SUCCESS);
+    CHECK(host_route_nhop() == glean);
+    CHECK(mock_route_count() == 1);
+
+    // resolved: rewrite in, host route out
+    CHECK(neighbor_action_set(SAI_PACKET_ACTION_FORWARD) == SAI_STATUS_SUCCESS);
+    CHECK(mock_neighbor_count() == 1);
+    CHECK(mock_route_count() == 0);
+
+    // the host route is added before the rewrite goes; if it cannot be,
+    // the neighbor keeps forwarding
+    mock_calls = 0;
+    mock_fail_at = 1;
+    CHECK(neighbor_action_set(SAI_PACKET_ACTION_DROP) != SAI_STATUS_SUCCESS);
+    mock_fail_at = 0;
+    CHECK(mock_neighbor_count() == 1);
+    CHECK(mock_route_count() == 0);
+
+    CHECK(neighbor_action_set(SAI_PACKET_ACTION_DROP) == SAI_STATUS_SUCCESS);
+    CHECK(neighbor_api.remove_neighbor_entry(&neighbor) == SAI_STATUS_SUCCESS);
+    CHECK(mock_neighbor_count() == 0);
+    CHECK(mock_route_count() == 0);
+}
+
+static void test_route_overlap(void) {
+    switch_handle_t drop = switch_api_cpu_nhop_get(SWITCH_HOSTIF_REASON_CODE_NULL_DROP);
+    sai_attribute_t attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_ROUTE_ATTR_NEXT_HOP_ID;
+    attr.value.oid = TEST_NHOP;
+
+    // a neighbor-only prefix is not visible to the route API
+    CHECK(neighbor_action_create(SAI_PACKET_ACTION_DROP) == SAI_STATUS_SUCCESS);
+    CHECK(route_api.remove_route(&host_route) == SAI_STATUS_ITEM_NOT_FOUND);
+    CHECK(route_api.get_route_attribute(&host_route, 1, &attr) == SAI_STATUS_ITEM_NOT_FOUND);
+    CHECK(host_route_nhop() == drop);
+
+    // a route for the same prefix takes over, and the host route comes
+    // back when it is removed
+    attr.value.oid = TEST_NHOP;
+    CHECK(route_api.create_route(&host_route, 1, &attr) == SAI_STATUS_SUCCESS);
+    CHECK(host_route_nhop() == TEST_NHOP);
+    CHECK(neighbor_action_set(SAI_PACKET_ACTION_TRAP) == SAI_STATUS_SUCCESS);
+    CHECK(host_route_nhop() == TEST_NHOP);
+    CHECK(neighbor_action_set(SAI_PACKET_ACTION_DROP) == SAI_STATUS_SUCCESS);
+    CHECK(route_api.remove_route(&host_route) == SAI_STATUS_SUCCESS);
+    CHECK(host_route_nhop() == drop);
+
+    // removing the neighbor leaves a route created through the route API
+    CHECK(route_api.create_route(&host_route, 1, &attr) == SAI_STATUS_SUCCESS);
+    CHECK(neighbor_api.remove_neighbor_entry(&neighbor) == SAI_STATUS_SUCCESS);
+    CHECK(host_route_nhop() == TEST_NHOP);
+    CHECK(route_api.remove_route(&host_route) == SAI_STATUS_SUCCESS);
+    CHECK(mock_route_count() == 0);
+}
+
+int main(void) {
+    sai_api_service_t service;
+
+    sai_neighbor_initialize(&service);
+    sai_route_initialize(&service);
+    sai_next_hop_group_initialize(&service);
+    mock_reset();
+
+    neighbor.rif_id = TEST_RIF;
+    neighbor.ip_address.addr_family = SAI_IP_ADDR_FAMILY_IPV4;
+    neighbor.ip_address.addr.ip4 = htonl(0x0a000005);
+    host_route.vr_id = TEST_VRF;
+    host_route.destination.addr_family = SAI_IP_ADDR_FAMILY_IPV4;
+    host_route.destination.addr.ip4 = htonl(0x0a000005);
+    host_route.destination.mask.ip4 = htonl(0xffffffff);
+    memset(&host_ip, 0, sizeof(host_ip));
+    host_ip.type = SWITCH_API_IP_ADDR_V4;
+    host_ip.ip.v4addr = 0x0a000005;
+    host_ip.prefix_len = 32;
+
+    test_actions();
+    test_route_overlap();
+
+    CHECK_DONE();
+}
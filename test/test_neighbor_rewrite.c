@@ -0,0 +1,169 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+* Neighbor MAC rewrite: a MAC change replaces the rewrite within one
+* call and keeps the old one if the new one cannot be added. The bulk
+* calls report a status per entry.
+*/
+
+#include <arpa/inet.h>
+#include "switchapi_mock.h"
+#include "saiinternal.h"
+
+#define TEST_RIF        1
+#define TEST_VRF        7
+#define TEST_COUNT      3
+
+extern sai_neighbor_api_t neighbor_api;
+
+sai_status_t sai_router_interface_vrf_get(
+        switch_handle_t rif_handle,
+        switch_handle_t *vrf_handle) {
+    if (rif_handle != TEST_RIF) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+    *vrf_handle = TEST_VRF;
+    return SAI_STATUS_SUCCESS;
+}
+
+static void neighbor_init(
+        sai_neighbor_entry_t *neighbor,
+        uint32_t ip4) {
+    memset(neighbor, 0, sizeof(sai_neighbor_entry_t));
+    neighbor->rif_id = TEST_RIF;
+    neighbor->ip_address.addr_family = SAI_IP_ADDR_FAMILY_IPV4;
+    neighbor->ip_address.addr.ip4 = htonl(ip4);
+}
+
+static void mac_attr_init(
+        sai_attribute_t *attr,
+        uint8_t mac) {
+    memset(attr, 0, sizeof(sai_attribute_t));
+    attr->id = SAI_NEIGHBOR_ATTR_DST_MAC_ADDRESS;
+    attr->value.mac[5] = mac;
+}
+
+static uint8_t neighbor_mac(
+        const sai_neighbor_entry_t *neighbor) {
+    sai_attribute_t attr;
+
+    mac_attr_init(&attr, 0);
+    if (neighbor_api.get_neighbor_attribute(neighbor, 1, &attr) != SAI_STATUS_SUCCESS) {
+        return 0;
+    }
+    return attr.value.mac[5];
+}
+
+static void test_mac_rewrite(void) {
+    sai_neighbor_entry_t neighbor;
+    sai_attribute_t attr;
+
+    neighbor_init(&neighbor, 0x0a000001);
+    mac_attr_init(&attr, 0x11);
+    CHECK(neighbor_api.create_neighbor_entry(&neighbor, 1, &attr) == SAI_STATUS_SUCCESS);
+
+    // one set replaces the rewrite: remove the old, add the new
+    mac_attr_init(&attr, 0x12);
+    mock_calls = 0;
+    CHECK(neighbor_api.set_neighbor_attribute(&neighbor, &attr) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 2);
+    CHECK(mock_neighbor_count() == 1);
+    CHECK(neighbor_mac(&neighbor) == 0x12);
+
+    // a re-create with a new MAC takes the same path
+    mac_attr_init(&attr, 0x13);
+    CHECK(neighbor_api.create_neighbor_entry(&neighbor, 1, &attr) == SAI_STATUS_SUCCESS);
+    CHECK(mock_neighbor_count() == 1);
+    CHECK(neighbor_mac(&neighbor) == 0x13);
+
+    // the new rewrite cannot be added: the old one is restored
+    mac_attr_init(&attr, 0x14);
+    mock_calls = 0;
+    mock_fail_at = 2;
+    CHECK(neighbor_api.set_neighbor_attribute(&neighbor, &attr) == SAI_STATUS_FAILURE);
+    mock_fail_at = 0;
+    CHECK(mock_neighbor_count() == 1);
+    CHECK(neighbor_mac(&neighbor) == 0x13);
+
+    // the old rewrite cannot be removed: nothing changes
+    mock_calls = 0;
+    mock_fail_at = 1;
+    CHECK(neighbor_api.set_neighbor_attribute(&neighbor, &attr) != SAI_STATUS_SUCCESS);
+    mock_fail_at = 0;
+    CHECK(mock_neighbor_count() == 1);
+    CHECK(neighbor_mac(&neighbor) == 0x13);
+
+    CHECK(neighbor_api.remove_neighbor_entry(&neighbor) == SAI_STATUS_SUCCESS);
+    CHECK(mock_neighbor_count() == 0);
+}
+
+static void test_bulk(void) {
+    sai_neighbor_entry_t neighbors[TEST_COUNT];
+    sai_attribute_t attrs[TEST_COUNT][2];
+    const sai_attribute_t *attr_lists[TEST_COUNT];
+    sai_attribute_t set_attrs[TEST_COUNT];
+    uint32_t attr_counts[TEST_COUNT];
+    sai_status_t statuses[TEST_COUNT];
+    uint32_t index = 0;
+
+    for (index = 0; index < TEST_COUNT; index++) {
+        neighbor_init(&neighbors[index], 0x0a000010 + index);
+        mac_attr_init(&attrs[index][0], 0x20 + index);
+        attrs[index][1].id = SAI_NEIGHBOR_ATTR_PACKET_ACTION;
+        attrs[index][1].value.s32 = SAI_PACKET_ACTION_FORWARD;
+        attr_lists[index] = attrs[index];
+        attr_counts[index] = 2;
+        mac_attr_init(&set_attrs[index], 0x30 + index);
+    }
+    // the middle entry carries an action neighbors do not support
+    attrs[1][1].value.s32 = SAI_PACKET_ACTION_LOG;
+
+    CHECK(sai_bulk_create_neighbor_entry(
+        TEST_COUNT, neighbors, attr_counts, attr_lists, statuses) == SAI_STATUS_FAILURE);
+    CHECK(statuses[0] == SAI_STATUS_SUCCESS);
+    CHECK(statuses[1] == SAI_STATUS_INVALID_PARAMETER);
+    CHECK(statuses[2] == SAI_STATUS_SUCCESS);
+    CHECK(mock_neighbor_count() == 2);
+
+    CHECK(sai_bulk_set_neighbor_entry_attribute(
+        TEST_COUNT, neighbors, set_attrs, statuses) == SAI_STATUS_FAILURE);
+    CHECK(statuses[0] == SAI_STATUS_SUCCESS);
+    CHECK(statuses[1] == SAI_STATUS_ITEM_NOT_FOUND);
+    CHECK(statuses[2] == SAI_STATUS_SUCCESS);
+    CHECK(neighbor_mac(&neighbors[0]) == 0x30);
+    CHECK(neighbor_mac(&neighbors[2]) == 0x32);
+
+    CHECK(sai_bulk_remove_neighbor_entry(TEST_COUNT, neighbors, statuses) == SAI_STATUS_FAILURE);
+    CHECK(statuses[0] == SAI_STATUS_SUCCESS);
+    CHECK(statuses[1] == SAI_STATUS_ITEM_NOT_FOUND);
+    CHECK(statuses[2] == SAI_STATUS_SUCCESS);
+    CHECK(mock_neighbor_count() == 0);
+}
+
+int main(void) {
+    sai_api_service_t service;
+
+    sai_neighbor_initialize(&service);
+    sai_route_initialize(&service);
+    sai_next_hop_group_initialize(&service);
+    mock_reset();
+
+    test_mac_rewrite();
+    test_bulk();
+
+    CHECK_DONE();
+}
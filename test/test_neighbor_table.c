@@ -0,0 +1,125 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+* Neighbor table: a created neighbor keeps its switchapi handles, so a
+* re-create of the same neighbor and its removal need no lookups, and a
+* failed create leaves nothing behind.
+*/
+
+#include <arpa/inet.h>
+#include "switchapi_mock.h"
+#include "saiinternal.h"
+
+#define TEST_RIF        1
+#define TEST_VRF        7
+
+extern sai_neighbor_api_t neighbor_api;
+
+sai_status_t sai_router_interface_vrf_get(
+        switch_handle_t rif_handle,
+        switch_handle_t *vrf_handle) {
+    if (rif_handle != TEST_RIF) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+    *vrf_handle = TEST_VRF;
+    return SAI_STATUS_SUCCESS;
+}
+
+static void neighbor_init(
+        sai_neighbor_entry_t *neighbor,
+        uint32_t ip4) {
+    memset(neighbor, 0, sizeof(sai_neighbor_entry_t));
+    neighbor->rif_id = TEST_RIF;
+    neighbor->ip_address.addr_family = SAI_IP_ADDR_FAMILY_IPV4;
+    neighbor->ip_address.addr.ip4 = htonl(ip4);
+}
+
+static sai_status_t neighbor_create(
+        const sai_neighbor_entry_t *neighbor,
+        uint8_t mac) {
+    sai_attribute_t attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_NEIGHBOR_ATTR_DST_MAC_ADDRESS;
+    attr.value.mac[5] = mac;
+    return neighbor_api.create_neighbor_entry(neighbor, 1, &attr);
+}
+
+static void test_cached_handles(void) {
+    sai_neighbor_entry_t neighbor;
+    sai_attribute_t attr;
+
+    neighbor_init(&neighbor, 0x0a000001);
+    mock_calls = 0;
+    CHECK(neighbor_create(&neighbor, 0x11) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 1);
+    CHECK(mock_neighbor_count() == 1);
+
+    // an ARP refresh with the same MAC does not reach switchapi
+    mock_calls = 0;
+    CHECK(neighbor_create(&neighbor, 0x11) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 0);
+    CHECK(mock_neighbor_count() == 1);
+
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_NEIGHBOR_ATTR_DST_MAC_ADDRESS;
+    CHECK(neighbor_api.get_neighbor_attribute(&neighbor, 1, &attr) == SAI_STATUS_SUCCESS);
+    CHECK(attr.value.mac[5] == 0x11);
+
+    // remove goes straight to the cached handle
+    mock_calls = 0;
+    CHECK(neighbor_api.remove_neighbor_entry(&neighbor) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 1);
+    CHECK(mock_neighbor_count() == 0);
+    CHECK(neighbor_api.remove_neighbor_entry(&neighbor) == SAI_STATUS_ITEM_NOT_FOUND);
+}
+
+static void test_failed_create(void) {
+    sai_neighbor_entry_t neighbor;
+    sai_attribute_t attr;
+
+    neighbor_init(&neighbor, 0x0a000002);
+    mock_calls = 0;
+    mock_fail_at = 1;
+    CHECK(neighbor_create(&neighbor, 0x22) != SAI_STATUS_SUCCESS);
+    mock_fail_at = 0;
+    CHECK(mock_neighbor_count() == 0);
+
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_NEIGHBOR_ATTR_DST_MAC_ADDRESS;
+    CHECK(neighbor_api.get_neighbor_attribute(&neighbor, 1, &attr) == SAI_STATUS_ITEM_NOT_FOUND);
+    CHECK(neighbor_api.remove_neighbor_entry(&neighbor) == SAI_STATUS_ITEM_NOT_FOUND);
+
+    // the next create starts from scratch
+    CHECK(neighbor_create(&neighbor, 0x22) == SAI_STATUS_SUCCESS);
+    CHECK(mock_neighbor_count() == 1);
+    CHECK(neighbor_api.remove_neighbor_entry(&neighbor) == SAI_STATUS_SUCCESS);
+}
+
+int main(void) {
+    sai_api_service_t service;
+
+    sai_neighbor_initialize(&service);
+    sai_route_initialize(&service);
+    sai_next_hop_group_initialize(&service);
+    mock_reset();
+
+    test_cached_handles();
+    test_failed_create();
+
+    CHECK_DONE();
+}
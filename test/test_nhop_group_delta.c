@@ -0,0 +1,151 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+* Next hop group member lists: only the members that differ reach
+* switchapi, new members are added before departed ones are deleted,
+* and a failed delete rolls the additions back.
+*/
+
+#include "switchapi_mock.h"
+#include "saiinternal.h"
+
+extern sai_next_hop_group_api_t nhop_group_api;
+
+static sai_object_id_t group_id;
+
+static sai_status_t group_set(
+        uint32_t count,
+        sai_object_id_t *nexthops) {
+    sai_attribute_t attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_LIST;
+    attr.value.objlist.count = count;
+    attr.value.objlist.list = nexthops;
+    return nhop_group_api.set_next_hop_group_attribute(group_id, &attr);
+}
+
+/*
+* The ECMP members programmed for the group, compared as a set.
+*/
+static bool group_has(
+        uint32_t count,
+        const sai_object_id_t *nexthops) {
+    const switch_handle_t *members = NULL;
+    switch_handle_t ecmp_handle = sai_next_hop_group_nhop_get(group_id);
+    uint32_t member_count = mock_ecmp_members(ecmp_handle, &members);
+    uint32_t index = 0, member = 0;
+
+    if (member_count != count) {
+        return false;
+    }
+    for (index = 0; index < count; index++) {
+        for (member = 0; member < member_count; member++) {
+            if (members[member] == nexthops[index]) {
+                break;
+            }
+        }
+        if (member == member_count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_delta(void) {
+    sai_object_id_t initial[] = { 3, 1, 2 };
+    sai_object_id_t next[] = { 4, 3, 2 };
+    sai_object_id_t repeated[] = { 2, 2, 3, 4 };
+    sai_object_id_t one[] = { 3 };
+    sai_attribute_t attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_LIST;
+    attr.value.objlist.count = 3;
+    attr.value.objlist.list = initial;
+    CHECK(nhop_group_api.create_next_hop_group(&group_id, 1, &attr) == SAI_STATUS_SUCCESS);
+    CHECK(mock_ecmp_count() == 1);
+    CHECK(group_has(3, initial));
+
+    // one add for the new member, one delete for the departed one
+    mock_calls = 0;
+    CHECK(group_set(3, next) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 2);
+    CHECK(group_has(3, next));
+
+    // duplicates and members already in the group change nothing
+    mock_calls = 0;
+    CHECK(group_set(4, repeated) == SAI_STATUS_SUCCESS);
+    CHECK(nhop_group_api.add_next_hop_to_group(group_id, 1, one) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 0);
+    CHECK(group_has(3, next));
+
+    attr.value.objlist.count = 3;
+    attr.value.objlist.list = initial;
+    memset(initial, 0, sizeof(initial));
+    CHECK(nhop_group_api.get_next_hop_group_attribute(group_id, 1, &attr) == SAI_STATUS_SUCCESS);
+    CHECK(attr.value.objlist.count == 3);
+    CHECK(initial[0] == 2 && initial[1] == 3 && initial[2] == 4);
+
+    mock_calls = 0;
+    CHECK(nhop_group_api.remove_next_hop_from_group(group_id, 1, one) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 1);
+}
+
+static void test_rollback(void) {
+    sai_object_id_t current[] = { 2, 4 };
+    sai_object_id_t next[] = { 2, 5 };
+
+    CHECK(group_has(2, current));
+
+    // the add fails: nothing was changed
+    mock_calls = 0;
+    mock_fail_at = 1;
+    CHECK(group_set(2, next) != SAI_STATUS_SUCCESS);
+    mock_fail_at = 0;
+    CHECK(group_has(2, current));
+
+    // the delete fails after the add: the departed member is still in,
+    // so the add went first, and the new member is rolled back
+    mock_calls = 0;
+    mock_fail_at = 2;
+    CHECK(group_set(2, next) != SAI_STATUS_SUCCESS);
+    mock_fail_at = 0;
+    CHECK(group_has(2, current));
+
+    // the shadow was left alone, so the same change applies cleanly
+    mock_calls = 0;
+    CHECK(group_set(2, next) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 2);
+    CHECK(group_has(2, next));
+
+    CHECK(nhop_group_api.remove_next_hop_group(group_id) == SAI_STATUS_SUCCESS);
+    CHECK(mock_ecmp_count() == 0);
+}
+
+int main(void) {
+    sai_api_service_t service;
+
+    sai_next_hop_group_initialize(&service);
+    sai_route_initialize(&service);
+    mock_reset();
+
+    test_delta();
+    test_rollback();
+
+    CHECK_DONE();
+}
@@ -0,0 +1,216 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+* Next hop group sharing: ids with the same members share one ECMP group,
+* an id whose members diverge gets a copy and its routes follow it, and a
+* group id used by a route cannot be removed.
+*/
+
+#include <arpa/inet.h>
+#include "switchapi_mock.h"
+#include "saiinternal.h"
+
+#define TEST_VRF        7
+#define TEST_GROUPS     3
+
+extern sai_next_hop_group_api_t nhop_group_api;
+extern sai_route_api_t route_api;
+
+static sai_object_id_t group_ids[TEST_GROUPS];
+
+static sai_status_t group_create(
+        sai_object_id_t *group_id,
+        uint32_t count,
+        sai_object_id_t *nexthops) {
+    sai_attribute_t attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_LIST;
+    attr.value.objlist.count = count;
+    attr.value.objlist.list = nexthops;
+    return nhop_group_api.create_next_hop_group(group_id, 1, &attr);
+}
+
+static sai_status_t group_set(
+        sai_object_id_t group_id,
+        uint32_t count,
+        sai_object_id_t *nexthops) {
+    sai_attribute_t attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_LIST;
+    attr.value.objlist.count = count;
+    attr.value.objlist.list = nexthops;
+    return nhop_group_api.set_next_hop_group_attribute(group_id, &attr);
+}
+
+static void route_init(
+        sai_unicast_route_entry_t *route,
+        uint32_t ip4) {
+    memset(route, 0, sizeof(sai_unicast_route_entry_t));
+    route->vr_id = TEST_VRF;
+    route->destination.addr_family = SAI_IP_ADDR_FAMILY_IPV4;
+    route->destination.addr.ip4 = htonl(ip4);
+    route->destination.mask.ip4 = htonl(0xffffff00);
+}
+
+static sai_status_t route_create(
+        uint32_t ip4,
+        sai_object_id_t next_hop_id) {
+    sai_unicast_route_entry_t route;
+    sai_attribute_t attr;
+
+    route_init(&route, ip4);
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_ROUTE_ATTR_NEXT_HOP_ID;
+    attr.value.oid = next_hop_id;
+    return route_api.create_route(&route, 1, &attr);
+}
+
+static sai_status_t route_remove(
+        uint32_t ip4) {
+    sai_unicast_route_entry_t route;
+
+    route_init(&route, ip4);
+    return route_api.remove_route(&route);
+}
+
+static switch_handle_t route_nhop(
+        uint32_t ip4) {
+    const mock_route_t *route = NULL;
+    switch_ip_addr_t ip_addr;
+
+    memset(&ip_addr, 0, sizeof(ip_addr));
+    ip_addr.type = SWITCH_API_IP_ADDR_V4;
+    ip_addr.ip.v4addr = ip4;
+    ip_addr.prefix_len = 24;
+    route = mock_route_find(TEST_VRF, &ip_addr);
+    return route ? route->nhop_handle : 0;
+}
+
+static switch_handle_t group_ecmp(
+        sai_object_id_t group_id) {
+    return sai_next_hop_group_nhop_get((switch_handle_t) group_id);
+}
+
+static void test_share(void) {
+    sai_object_id_t members[TEST_GROUPS][2] = {
+        { 0x2001, 0x2002 }, { 0x2002, 0x2001 }, { 0x2001, 0x2002 } };
+    uint32_t index = 0;
+
+    // the member order and the id do not matter, one ECMP group serves all
+    mock_calls = 0;
+    for (index = 0; index < TEST_GROUPS; index++) {
+        CHECK(group_create(&group_ids[index], 2, members[index]) == SAI_STATUS_SUCCESS);
+        CHECK(group_ids[index] >= SAI_NHOP_GROUP_ID_BASE);
+    }
+    CHECK(mock_ecmp_count() == 1);
+    CHECK(mock_calls == 2);
+    CHECK(group_ids[0] != group_ids[1] && group_ids[1] != group_ids[2]);
+    CHECK(group_ecmp(group_ids[0]) == group_ecmp(group_ids[1]));
+    CHECK(group_ecmp(group_ids[1]) == group_ecmp(group_ids[2]));
+    CHECK(group_ecmp(SAI_NHOP_GROUP_ID_BASE - 1) == SAI_NHOP_GROUP_ID_BASE - 1);
+    CHECK(group_ecmp(group_ids[2] + 1) == 0);
+}
+
+static void test_copy_on_write(void) {
+    sai_object_id_t shared[] = { 0x2001, 0x2002 };
+    sai_object_id_t divergent[] = { 0x2001, 0x2003 };
+    switch_handle_t shared_ecmp = group_ecmp(group_ids[0]);
+    switch_handle_t copy_ecmp = 0;
+
+    CHECK(route_create(0x0a000100, group_ids[0]) == SAI_STATUS_SUCCESS);
+    CHECK(route_create(0x0a000200, group_ids[1]) == SAI_STATUS_SUCCESS);
+    CHECK(route_nhop(0x0a000100) == shared_ecmp);
+    CHECK(route_nhop(0x0a000200) == shared_ecmp);
+
+    // the copy is created and filled before the route moves, and the
+    // shared group is left untouched for the other ids
+    mock_calls = 0;
+    CHECK(group_set(group_ids[1], 2, divergent) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 3);
+    CHECK(mock_ecmp_count() == 2);
+    copy_ecmp = group_ecmp(group_ids[1]);
+    CHECK(copy_ecmp != shared_ecmp);
+    CHECK(group_ecmp(group_ids[0]) == shared_ecmp);
+    CHECK(group_ecmp(group_ids[2]) == shared_ecmp);
+    CHECK(route_nhop(0x0a000100) == shared_ecmp);
+    CHECK(route_nhop(0x0a000200) == copy_ecmp);
+
+    // back to the shared members: the id rejoins the shared group, its
+    // route follows and the copy is deleted
+    mock_calls = 0;
+    CHECK(group_set(group_ids[1], 2, shared) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 2);
+    CHECK(mock_ecmp_count() == 1);
+    CHECK(group_ecmp(group_ids[1]) == shared_ecmp);
+    CHECK(route_nhop(0x0a000200) == shared_ecmp);
+}
+
+static void test_rebind_failure(void) {
+    sai_object_id_t divergent[] = { 0x2001, 0x2003 };
+    switch_handle_t shared_ecmp = group_ecmp(group_ids[1]);
+
+    // ECMP create, member add, then the route update fails: the id stays
+    // on the shared group and the copy is deleted again
+    mock_calls = 0;
+    mock_fail_at = 3;
+    CHECK(group_set(group_ids[1], 2, divergent) != SAI_STATUS_SUCCESS);
+    mock_fail_at = 0;
+    CHECK(mock_ecmp_count() == 1);
+    CHECK(group_ecmp(group_ids[1]) == shared_ecmp);
+    CHECK(route_nhop(0x0a000200) == shared_ecmp);
+}
+
+static void test_in_use(void) {
+    switch_handle_t shared_ecmp = group_ecmp(group_ids[0]);
+
+    CHECK(nhop_group_api.remove_next_hop_group(group_ids[0]) == SAI_STATUS_OBJECT_IN_USE);
+    CHECK(nhop_group_api.remove_next_hop_group(group_ids[1]) == SAI_STATUS_OBJECT_IN_USE);
+    CHECK(group_ecmp(group_ids[0]) == shared_ecmp);
+
+    // an unused id goes, the ECMP group stays for the others
+    CHECK(nhop_group_api.remove_next_hop_group(group_ids[2]) == SAI_STATUS_SUCCESS);
+    CHECK(nhop_group_api.remove_next_hop_group(group_ids[2]) == SAI_STATUS_ITEM_NOT_FOUND);
+    CHECK(mock_ecmp_count() == 1);
+
+    // a route to an unknown group id is refused
+    CHECK(route_create(0x0a000300, group_ids[2]) != SAI_STATUS_SUCCESS);
+
+    CHECK(route_remove(0x0a000100) == SAI_STATUS_SUCCESS);
+    CHECK(nhop_group_api.remove_next_hop_group(group_ids[0]) == SAI_STATUS_SUCCESS);
+    CHECK(nhop_group_api.remove_next_hop_group(group_ids[1]) == SAI_STATUS_OBJECT_IN_USE);
+    CHECK(route_remove(0x0a000200) == SAI_STATUS_SUCCESS);
+    CHECK(nhop_group_api.remove_next_hop_group(group_ids[1]) == SAI_STATUS_SUCCESS);
+    CHECK(mock_ecmp_count() == 0);
+    CHECK(mock_route_count() == 0);
+}
+
+int main(void) {
+    sai_api_service_t service;
+
+    sai_next_hop_group_initialize(&service);
+    sai_route_initialize(&service);
+    mock_reset();
+
+    test_share();
+    test_copy_on_write();
+    test_rebind_failure();
+    test_in_use();
+
+    CHECK_DONE();
+}
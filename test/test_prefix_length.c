@@ -0,0 +1,221 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+* Route prefix lengths: sai_v4_prefix_length and sai_v6_prefix_length
+* agree with the bit counting loops they replaced on every contiguous
+* mask, and return -1 for any mask with a hole, which the loops counted.
+*/
+
+#include <arpa/inet.h>
+#include "switchapi_mock.h"
+#include "saiinternal.h"
+
+#define TEST_RANDOM_MASKS       100000
+
+extern sai_route_api_t route_api;
+
+/*
+* The implementations before masks were validated, kept as the reference.
+*/
+static unsigned int loop_v4_prefix_length(sai_ip4_t ip4) {
+    int x = 0;
+    unsigned int prefix_length = 0;
+    while (ip4) {
+        x = ip4 & 0x1;
+        if (x) prefix_length++;
+        ip4 = ip4 >> 1;
+    }
+    return prefix_length;
+}
+
+static unsigned int loop_v6_prefix_length(const sai_ip6_t ip6) {
+    int i = 0, x = 0;
+    unsigned int prefix_length = 0;
+    sai_ip6_t ip6_temp;
+    memcpy(ip6_temp, ip6, 16);
+    for (i = 0; i < 16; i++) {
+        if (ip6_temp[i] == 0xFF) {
+            prefix_length += 8;
+        } else {
+            while (ip6_temp[i]) {
+                x = ip6_temp[i] & 0x1;
+                if (x) prefix_length++;
+                ip6_temp[i] = ip6_temp[i] >> 1;
+            }
+        }
+    }
+    return prefix_length;
+}
+
+static uint32_t test_random(void) {
+    static uint64_t state = 0x9E3779B97F4A7C15ULL;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return (uint32_t) state;
+}
+
+static sai_ip4_t v4_mask(unsigned int length) {
+    return length ? (sai_ip4_t) (0xffffffffu << (32 - length)) : 0;
+}
+
+static void v6_mask(unsigned int length, sai_ip6_t ip6) {
+    unsigned int index = 0;
+
+    memset(ip6, 0, 16);
+    for (index = 0; index < length; index++) {
+        ip6[index / 8] |= 0x80 >> (index % 8);
+    }
+}
+
+/*
+* A mask is contiguous when no set bit follows a clear one, MSB first.
+*/
+static bool v4_contiguous(sai_ip4_t ip4) {
+    bool clear = false;
+    int bit = 0;
+
+    for (bit = 31; bit >= 0; bit--) {
+        if (!((ip4 >> bit) & 1)) {
+            clear = true;
+        } else if (clear) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool v6_contiguous(const sai_ip6_t ip6) {
+    bool clear = false;
+    int bit = 0;
+
+    for (bit = 0; bit < 128; bit++) {
+        if (!(ip6[bit / 8] & (0x80 >> (bit % 8)))) {
+            clear = true;
+        } else if (clear) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_v4(void) {
+    static const sai_ip4_t holes[] = {
+        0xff00ff00, 0x7fffffff, 0x80000001, 0x00000001, 0xfffffffd, 0xffff7fff,
+    };
+    unsigned int length = 0;
+    unsigned int index = 0;
+    sai_ip4_t ip4 = 0;
+
+    for (length = 0; length <= 32; length++) {
+        CHECK(sai_v4_prefix_length(v4_mask(length)) == (int) length);
+        CHECK(loop_v4_prefix_length(v4_mask(length)) == length);
+    }
+    for (index = 0; index < sizeof(holes) / sizeof(holes[0]); index++) {
+        CHECK(sai_v4_prefix_length(holes[index]) == -1);
+    }
+    for (index = 0; index < TEST_RANDOM_MASKS; index++) {
+        // mostly near-contiguous masks, a random one every fourth round
+        ip4 = v4_mask(test_random() % 33);
+        if (index % 4) {
+            ip4 ^= (sai_ip4_t) 1 << (test_random() % 32);
+        } else {
+            ip4 = test_random();
+        }
+        CHECK(sai_v4_prefix_length(ip4) ==
+              (v4_contiguous(ip4) ? (int) loop_v4_prefix_length(ip4) : -1));
+    }
+}
+
+static void test_v6(void) {
+    unsigned int length = 0;
+    unsigned int index = 0, byte = 0;
+    sai_ip6_t ip6;
+
+    for (length = 0; length <= 128; length++) {
+        v6_mask(length, ip6);
+        CHECK(sai_v6_prefix_length(ip6) == (int) length);
+        CHECK(loop_v6_prefix_length(ip6) == length);
+    }
+
+    // a hole in either half, or bits in the low half after a short high half
+    v6_mask(64, ip6);
+    ip6[15] = 0x01;
+    CHECK(sai_v6_prefix_length(ip6) == -1);
+    v6_mask(63, ip6);
+    ip6[8] = 0x80;
+    CHECK(sai_v6_prefix_length(ip6) == -1);
+    v6_mask(120, ip6);
+    ip6[3] = 0xfe;
+    CHECK(sai_v6_prefix_length(ip6) == -1);
+    memset(ip6, 0, 16);
+    ip6[0] = 0x40;
+    CHECK(sai_v6_prefix_length(ip6) == -1);
+
+    for (index = 0; index < TEST_RANDOM_MASKS; index++) {
+        v6_mask(test_random() % 129, ip6);
+        if (index % 4) {
+            byte = test_random() % 128;
+            ip6[byte / 8] ^= 0x80 >> (byte % 8);
+        } else {
+            for (byte = 0; byte < 16; byte++) {
+                ip6[byte] = (uint8_t) test_random();
+            }
+        }
+        CHECK(sai_v6_prefix_length(ip6) ==
+              (v6_contiguous(ip6) ? (int) loop_v6_prefix_length(ip6) : -1));
+    }
+}
+
+static void test_route(void) {
+    sai_unicast_route_entry_t route;
+    sai_attribute_t attr;
+
+    memset(&route, 0, sizeof(route));
+    memset(&attr, 0, sizeof(attr));
+    route.vr_id = 7;
+    route.destination.addr_family = SAI_IP_ADDR_FAMILY_IPV4;
+    route.destination.addr.ip4 = htonl(0x0a000000);
+    route.destination.mask.ip4 = htonl(0xff00ff00);
+    attr.id = SAI_ROUTE_ATTR_NEXT_HOP_ID;
+    attr.value.oid = MOCK_NHOP_BASE + 1;
+
+    // a mask with a hole never reaches switchapi
+    mock_calls = 0;
+    CHECK(route_api.create_route(&route, 1, &attr) == SAI_STATUS_INVALID_PARAMETER);
+    CHECK(route_api.remove_route(&route) == SAI_STATUS_INVALID_PARAMETER);
+    CHECK(mock_calls == 0);
+
+    route.destination.mask.ip4 = htonl(0xff000000);
+    CHECK(route_api.create_route(&route, 1, &attr) == SAI_STATUS_SUCCESS);
+    CHECK(route_api.remove_route(&route) == SAI_STATUS_SUCCESS);
+    CHECK(mock_route_count() == 0);
+}
+
+int main(void) {
+    sai_api_service_t service;
+
+    sai_next_hop_group_initialize(&service);
+    sai_route_initialize(&service);
+    mock_reset();
+
+    test_v4();
+    test_v6();
+    test_route();
+
+    CHECK_DONE();
+}
@@ -0,0 +1,249 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+* Route shadow: a re-sent identical route does not reach switchapi, a
+* re-sent route with a new next hop is one update, and get is answered
+* from the shadow. Setting the next hop or packet action swaps the route
+* in place with a single switchapi update.
+*/
+
+#include <arpa/inet.h>
+#include "switchapi_mock.h"
+#include "saiinternal.h"
+#include <switchapi/switch_hostif.h>
+
+#define TEST_VRF        7
+#define TEST_NHOP1      0x2001
+#define TEST_NHOP2      0x2002
+#define TEST_COUNT      3
+
+extern sai_route_api_t route_api;
+
+static void route_init(
+        sai_unicast_route_entry_t *route,
+        uint32_t ip4,
+        uint32_t mask4) {
+    memset(route, 0, sizeof(sai_unicast_route_entry_t));
+    route->vr_id = TEST_VRF;
+    route->destination.addr_family = SAI_IP_ADDR_FAMILY_IPV4;
+    route->destination.addr.ip4 = htonl(ip4);
+    route->destination.mask.ip4 = htonl(mask4);
+}
+
+static void nhop_attr_init(
+        sai_attribute_t *attr,
+        sai_object_id_t next_hop_id) {
+    memset(attr, 0, sizeof(sai_attribute_t));
+    attr->id = SAI_ROUTE_ATTR_NEXT_HOP_ID;
+    attr->value.oid = next_hop_id;
+}
+
+static switch_handle_t route_nhop(
+        uint32_t ip4,
+        uint8_t prefix_len) {
+    const mock_route_t *route = NULL;
+    switch_ip_addr_t ip_addr;
+
+    memset(&ip_addr, 0, sizeof(ip_addr));
+    ip_addr.type = SWITCH_API_IP_ADDR_V4;
+    ip_addr.ip.v4addr = ip4;
+    ip_addr.prefix_len = prefix_len;
+    route = mock_route_find(TEST_VRF, &ip_addr);
+    return route ? route->nhop_handle : 0;
+}
+
+static void test_duplicates(void) {
+    sai_unicast_route_entry_t route;
+    sai_attribute_t attr;
+
+    route_init(&route, 0x0a010000, 0xffff0000);
+    nhop_attr_init(&attr, TEST_NHOP1);
+    mock_calls = 0;
+    CHECK(route_api.create_route(&route, 1, &attr) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 1);
+    CHECK(route_nhop(0x0a010000, 16) == TEST_NHOP1);
+
+    // an identical re-advertisement is absorbed
+    mock_calls = 0;
+    CHECK(route_api.create_route(&route, 1, &attr) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 0);
+    CHECK(mock_route_count() == 1);
+
+    // a re-advertisement with a new next hop is a single update
+    nhop_attr_init(&attr, TEST_NHOP2);
+    mock_calls = 0;
+    CHECK(route_api.create_route(&route, 1, &attr) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 1);
+    CHECK(mock_route_count() == 1);
+    CHECK(route_nhop(0x0a010000, 16) == TEST_NHOP2);
+
+    // a failed update keeps the shadow on the old next hop
+    nhop_attr_init(&attr, TEST_NHOP1);
+    mock_calls = 0;
+    mock_fail_at = 1;
+    CHECK(route_api.create_route(&route, 1, &attr) != SAI_STATUS_SUCCESS);
+    mock_fail_at = 0;
+    nhop_attr_init(&attr, 0);
+    CHECK(route_api.get_route_attribute(&route, 1, &attr) == SAI_STATUS_SUCCESS);
+    CHECK(attr.value.oid == TEST_NHOP2);
+
+    mock_calls = 0;
+    CHECK(route_api.remove_route(&route) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 1);
+    CHECK(mock_route_count() == 0);
+    CHECK(route_api.remove_route(&route) == SAI_STATUS_ITEM_NOT_FOUND);
+}
+
+static void test_get(void) {
+    sai_unicast_route_entry_t route;
+    sai_attribute_t attrs[3];
+
+    route_init(&route, 0x0a020000, 0xffffff00);
+    nhop_attr_init(&attrs[0], TEST_NHOP1);
+    CHECK(route_api.create_route(&route, 1, attrs) == SAI_STATUS_SUCCESS);
+
+    memset(attrs, 0, sizeof(attrs));
+    attrs[0].id = SAI_ROUTE_ATTR_NEXT_HOP_ID;
+    attrs[1].id = SAI_ROUTE_ATTR_PACKET_ACTION;
+    attrs[2].id = SAI_ROUTE_ATTR_TRAP_PRIORITY;
+    mock_calls = 0;
+    CHECK(route_api.get_route_attribute(&route, 3, attrs) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 0);
+    CHECK(attrs[0].value.oid == TEST_NHOP1);
+    CHECK(attrs[1].value.s32 == SAI_PACKET_ACTION_FORWARD);
+    CHECK(attrs[2].value.u8 == 0);
+
+    // the prefix length is part of the key
+    route_init(&route, 0x0a020000, 0xffff0000);
+    CHECK(route_api.get_route_attribute(&route, 1, attrs) == SAI_STATUS_ITEM_NOT_FOUND);
+
+    // non-contiguous masks are rejected
+    route_init(&route, 0x0a020000, 0xff00ff00);
+    CHECK(route_api.get_route_attribute(&route, 1, attrs) == SAI_STATUS_INVALID_PARAMETER);
+
+    route_init(&route, 0x0a020000, 0xffffff00);
+    CHECK(route_api.remove_route(&route) == SAI_STATUS_SUCCESS);
+}
+
+static void test_set(void) {
+    switch_handle_t drop = switch_api_cpu_nhop_get(SWITCH_HOSTIF_REASON_CODE_NULL_DROP);
+    switch_handle_t glean = switch_api_cpu_nhop_get(SWITCH_HOSTIF_REASON_CODE_GLEAN);
+    sai_unicast_route_entry_t route;
+    sai_attribute_t attr;
+
+    route_init(&route, 0x0a030000, 0xffffff00);
+    nhop_attr_init(&attr, TEST_NHOP1);
+    CHECK(route_api.create_route(&route, 1, &attr) == SAI_STATUS_SUCCESS);
+
+    // a next hop change is one update, the route never leaves the table
+    nhop_attr_init(&attr, TEST_NHOP2);
+    mock_calls = 0;
+    CHECK(route_api.set_route_attribute(&route, &attr) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 1);
+    CHECK(mock_route_count() == 1);
+    CHECK(route_nhop(0x0a030000, 24) == TEST_NHOP2);
+
+    mock_calls = 0;
+    CHECK(route_api.set_route_attribute(&route, &attr) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 0);
+
+    // DROP and TRAP override the next hop until set back to FORWARD
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_ROUTE_ATTR_PACKET_ACTION;
+    attr.value.s32 = SAI_PACKET_ACTION_DROP;
+    mock_calls = 0;
+    CHECK(route_api.set_route_attribute(&route, &attr) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 1);
+    CHECK(route_nhop(0x0a030000, 24) == drop);
+
+    attr.value.s32 = SAI_PACKET_ACTION_TRAP;
+    CHECK(route_api.set_route_attribute(&route, &attr) == SAI_STATUS_SUCCESS);
+    CHECK(route_nhop(0x0a030000, 24) == glean);
+
+    // a next hop set while trapping is kept for later
+    nhop_attr_init(&attr, TEST_NHOP1);
+    mock_calls = 0;
+    CHECK(route_api.set_route_attribute(&route, &attr) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 0);
+    CHECK(route_nhop(0x0a030000, 24) == glean);
+
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_ROUTE_ATTR_PACKET_ACTION;
+    attr.value.s32 = SAI_PACKET_ACTION_FORWARD;
+    mock_calls = 0;
+    CHECK(route_api.set_route_attribute(&route, &attr) == SAI_STATUS_SUCCESS);
+    CHECK(mock_calls == 1);
+    CHECK(route_nhop(0x0a030000, 24) == TEST_NHOP1);
+
+    attr.value.s32 = 0;
+    CHECK(route_api.get_route_attribute(&route, 1, &attr) == SAI_STATUS_SUCCESS);
+    CHECK(attr.value.s32 == SAI_PACKET_ACTION_FORWARD);
+
+    route_init(&route, 0x0a040000, 0xffffff00);
+    CHECK(route_api.set_route_attribute(&route, &attr) == SAI_STATUS_ITEM_NOT_FOUND);
+    route_init(&route, 0x0a030000, 0xffffff00);
+    CHECK(route_api.remove_route(&route) == SAI_STATUS_SUCCESS);
+}
+
+static void test_bulk(void) {
+    sai_unicast_route_entry_t routes[TEST_COUNT];
+    sai_attribute_t attrs[TEST_COUNT];
+    const sai_attribute_t *attr_lists[TEST_COUNT];
+    uint32_t attr_counts[TEST_COUNT];
+    sai_status_t statuses[TEST_COUNT];
+    uint32_t index = 0;
+
+    for (index = 0; index < TEST_COUNT; index++) {
+        route_init(&routes[index], 0x0b000000 + (index << 8), 0xffffff00);
+        nhop_attr_init(&attrs[index], TEST_NHOP1);
+        attr_lists[index] = &attrs[index];
+        attr_counts[index] = 1;
+    }
+    // the middle entry repeats the first, the last has a bad mask
+    routes[1] = routes[0];
+    routes[2].destination.mask.ip4 = htonl(0xff00ff00);
+
+    mock_calls = 0;
+    CHECK(sai_bulk_create_route_entry(
+        TEST_COUNT, routes, attr_counts, attr_lists, statuses) == SAI_STATUS_FAILURE);
+    CHECK(statuses[0] == SAI_STATUS_SUCCESS);
+    CHECK(statuses[1] == SAI_STATUS_SUCCESS);
+    CHECK(statuses[2] == SAI_STATUS_INVALID_PARAMETER);
+    CHECK(mock_calls == 1);
+    CHECK(mock_route_count() == 1);
+
+    CHECK(sai_bulk_remove_route_entry(TEST_COUNT, routes, statuses) == SAI_STATUS_FAILURE);
+    CHECK(statuses[0] == SAI_STATUS_SUCCESS);
+    CHECK(statuses[1] == SAI_STATUS_ITEM_NOT_FOUND);
+    CHECK(statuses[2] == SAI_STATUS_INVALID_PARAMETER);
+    CHECK(mock_route_count() == 0);
+}
+
+int main(void) {
+    sai_api_service_t service;
+
+    sai_route_initialize(&service);
+    sai_next_hop_group_initialize(&service);
+    mock_reset();
+
+    test_duplicates();
+    test_get();
+    test_set();
+    test_bulk();
+
+    CHECK_DONE();
+}